@@ -0,0 +1,916 @@
+/******************************************************************************
+ * @file       GroundDecoder.cpp
+ * @brief      地上局テレメトリデコーダ（Linux）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat のシリアル出力（キャプチャファイル、シリアルポート／疑似端末、標準入力）から
+ *             テレメトリ（"TLM"・"TLMC" 行、0xEB90・0xEB91・0xEB92 フレーム）を切り出して復号し、
+ *             CSV または列毎のバイナリファイルに出力する。項目・チャネル毎の統計を標準エラー出力に出力する
+ *             復号は M5AtomSat の TelemetryText / TelemetryFrame / TelemetryDelta をそのまま使う
+ *             （テレメトリチャネル定義表 TelemetryChannels.h の項目がそのまま列になる）
+ *             処理は窓（TLM_GS_WINDOW バイト）毎に次の３段で行う
+ *               1) 切り出し（並列） : 窓を分割し、各スレッドが全バイト位置でテレメトリの開始を検査して候補を作る
+ *                                     （行は "TLM" で始まり解析できること、フレームは CRC が一致すること）
+ *               2) 選択（順次）     : 候補を位置順にたどり、直前に採用したテレメトリと重ならないものを採用する
+ *                                     差分圧縮フレームは採用順に復号する（直前の値が必要なため）
+ *               3) 出力（並列）     : 採用したテレメトリを分割して各スレッドが統計の更新と書式変換を行い、順に結合して書き込む
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TelemetryChannels.h"
+#include "TelemetryText.h"
+#include "TelemetryFrame.h"
+#include "TelemetryDelta.h"
+
+#define TLM_GS_WINDOW           (16 * 1024 * 1024)  // １回に切り出す窓の大きさ[byte]
+#define TLM_GS_STREAM_MIN       (64 * 1024)         // ストリーム入力で並列に切り出す最小サイズ[byte]
+#define TLM_GS_READ_SIZE        (1024 * 1024)       // ストリーム入力の１回の読み込みサイズ[byte]
+#define TLM_GS_LINE_MAX         512                 // テレメトリ行の最大長[byte]（超える行は解析しない）
+#define TLM_GS_POLL_MS          200                 // ストリーム入力の受信待ち時間[ms]
+
+enum TLM_GS_KIND {                          // テレメトリの種類
+    TLM_GS_KIND_TEXT = 0,                   // "TLM" 行
+    TLM_GS_KIND_TEXT_CH,                    // "TLMC" 行
+    TLM_GS_KIND_FRAME,                      // 0xEB90 フレーム
+    TLM_GS_KIND_FRAME_CH,                   // 0xEB91 フレーム
+    TLM_GS_KIND_DELTA,                      // 0xEB92 フレーム
+    TLM_GS_KIND_NUM                         // テレメトリの種類数
+};
+
+static const char * const kindNames[TLM_GS_KIND_NUM] = { "tlm", "tlmc", "eb90", "eb91", "eb92" };
+
+struct Record {                             // 切り出したテレメトリ
+    uint64_t                offset;         // 入力の先頭からの位置[byte]
+    uint32_t                length;         // 長さ[byte]（0 は受信途中）
+    uint8_t                 kind;           // 種類（TLM_GS_KIND）
+    uint8_t                 mask;           // 含まれるチャネル
+    TelemetrySample         sample;         // テレメトリサンプル
+    TelemetryCounters       counters;       // テレメトリカウンタ
+};
+
+enum OUTPUT_FORMAT {                        // 出力形式
+    OUTPUT_CSV = 0,                         // CSV
+    OUTPUT_COLUMNS,                         // 列毎のバイナリファイル
+};
+
+struct Options {                            // コマンドライン引数
+    const char              *input;         // 入力（"-" は標準入力）
+    const char              *output;        // 出力（CSV はファイル（省略時は標準出力）、列毎はディレクトリ）
+    OUTPUT_FORMAT           format;         // 出力形式
+    unsigned                threads;        // スレッド数
+    double                  statsInterval;  // 統計出力間隔[秒]（0 は終了時のみ）
+    speed_t                 baud;           // シリアルポートの通信速度
+};
+
+/******************************************************************************
+ * 統計
+ ******************************************************************************/
+
+struct FieldStats {                         // 項目の統計
+    uint64_t                count;          // 値の数
+    double                  min;            // 最小
+    double                  max;            // 最大
+    double                  mean;           // 平均
+    double                  m2;             // 偏差平方和
+};
+
+struct DecoderStats {                       // デコーダの統計
+    uint64_t                bytes;          // 入力バイト数
+    uint64_t                skipped;        // テレメトリ以外のバイト数（コマンド応答・ログ・破損データ）
+    uint64_t                records[TLM_GS_KIND_NUM];       // 種類毎のテレメトリ数
+    uint64_t                channels[TLM_CHANNEL_NUM];      // チャネル毎のテレメトリ数
+    uint64_t                needKey;        // キーフレーム待ちで捨てた差分圧縮フレーム数
+    uint64_t                gaps;           // テレメトリ番号の不連続数
+    uint64_t                lost;           // 不連続で飛んだテレメトリ番号の数
+    bool                    haveCounter;    // テレメトリ番号受信済み
+    uint32_t                firstCounter;   // 最初のテレメトリ番号（スレッド毎の統計の結合に使う）
+    uint32_t                lastCounter;    // 直前のテレメトリ番号
+    FieldStats              fields[TLM_FIELD_NUM];          // 項目毎の統計
+};
+
+// 項目の値を実数に変換する（倍率を掛けた値）
+static double fieldValue(size_t field, const Record &record)
+{
+    uint32_t value = TelemetryFields[field].get(record.sample, record.counters);
+
+    switch (TelemetryFields[field].type) {
+    case TLM_TYPE_UINT32:
+    case TLM_TYPE_TIME:
+        return (double)value * TelemetryFields[field].scale;
+    default:
+        return (double)(int32_t)value * TelemetryFields[field].scale;
+    }
+}
+
+// テレメトリ番号の連続性の検査
+static void checkCounter(DecoderStats *stats, uint32_t counter)
+{
+    if (!stats->haveCounter) {
+        stats->haveCounter = true;
+        stats->firstCounter = counter;
+    }
+    else if (counter != stats->lastCounter + 1) {
+        stats->gaps++;
+        if ((int32_t)(counter - stats->lastCounter) > 1) {
+            stats->lost += counter - stats->lastCounter - 1;
+        }
+    }
+    stats->lastCounter = counter;
+}
+
+// 統計更新（Welford 法）
+static void updateStats(DecoderStats *stats, const Record &record)
+{
+    stats->records[record.kind]++;
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if (record.mask & TLM_CHANNEL_BIT(ch)) {
+            stats->channels[ch]++;
+        }
+    }
+    checkCounter(stats, record.sample.counter);
+
+    uint32_t mask = TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | record.mask;
+    for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+        if (!TelemetryFieldSelected(field, mask)) {
+            continue;
+        }
+        FieldStats  &fs = stats->fields[field];
+        double      value = fieldValue(field, record);
+        fs.count++;
+        if ((fs.count == 1) || (value < fs.min)) {
+            fs.min = value;
+        }
+        if ((fs.count == 1) || (value > fs.max)) {
+            fs.max = value;
+        }
+        double delta = value - fs.mean;
+        fs.mean += delta / (double)fs.count;
+        fs.m2 += delta * (value - fs.mean);
+    }
+}
+
+// 統計の結合（from は to より後のテレメトリの統計。項目の統計は Chan らの方法で結合する）
+static void mergeStats(DecoderStats *to, const DecoderStats &from)
+{
+    for (int kind = 0; kind < TLM_GS_KIND_NUM; kind++) {
+        to->records[kind] += from.records[kind];
+    }
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        to->channels[ch] += from.channels[ch];
+    }
+    if (from.haveCounter) {
+        uint32_t last = from.lastCounter;
+        checkCounter(to, from.firstCounter);
+        to->lastCounter = last;
+    }
+    to->gaps += from.gaps;
+    to->lost += from.lost;
+    for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+        FieldStats          &a = to->fields[field];
+        const FieldStats    &b = from.fields[field];
+        if (b.count == 0) {
+            continue;
+        }
+        if (a.count == 0) {
+            a = b;
+            continue;
+        }
+        double count = (double)(a.count + b.count);
+        double delta = b.mean - a.mean;
+        a.min = (b.min < a.min) ? b.min : a.min;
+        a.max = (b.max > a.max) ? b.max : a.max;
+        a.mean += delta * (double)b.count / count;
+        a.m2 += b.m2 + delta * delta * (double)a.count * (double)b.count / count;
+        a.count += b.count;
+    }
+}
+
+// 統計出力
+static void printStats(const DecoderStats &stats, double elapsed)
+{
+    uint64_t total = 0;                     // テレメトリ数
+
+    for (int kind = 0; kind < TLM_GS_KIND_NUM; kind++) {
+        total += stats.records[kind];
+    }
+    fprintf(stderr, "GSSTAT, elapsed=%.1fs, bytes=%llu (%.1fMB/s), records=%llu (%.0f/s), skipped=%llu, gaps=%llu, lost=%llu, needkey=%llu\n",
+        elapsed, (unsigned long long)stats.bytes, (elapsed > 0) ? (stats.bytes / elapsed / 1e6) : 0.0,
+        (unsigned long long)total, (elapsed > 0) ? (total / elapsed) : 0.0, (unsigned long long)stats.skipped,
+        (unsigned long long)stats.gaps, (unsigned long long)stats.lost, (unsigned long long)stats.needKey);
+    fprintf(stderr, "GSKIND");
+    for (int kind = 0; kind < TLM_GS_KIND_NUM; kind++) {
+        fprintf(stderr, ", %s=%llu", kindNames[kind], (unsigned long long)stats.records[kind]);
+    }
+    fprintf(stderr, "\n");
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        fprintf(stderr, "GSCH, %s, records=%llu\n", TelemetryChannelNames[ch], (unsigned long long)stats.channels[ch]);
+        for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+            const FieldStats &fs = stats.fields[field];
+            if ((TelemetryFields[field].channel != ch) || (fs.count == 0)) {
+                continue;
+            }
+            fprintf(stderr, "GSFIELD, %s, n=%llu, min=%g, max=%g, mean=%g, sd=%g %s\n",
+                TelemetryFields[field].name, (unsigned long long)fs.count, fs.min, fs.max, fs.mean,
+                sqrt(fs.m2 / (double)fs.count), TelemetryFields[field].unit);
+        }
+    }
+}
+
+/******************************************************************************
+ * 切り出し
+ ******************************************************************************/
+
+// 位置 pos から始まるテレメトリの検査（テレメトリなら record に格納して true）
+static bool scanAt(const uint8_t *data, size_t avail, size_t pos, bool lineStart, bool final, Record *record)
+{
+    const uint8_t   *src = data + pos;      // 検査位置
+    size_t          rest = avail - pos;     // 検査位置以降のバイト数
+    size_t          frameSize;              // フレームサイズ
+
+    record->length = 0;
+    if (src[0] == 0xEB) {
+        if (rest < 2) {
+            // 同期ワードの途中まで
+            return !final;
+        }
+        if ((src[1] == (TLM_FRAME_SYNC & 0xFF)) || (src[1] == (TLM_CH_FRAME_SYNC & 0xFF))) {
+            TLM_FRAME_RESULT result = TelemetryFrameUnpack(src, rest, &frameSize, &record->sample, &record->counters, &record->mask);
+            if (result == TLM_FRAME_SUCCESS) {
+                record->kind = (src[1] == (TLM_FRAME_SYNC & 0xFF)) ? TLM_GS_KIND_FRAME : TLM_GS_KIND_FRAME_CH;
+                record->length = (uint32_t)frameSize;
+                return true;
+            }
+            return (result == TLM_FRAME_INCOMPLETE) && !final;
+        }
+        if (src[1] == (TLM_DELTA_SYNC & 0xFF)) {
+            // 値は選択時に復号する
+            TelemetryDeltaDecoder::RESULT result = TelemetryDeltaDecoder::Measure(src, rest, &frameSize);
+            if (result == TelemetryDeltaDecoder::RESULT_SUCCESS) {
+                record->kind = TLM_GS_KIND_DELTA;
+                record->length = (uint32_t)frameSize;
+                return true;
+            }
+            return (result == TelemetryDeltaDecoder::RESULT_INCOMPLETE) && !final;
+        }
+        return false;
+    }
+    if ((src[0] == 'T') && lineStart) {
+        size_t          limit = (rest < TLM_GS_LINE_MAX) ? rest : TLM_GS_LINE_MAX;
+        const uint8_t   *eol = (const uint8_t *)memchr(src, '\n', limit);
+        if (eol == NULL) {
+            if (rest >= TLM_GS_LINE_MAX) {
+                // 長すぎる行
+                return false;
+            }
+            if (!final) {
+                // 行の途中まで
+                return true;
+            }
+            eol = src + rest;
+        }
+        if (TelemetryParseText((const char *)src, (size_t)(eol - src), &record->sample, &record->counters, &record->mask)) {
+            record->kind = (src[3] == 'C') ? TLM_GS_KIND_TEXT_CH : TLM_GS_KIND_TEXT;
+            record->length = (uint32_t)((eol < src + rest) ? (eol - src + 1) : (eol - src));
+            return true;
+        }
+    }
+    return false;
+}
+
+// 範囲 [begin, end) を開始位置とするテレメトリの候補を切り出す
+static void scanRange(const uint8_t *data, size_t avail, size_t begin, size_t end, bool firstLineStart, bool final,
+                      uint64_t base, std::vector<Record> *records)
+{
+    Record  record;                         // 候補
+
+    records->clear();
+    for (size_t pos = begin; pos < end; pos++) {
+        uint8_t byte = data[pos];
+        if ((byte != 0xEB) && (byte != 'T')) {
+            continue;
+        }
+        bool lineStart = (pos == 0) ? firstLineStart : (data[pos - 1] == '\n');
+        if (scanAt(data, avail, pos, lineStart, final, &record)) {
+            record.offset = base + pos;
+            records->push_back(record);
+        }
+    }
+}
+
+/******************************************************************************
+ * 出力
+ ******************************************************************************/
+
+// 符号なし整数の書式変換
+static char *putUInt(char *dst, uint64_t value)
+{
+    char    digits[20];                     // 下位からの数字
+    int     count = 0;                      // 桁数
+
+    do {
+        digits[count++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        *dst++ = digits[--count];
+    }
+    return dst;
+}
+
+// 符号付き整数の書式変換
+static char *putInt(char *dst, int32_t value)
+{
+    if (value < 0) {
+        *dst++ = '-';
+        return putUInt(dst, 0U - (uint32_t)value);
+    }
+    return putUInt(dst, (uint32_t)value);
+}
+
+// 1/100 単位の固定小数点の書式変換（"%.2f"）
+static char *putCenti(char *dst, int32_t centi)
+{
+    uint32_t magnitude = (uint32_t)centi;
+
+    if (centi < 0) {
+        *dst++ = '-';
+        magnitude = 0U - magnitude;
+    }
+    dst = putUInt(dst, magnitude / 100);
+    *dst++ = '.';
+    *dst++ = (char)('0' + ((magnitude / 10) % 10));
+    *dst++ = (char)('0' + (magnitude % 10));
+    return dst;
+}
+
+// CSV 見出し行
+static std::string csvHeader()
+{
+    std::string header = "offset,format,mask";
+
+    for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+        header += ',';
+        header += TelemetryFields[field].name;
+    }
+    header += '\n';
+    return header;
+}
+
+// CSV 書式変換（含まれないチャネルの項目は空欄）
+static void formatCsv(const Record *records, size_t count, std::string *out)
+{
+    char    line[32 + (TLM_FIELD_NUM * 16)];    // １行
+
+    out->clear();
+    out->reserve(count * 96);
+    for (size_t index = 0; index < count; index++) {
+        const Record    &record = records[index];
+        uint32_t        mask = TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | record.mask;
+        char            *pos = line;
+
+        pos = putUInt(pos, record.offset);
+        *pos++ = ',';
+        for (const char *name = kindNames[record.kind]; *name != '\0'; name++) {
+            *pos++ = *name;
+        }
+        *pos++ = ',';
+        pos = putUInt(pos, record.mask);
+        for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+            *pos++ = ',';
+            if (!TelemetryFieldSelected(field, mask)) {
+                continue;
+            }
+            uint32_t value = TelemetryFields[field].get(record.sample, record.counters);
+            switch (TelemetryFields[field].type) {
+            case TLM_TYPE_INT32:
+                pos = putInt(pos, (int32_t)value);
+                break;
+            case TLM_TYPE_UINT32:
+            case TLM_TYPE_TIME:
+                pos = putUInt(pos, value);
+                break;
+            default:
+                pos = putCenti(pos, (int32_t)value);
+                break;
+            }
+        }
+        *pos++ = '\n';
+        out->append(line, (size_t)(pos - line));
+    }
+}
+
+// 列毎のバイナリファイル出力
+class ColumnWriter
+{
+public:
+    ColumnWriter() : _mask(NULL), _kind(NULL), _offset(NULL) {}
+    ~ColumnWriter() { Close(); }
+
+    // 出力先ディレクトリに列毎のファイルと列の一覧（schema.csv）を作る
+    bool Open(const char *dir)
+    {
+        std::string path = dir;
+        mkdir(dir, 0755);
+        FILE *schema = fopen((path + "/schema.csv").c_str(), "w");
+        if (schema == NULL) {
+            return false;
+        }
+        fprintf(schema, "column,file,type,bytes,scale,unit,channel\n");
+        fprintf(schema, "offset,offset.u64,u64,8,1,byte,\n");
+        fprintf(schema, "format,format.u8,u8,1,1,,\n");
+        fprintf(schema, "mask,mask.u8,u8,1,1,,\n");
+        for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+            const TelemetryFieldDef &def = TelemetryFields[field];
+            fprintf(schema, "%s,%s.%s,%s,%u,%g,%s,%s\n", def.name, def.name, TelemetryTypeNames[def.type],
+                TelemetryTypeNames[def.type], TelemetryTypeBytes(def.type), def.scale, def.unit,
+                (def.channel == TLM_CHANNEL_HEADER) ? "header" : TelemetryChannelNames[def.channel]);
+            _files[field] = fopen((path + "/" + def.name + "." + TelemetryTypeNames[def.type]).c_str(), "wb");
+        }
+        fclose(schema);
+        _offset = fopen((path + "/offset.u64").c_str(), "wb");
+        _kind = fopen((path + "/format.u8").c_str(), "wb");
+        _mask = fopen((path + "/mask.u8").c_str(), "wb");
+        for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+            if (_files[field] == NULL) {
+                return false;
+            }
+        }
+        return (_offset != NULL) && (_kind != NULL) && (_mask != NULL);
+    }
+
+    // 書き込み（リトルエンディアン、含まれないチャネルの項目は 0。mask 列で判別する）
+    void Write(const Record *records, size_t count)
+    {
+        std::vector<uint8_t>    column;     // 列のデータ
+
+        column.resize(count * 8);
+        for (size_t index = 0; index < count; index++) {
+            putLE(&column[index * 8], records[index].offset, 8);
+        }
+        fwrite(column.data(), 8, count, _offset);
+        for (size_t index = 0; index < count; index++) {
+            column[index] = records[index].kind;
+        }
+        fwrite(column.data(), 1, count, _kind);
+        for (size_t index = 0; index < count; index++) {
+            column[index] = records[index].mask;
+        }
+        fwrite(column.data(), 1, count, _mask);
+        for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+            uint32_t bytes = TelemetryTypeBytes(TelemetryFields[field].type);
+            for (size_t index = 0; index < count; index++) {
+                const Record &record = records[index];
+                uint32_t value = TelemetryFieldSelected(field, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | record.mask) ?
+                                 TelemetryFields[field].get(record.sample, record.counters) : 0;
+                putLE(&column[index * bytes], value, bytes);
+            }
+            fwrite(column.data(), bytes, count, _files[field]);
+        }
+    }
+
+    void Close()
+    {
+        FILE **files[] = { &_offset, &_kind, &_mask };
+        for (FILE **file : files) {
+            if (*file != NULL) {
+                fclose(*file);
+                *file = NULL;
+            }
+        }
+        for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+            if (_files[field] != NULL) {
+                fclose(_files[field]);
+                _files[field] = NULL;
+            }
+        }
+    }
+
+private:
+    FILE                    *_files[TLM_FIELD_NUM] = {};    // 項目毎のファイル
+    FILE                    *_mask;         // チャネルマスク
+    FILE                    *_kind;         // 種類
+    FILE                    *_offset;       // 入力位置
+
+    static void putLE(uint8_t *dst, uint64_t value, uint32_t bytes)
+    {
+        for (uint32_t index = 0; index < bytes; index++) {
+            dst[index] = (uint8_t)(value >> (8 * index));
+        }
+    }
+};
+
+/******************************************************************************
+ * デコーダ
+ ******************************************************************************/
+
+class GroundDecoder
+{
+public:
+    GroundDecoder(const Options &options) : _options(options), _csv(NULL), _lineStart(true), _base(0)
+    {
+        memset(&_stats, 0, sizeof (_stats));
+        _scanned.resize(_options.threads);
+        _texts.resize(_options.threads);
+        _partials.resize(_options.threads);
+        clock_gettime(CLOCK_MONOTONIC, &_start);
+        _lastStats = _start;
+    }
+
+    // 出力先を開く
+    bool Open()
+    {
+        if (_options.format == OUTPUT_COLUMNS) {
+            if ((_options.output == NULL) || !_columns.Open(_options.output)) {
+                fprintf(stderr, "cannot create columns in %s\n", (_options.output != NULL) ? _options.output : "(none)");
+                return false;
+            }
+            return true;
+        }
+        _csv = (_options.output != NULL) ? fopen(_options.output, "w") : stdout;
+        if (_csv == NULL) {
+            fprintf(stderr, "cannot open %s : %s\n", _options.output, strerror(errno));
+            return false;
+        }
+        std::string header = csvHeader();
+        fwrite(header.data(), 1, header.size(), _csv);
+        return true;
+    }
+
+    // 出力先を閉じて統計を出力する
+    void Close()
+    {
+        if ((_csv != NULL) && (_csv != stdout)) {
+            fclose(_csv);
+        }
+        else if (_csv != NULL) {
+            fflush(_csv);
+        }
+        _csv = NULL;
+        _columns.Close();
+        printStats(_stats, elapsed());
+    }
+
+    // 受信データの処理（data[0, avail) のうち先頭から scanLimit バイトまでを開始位置とするテレメトリを処理し、
+    //                   処理済みのバイト数を返す。final が false なら末尾の受信途中のテレメトリは処理しない）
+    size_t Process(const uint8_t *data, size_t avail, size_t scanLimit, bool final)
+    {
+        unsigned threads = (scanLimit >= TLM_GS_STREAM_MIN) ? _options.threads : 1;
+
+        // 1) 切り出し
+        if (threads == 1) {
+            scanRange(data, avail, 0, scanLimit, _lineStart, final, _base, &_scanned[0]);
+        }
+        else {
+            std::vector<std::thread> workers;
+            size_t step = (scanLimit + threads - 1) / threads;
+            for (unsigned index = 0; index < threads; index++) {
+                size_t begin = (index * step < scanLimit) ? (index * step) : scanLimit;
+                size_t end = (begin + step < scanLimit) ? (begin + step) : scanLimit;
+                workers.emplace_back(scanRange, data, avail, begin, end, _lineStart, final, _base, &_scanned[index]);
+            }
+            for (std::thread &worker : workers) {
+                worker.join();
+            }
+        }
+
+        // 2) 選択
+        size_t      next = 0;               // 次のテレメトリの開始位置（直前に採用したテレメトリの末尾）
+        size_t      consumed = scanLimit;   // 処理済みのバイト数
+        bool        stopped = false;        // 受信途中のテレメトリで中断
+        _selected.clear();
+        for (unsigned index = 0; (index < threads) && !stopped; index++) {
+            for (Record &record : _scanned[index]) {
+                size_t pos = (size_t)(record.offset - _base);
+                if (pos < next) {
+                    // 直前に採用したテレメトリと重なる
+                    continue;
+                }
+                if (record.length == 0) {
+                    // 受信途中 続きを受信してから処理する
+                    consumed = pos;
+                    stopped = true;
+                    break;
+                }
+                if (record.kind == TLM_GS_KIND_DELTA) {
+                    size_t frameSize;
+                    TelemetryDeltaDecoder::RESULT result = _delta.Decode(data + pos, avail - pos, &frameSize,
+                                                                         &record.sample, &record.counters, &record.mask);
+                    if (result != TelemetryDeltaDecoder::RESULT_SUCCESS) {
+                        // キーフレーム待ち
+                        _stats.needKey++;
+                        continue;
+                    }
+                }
+                _stats.skipped += pos - next;
+                next = pos + record.length;
+                _selected.push_back(record);
+            }
+        }
+        if (!stopped && (next > consumed)) {
+            // 最後のテレメトリが窓の外まで続く
+            consumed = next;
+        }
+        if (consumed > next) {
+            _stats.skipped += consumed - next;
+        }
+        _stats.bytes += consumed;
+
+        // 3) 出力
+        write();
+
+        _lineStart = (consumed == 0) ? _lineStart : (data[consumed - 1] == '\n');
+        _base += consumed;
+        return consumed;
+    }
+
+    // 統計出力間隔が経過していれば統計を出力する
+    void PollStats()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((_options.statsInterval > 0) && (diff(_lastStats, now) >= _options.statsInterval)) {
+            _lastStats = now;
+            printStats(_stats, elapsed());
+        }
+    }
+
+private:
+    Options                     _options;           // コマンドライン引数
+    FILE                        *_csv;              // CSV 出力先
+    ColumnWriter                _columns;           // 列毎のバイナリファイル出力
+    bool                        _lineStart;         // 処理済みのデータが行末で終わっている
+    uint64_t                    _base;              // 処理済みのバイト数（入力の先頭から）
+    TelemetryDeltaDecoder       _delta;             // 差分圧縮フレーム復号
+    DecoderStats                _stats;             // 統計
+    std::vector<std::vector<Record> >   _scanned;   // スレッド毎の候補
+    std::vector<Record>         _selected;          // 採用したテレメトリ
+    std::vector<std::string>    _texts;             // スレッド毎の CSV
+    std::vector<DecoderStats>   _partials;          // スレッド毎の統計
+    struct timespec             _start;             // 開始時刻
+    struct timespec             _lastStats;         // 最後に統計を出力した時刻
+
+    static double diff(const struct timespec &from, const struct timespec &to)
+    {
+        return (double)(to.tv_sec - from.tv_sec) + ((double)(to.tv_nsec - from.tv_nsec) / 1e9);
+    }
+
+    double elapsed() const
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return diff(_start, now);
+    }
+
+    // 採用したテレメトリの統計更新と書式変換（スレッド毎に分担する。列毎の出力は書式変換しない）
+    static void outputSlice(const Record *records, size_t count, bool csv, DecoderStats *stats, std::string *text)
+    {
+        memset(stats, 0, sizeof (*stats));
+        for (size_t index = 0; index < count; index++) {
+            updateStats(stats, records[index]);
+        }
+        if (csv) {
+            formatCsv(records, count, text);
+        }
+    }
+
+    // 採用したテレメトリの出力
+    void write()
+    {
+        size_t  count = _selected.size();
+        bool    csv = (_options.format == OUTPUT_CSV);
+
+        if (count == 0) {
+            return;
+        }
+        unsigned threads = (count >= 4096) ? _options.threads : 1;
+        size_t step = (count + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (unsigned index = 0; index < threads; index++) {
+            size_t begin = (index * step < count) ? (index * step) : count;
+            size_t num = (begin + step < count) ? step : (count - begin);
+            workers.emplace_back(outputSlice, _selected.data() + begin, num, csv, &_partials[index], &_texts[index]);
+        }
+        for (unsigned index = 0; index < threads; index++) {
+            workers[index].join();
+            mergeStats(&_stats, _partials[index]);
+            if (csv) {
+                fwrite(_texts[index].data(), 1, _texts[index].size(), _csv);
+            }
+        }
+        if (!csv) {
+            _columns.Write(_selected.data(), count);
+        }
+    }
+};
+
+/******************************************************************************
+ * 入力
+ ******************************************************************************/
+
+// ファイル入力（全体をメモリに割り当て、窓毎に処理する）
+static bool decodeFile(GroundDecoder &decoder, int fd, size_t size)
+{
+    if (size == 0) {
+        return true;
+    }
+    const uint8_t *data = (const uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+    size_t pos = 0;                         // 処理済みのバイト数
+    while (pos < size) {
+        size_t rest = size - pos;
+        size_t window = (rest < TLM_GS_WINDOW) ? rest : TLM_GS_WINDOW;
+        size_t consumed = decoder.Process(data + pos, rest, window, window == rest);
+        pos += (consumed > 0) ? consumed : window;
+        decoder.PollStats();
+    }
+    munmap((void *)data, size);
+    return true;
+}
+
+// ストリーム入力（シリアルポート・疑似端末・パイプ。受信した分ずつ処理し、受信途中のテレメトリは次に持ち越す）
+static bool decodeStream(GroundDecoder &decoder, int fd)
+{
+    std::vector<uint8_t>    buffer;         // 受信データ
+    size_t                  used = 0;       // 受信データのバイト数
+
+    buffer.resize(TLM_GS_READ_SIZE * 2);
+    while (1) {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, TLM_GS_POLL_MS);
+        decoder.PollStats();
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        if (buffer.size() - used < TLM_GS_READ_SIZE) {
+            buffer.resize(used + TLM_GS_READ_SIZE);
+        }
+        ssize_t length = read(fd, &buffer[used], TLM_GS_READ_SIZE);
+        if (length < 0) {
+            if ((errno == EINTR) || (errno == EAGAIN)) {
+                continue;
+            }
+            if (errno == EIO) {
+                // 疑似端末の相手側が閉じた
+                break;
+            }
+            return false;
+        }
+        if (length == 0) {
+            break;
+        }
+        used += (size_t)length;
+        size_t consumed = decoder.Process(buffer.data(), used, used, false);
+        memmove(buffer.data(), buffer.data() + consumed, used - consumed);
+        used -= consumed;
+    }
+    decoder.Process(buffer.data(), used, used, true);
+    return true;
+}
+
+// シリアルポート・疑似端末の設定（RAW モード、指定の通信速度）
+static void setupTerminal(int fd, speed_t baud)
+{
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) != 0) {
+        return;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, baud);
+    cfsetospeed(&tio, baud);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+// 通信速度の変換
+static bool toBaud(long value, speed_t *baud)
+{
+    static const struct { long value; speed_t baud; } table[] = {
+        { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+        { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 }, { 921600, B921600 },
+    };
+    for (const auto &entry : table) {
+        if (entry.value == value) {
+            *baud = entry.baud;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [-f csv|columns] [-o output] [-j threads] [-s seconds] [-b baud] [input]\n"
+        "  input       capture file, serial port or pseudo terminal (default: stdin)\n"
+        "  -f csv      one CSV row per telemetry (default; output file or stdout)\n"
+        "  -f columns  one little-endian binary file per field and schema.csv (output directory)\n"
+        "  -j threads  worker threads (default: number of CPUs)\n"
+        "  -s seconds  live statistics interval on stderr (default: 1, 0 = only at the end)\n"
+        "  -b baud     serial port speed (default: 115200)\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    Options options = { "-", NULL, OUTPUT_CSV, std::thread::hardware_concurrency(), 1.0, B115200 };
+    int     opt;
+
+    while ((opt = getopt(argc, argv, "f:o:j:s:b:h")) != -1) {
+        switch (opt) {
+        case 'f':
+            if (strcmp(optarg, "csv") == 0) {
+                options.format = OUTPUT_CSV;
+            }
+            else if (strcmp(optarg, "columns") == 0) {
+                options.format = OUTPUT_COLUMNS;
+            }
+            else {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'o':
+            options.output = optarg;
+            break;
+        case 'j':
+            options.threads = (unsigned)atoi(optarg);
+            break;
+        case 's':
+            options.statsInterval = atof(optarg);
+            break;
+        case 'b':
+            if (!toBaud(atol(optarg), &options.baud)) {
+                fprintf(stderr, "unsupported baud rate %s\n", optarg);
+                return 2;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (optind < argc) {
+        options.input = argv[optind];
+    }
+    if (options.threads == 0) {
+        options.threads = 1;
+    }
+
+    int fd = (strcmp(options.input, "-") == 0) ? STDIN_FILENO : open(options.input, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "cannot open %s : %s\n", options.input, strerror(errno));
+        return 1;
+    }
+    GroundDecoder decoder(options);
+    if (!decoder.Open()) {
+        return 1;
+    }
+
+    struct stat st;
+    bool ok;
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode)) {
+        // キャプチャファイル
+        ok = decodeFile(decoder, fd, (size_t)st.st_size);
+    }
+    else {
+        // シリアルポート・疑似端末・パイプ
+        if (isatty(fd)) {
+            setupTerminal(fd, options.baud);
+        }
+        ok = decodeStream(decoder, fd);
+    }
+    if (!ok) {
+        fprintf(stderr, "read error : %s\n", strerror(errno));
+    }
+    decoder.Close();
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+/******************************************************************************
+ * @file       AttitudeFilterBench.cpp
+ * @brief      姿勢推定フィルタ ベンチマーク（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の AttitudeFilter を模擬軌道で評価する
+ *             真の姿勢を倍精度で細かく積分し、ジャイロ（バイアス・雑音）と加速度（振動・雑音）を生成してフィルタに入力し、
+ *             傾きの誤差（重力方向の角度差）と姿勢全体の誤差（Yaw を含む回転角の差）の RMS・最大を求め、
+ *             傾きの誤差を従来の加速度だけの姿勢と比較する（オイラー角は Pitch ±90 度付近で Roll, Yaw が不定になるため使わない）
+ *             また１秒あたりの更新回数を測る
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <random>
+#include <vector>
+#include "AttitudeFilter.h"
+
+#define BENCH_SUBSTEPS          20          // 真の姿勢の積分の分割数（サンプル周期あたり）
+#define BENCH_STILL_TIME        2.0         // 開始時の静止時間[秒]（ジャイロバイアス推定）
+#define BENCH_SETTLE_TIME       3.0         // 誤差を集計しない開始からの時間[秒]
+#define BENCH_UPDATES           20000000    // 処理速度測定の更新回数
+
+static const double RAD = M_PI / 180.0;     // 度 → ラジアン
+
+struct Scenario {                           // 模擬軌道
+    const char              *name;          // 名前
+    double                  duration;       // 時間[秒]（開始時の静止時間を含む）
+    double                  rate;           // サンプリング周波数[Hz]
+    double                  amplitude[3];   // 角速度の振幅[度/秒]（X, Y, Z）
+    double                  frequency[3];   // 角速度の周波数[Hz]
+    double                  yawRate;        // Z 軸の一定角速度[度/秒]
+    double                  vibration;      // 振動加速度の振幅[G]
+    double                  vibrationHz;    // 振動の周波数[Hz]
+};
+
+struct Sensor {                             // 模擬センサ出力
+    float                   g[3];           // 角速度[度/秒]
+    float                   a[3];           // 加速度[G]
+    double                  q[4];           // 真の姿勢
+    double                  gravity[3];     // 真の重力方向（機体座標）
+};
+
+struct Error {                              // 誤差
+    double                  sum2;           // ２乗和
+    double                  max;            // 最大
+    long                    count;          // 数
+
+    void Add(double error)
+    {
+        error = fabs(error);
+        sum2 += error * error;
+        max = (error > max) ? error : max;
+        count++;
+    }
+    double Rms() const { return (count > 0) ? sqrt(sum2 / count) : 0.0; }
+};
+
+// ２つのベクトルのなす角[度]
+static double vectorAngle(const double *a, const double *b)
+{
+    double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    double na = sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    double nb = sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+    return acos(fmax(-1.0, fmin(1.0, dot / (na * nb)))) / RAD;
+}
+
+// クォータニオンの重力方向（機体座標）
+static void gravityOf(const double *q, double *gravity)
+{
+    gravity[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    gravity[1] = 2 * (q[0] * q[1] + q[2] * q[3]);
+    gravity[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+// 模擬軌道の生成
+static std::vector<Sensor> generate(const Scenario &sc, unsigned seed)
+{
+    std::mt19937                    rng(seed);
+    std::normal_distribution<double> gyroNoise(0.0, 0.1);   // ジャイロ雑音[度/秒]
+    std::normal_distribution<double> accelNoise(0.0, 0.01); // 加速度雑音[G]
+    const double    bias[3] = { 1.5, -0.8, 0.6 };           // ジャイロバイアス[度/秒]
+    double          q[4] = { 1.0, 0.0, 0.0, 0.0 };          // 真の姿勢（機体座標 → 基準座標）
+    long            samples = (long)(sc.duration * sc.rate);
+    double          dt = 1.0 / sc.rate;
+    std::vector<Sensor> out(samples);
+
+    // 初期姿勢 ピッチ 10 度、ロール -20 度
+    double cr = cos(-20.0 * RAD / 2), sr = sin(-20.0 * RAD / 2), cp = cos(10.0 * RAD / 2), sp = sin(10.0 * RAD / 2);
+    q[0] = cr * cp; q[1] = sr * cp; q[2] = cr * sp; q[3] = -sr * sp;
+
+    for (long n = 0; n < samples; n++) {
+        double  t = n * dt;
+        double  w[3] = { 0.0, 0.0, 0.0 };   // サンプル時刻の角速度[rad/s]
+        for (int step = 0; step < BENCH_SUBSTEPS; step++) {
+            double ts = t + step * dt / BENCH_SUBSTEPS;
+            double ws[3] = { 0.0, 0.0, 0.0 };
+            if (ts >= BENCH_STILL_TIME) {
+                for (int axis = 0; axis < 3; axis++) {
+                    ws[axis] = sc.amplitude[axis] * sin(2 * M_PI * sc.frequency[axis] * (ts - BENCH_STILL_TIME)) * RAD;
+                }
+                ws[2] += sc.yawRate * RAD;
+            }
+            if (step == 0) {
+                w[0] = ws[0]; w[1] = ws[1]; w[2] = ws[2];
+            }
+            if (n == 0) {
+                break;
+            }
+            double h = 0.5 * dt / BENCH_SUBSTEPS;
+            double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+            q[0] += h * (-q1 * ws[0] - q2 * ws[1] - q3 * ws[2]);
+            q[1] += h * (q0 * ws[0] + q2 * ws[2] - q3 * ws[1]);
+            q[2] += h * (q0 * ws[1] - q1 * ws[2] + q3 * ws[0]);
+            q[3] += h * (q0 * ws[2] + q1 * ws[1] - q2 * ws[0]);
+            double norm = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            for (int index = 0; index < 4; index++) {
+                q[index] /= norm;
+            }
+        }
+        Sensor &s = out[n];
+        // 重力方向（機体座標）と振動
+        double gv[3];
+        gravityOf(q, gv);
+        double vib = sc.vibration * sin(2 * M_PI * sc.vibrationHz * t);
+        double vibAxis[3] = { 0.6, 0.48, 0.64 };
+        for (int axis = 0; axis < 3; axis++) {
+            s.g[axis] = (float)(w[axis] / RAD + bias[axis] + gyroNoise(rng));
+            s.a[axis] = (float)(gv[axis] + vib * vibAxis[axis] + accelNoise(rng));
+            s.gravity[axis] = gv[axis];
+        }
+        for (int index = 0; index < 4; index++) {
+            s.q[index] = q[index];
+        }
+    }
+    return out;
+}
+
+// 精度評価
+static void evaluate(const Scenario &sc)
+{
+    std::vector<Sensor> data = generate(sc, 1);
+    AttitudeFilter      filter;
+    Error               tilt = {};          // フィルタの傾きの誤差
+    Error               rotation = {};      // フィルタの姿勢全体の誤差
+    Error               accel = {};         // 加速度だけの姿勢の傾きの誤差
+    float               dt = (float)(1.0 / sc.rate);
+
+    for (size_t n = 0; n < data.size(); n++) {
+        const Sensor &s = data[n];
+        filter.Update(s.g[0], s.g[1], s.g[2], s.a[0], s.a[1], s.a[2], dt);
+        if (n < (size_t)(BENCH_SETTLE_TIME * sc.rate)) {
+            continue;
+        }
+        AttitudeQuaternion  e = filter.GetQuaternion();
+        double              q[4] = { e.w, e.x, e.y, e.z };
+        double              gravity[3];
+        double              a[3] = { s.a[0], s.a[1], s.a[2] };
+        gravityOf(q, gravity);
+        tilt.Add(vectorAngle(gravity, s.gravity));
+        double dot = fabs(q[0] * s.q[0] + q[1] * s.q[1] + q[2] * s.q[2] + q[3] * s.q[3]);
+        rotation.Add(2 * acos(fmin(1.0, dot)) / RAD);
+        // 従来の加速度だけの姿勢（加速度の向きを重力方向とする）
+        accel.Add(vectorAngle(a, s.gravity));
+    }
+    printf("%-16s %5.0fHz  fused tilt %5.2f/%5.2f  attitude %5.2f/%5.2f   accel-only tilt %5.2f/%5.2f  [deg rms/max]\n",
+        sc.name, sc.rate, tilt.Rms(), tilt.max, rotation.Rms(), rotation.max, accel.Rms(), accel.max);
+}
+
+// 処理速度測定
+static void benchmark()
+{
+    std::vector<Sensor> data = generate({ "speed", 10.0, 1000.0, { 90, 60, 45 }, { 0.5, 0.3, 0.2 }, 10, 0.2, 40 }, 2);
+    AttitudeFilter      filter;
+    struct timespec     start, end;
+    float               sink = 0.0f;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long n = 0; n < BENCH_UPDATES; n++) {
+        const Sensor &s = data[n % data.size()];
+        filter.Update(s.g[0], s.g[1], s.g[2], s.a[0], s.a[1], s.a[2], 0.001f);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    float pitch, roll, yaw;
+    filter.GetEuler(&pitch, &roll, &yaw);
+    sink = pitch + roll + yaw;
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("update: %.1f M updates/s (%.1f ns/update)%s\n", BENCH_UPDATES / seconds / 1e6, seconds / BENCH_UPDATES * 1e9,
+        isnan(sink) ? " NaN" : "");
+}
+
+int main()
+{
+    static const Scenario scenarios[] = {
+        // 名前               時間   周波数   角速度振幅[度/秒]  周波数[Hz]          Yaw[度/秒] 振動[G] 振動[Hz]
+        { "still+vibration",  60.0,  200.0, {  0,  0,  0 },  { 0.0, 0.0, 0.0 },    0.0,  0.3,  37.0 },
+        { "slow tilt",        60.0,  200.0, { 20, 30, 10 },  { 0.10, 0.07, 0.05 }, 5.0,  0.0,   0.0 },
+        { "slow tilt+vib",    60.0,  200.0, { 20, 30, 10 },  { 0.10, 0.07, 0.05 }, 5.0,  0.3,  37.0 },
+        { "fast maneuver",    60.0,  200.0, { 150, 120, 90 }, { 0.5, 0.4, 0.3 },   20.0, 0.1,  23.0 },
+        { "fast maneuver",    60.0, 1000.0, { 150, 120, 90 }, { 0.5, 0.4, 0.3 },   20.0, 0.1,  23.0 },
+    };
+
+    for (const Scenario &sc : scenarios) {
+        evaluate(sc);
+    }
+    benchmark();
+    return 0;
+}
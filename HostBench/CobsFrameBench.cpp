@@ -0,0 +1,289 @@
+/******************************************************************************
+ * @file       CobsFrameBench.cpp
+ * @brief      COBS＋CRC-16 フレーム解析 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の CobsFrameParser・Crc16 を評価する
+ *               ・往復試験 : 長さ・0x00 の割合を変えたペイロードをエンコードし、デコードして元に戻ること
+ *               ・ファズ試験 : ランダムなバイト列、ビット反転・切り詰めたフレーム、小さい格納先を入力し、
+ *                              格納先の外に書き込まないこと、壊れたフレームを受け付けないこと、次のフレームで同期が戻ること
+ *               ・処理速度 : Feed・Encode・Crc16Calc の１秒あたりの処理バイト数
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "CobsFrame.h"
+#include "Crc16.h"
+
+#define BENCH_PAYLOAD_MAX       600         // 往復試験の最大ペイロード長[byte]
+#define BENCH_ROUND_TRIPS       200000      // 往復試験のフレーム数
+#define BENCH_FUZZ_BYTES        50000000    // ランダムなバイト列の長さ[byte]
+#define BENCH_FLIP_FRAMES       20000       // ビット反転試験のフレーム数
+#define BENCH_SPEED_BYTES       100000000   // 処理速度測定のバイト数
+#define BENCH_GUARD             16          // 格納先の後ろの検査領域[byte]
+#define BENCH_GUARD_VALUE       0xA5        // 検査領域の値
+
+struct Stats {                              // 試験結果
+    uint64_t                count;          // 試験数
+    uint64_t                failures;       // 失敗数
+};
+
+// 試験結果表示
+static bool summary(const char *name, const Stats &stats, const char *note = "")
+{
+    printf("%-30s %10llu  failures %llu%s\n", name, (unsigned long long)stats.count, (unsigned long long)stats.failures, note);
+    return stats.failures == 0;
+}
+
+// ペイロード生成（zeroPercent の割合で 0x00、残りは 0xFF の割合 ffPercent、その他はランダム）
+static void makePayload(std::mt19937 &random, uint8_t *payload, size_t length, int zeroPercent, int ffPercent)
+{
+    for (size_t i = 0; i < length; i++) {
+        int r = (int)(random() % 100);
+        payload[i] = (r < zeroPercent) ? 0x00 : (r < zeroPercent + ffPercent) ? 0xFF : (uint8_t)(1 + random() % 254);
+    }
+}
+
+// 格納先と後ろの検査領域
+struct Buffer {
+    std::vector<uint8_t>    data;           // 格納先＋検査領域
+    size_t                  size;           // 格納先サイズ
+
+    Buffer(size_t bufferSize) : data(bufferSize + BENCH_GUARD, BENCH_GUARD_VALUE), size(bufferSize) {}
+    bool Intact() const
+    {
+        for (size_t i = size; i < data.size(); i++) {
+            if (data[i] != BENCH_GUARD_VALUE) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// フレームの入力（FRAME_OK の数と最後の FRAME_OK の長さを返す）
+static int feed(CobsFrameParser *parser, const uint8_t *data, size_t size, size_t *length, int *errors)
+{
+    int ok = 0;
+    for (size_t i = 0; i < size; i++) {
+        CobsFrameParser::RESULT result = parser->Feed(data[i]);
+        if (result == CobsFrameParser::RESULT_FRAME_OK) {
+            ok++;
+            *length = parser->GetLength();
+        }
+        else if ((result == CobsFrameParser::RESULT_ERR_CRC) || (result == CobsFrameParser::RESULT_ERR_FORMAT) ||
+                 (result == CobsFrameParser::RESULT_ERR_OVERFLOW)) {
+            (*errors)++;
+        }
+    }
+    return ok;
+}
+
+int main()
+{
+    std::mt19937        random(20261016);
+    bool                pass = true;
+    uint8_t             payload[BENCH_PAYLOAD_MAX];
+    std::vector<uint8_t> encoded(COBS_ENCODED_MAX(BENCH_PAYLOAD_MAX + COBS_FRAME_CRC_SIZE) + 2);
+    Buffer              buffer(BENCH_PAYLOAD_MAX + COBS_FRAME_CRC_SIZE);
+    CobsFrameParser     parser;
+
+    // CRC-16/CCITT-FALSE の検査値（"123456789" → 0x29B1）
+    {
+        Stats stats = { 1, (Crc16Calc((const uint8_t *)"123456789", 9) == 0x29B1) ? 0ULL : 1ULL };
+        pass &= summary("crc16 check value", stats);
+    }
+
+    // 往復試験（長さ 0〜BENCH_PAYLOAD_MAX、0x00・0xFF の割合を変える。254バイトのブロック境界を含む）
+    {
+        static const int    mixes[][2] = { { 0, 0 }, { 1, 0 }, { 10, 10 }, { 50, 0 }, { 100, 0 }, { 0, 100 }, { 0, 50 } };
+        Stats               stats = {};
+        parser.Reset(buffer.data.data(), buffer.size);
+        for (int n = 0; n < BENCH_ROUND_TRIPS; n++) {
+            size_t length = (n < 2 * BENCH_PAYLOAD_MAX) ? (size_t)(n % (BENCH_PAYLOAD_MAX + 1)) : (size_t)(random() % (BENCH_PAYLOAD_MAX + 1));
+            const int *mix = mixes[n % (sizeof (mixes) / sizeof (mixes[0]))];
+            makePayload(random, payload, length, mix[0], mix[1]);
+            size_t size = CobsFrameParser::Encode(payload, length, encoded.data(), encoded.size());
+            size_t decoded = 0;
+            int errors = 0;
+            // 前後の区切りコード以外に 0x00 がないこと、サイズが最大サイズ以下であること
+            bool ok = (size >= 4) && (size <= COBS_ENCODED_MAX(length + COBS_FRAME_CRC_SIZE) + 2) &&
+                      (memchr(&encoded[1], COBS_FRAME_DELIMITER, size - 2) == NULL);
+            ok = ok && (feed(&parser, encoded.data(), size, &decoded, &errors) == 1) && (errors == 0) && (decoded == length) &&
+                 (memcmp(buffer.data.data(), payload, length) == 0) && buffer.Intact();
+            stats.count++;
+            stats.failures += ok ? 0 : 1;
+        }
+        pass &= summary("round trip", stats);
+    }
+
+    // ファズ試験 ランダムなバイト列（0x00 の割合を変える）
+    {
+        Stats       stats = {};
+        uint64_t    accepted = 0;
+        uint64_t    frames = 0;
+        std::vector<uint8_t> data(1 << 20);
+        parser.Reset(buffer.data.data(), buffer.size);
+        for (size_t done = 0; done < BENCH_FUZZ_BYTES; done += data.size()) {
+            int zeroPercent = (int)((done / data.size()) % 4) * 2;
+            makePayload(random, data.data(), data.size(), zeroPercent, 5);
+            for (uint8_t byte : data) {
+                CobsFrameParser::RESULT result = parser.Feed(byte);
+                if (result != CobsFrameParser::RESULT_CONTINUE) {
+                    frames++;
+                }
+                if (result == CobsFrameParser::RESULT_FRAME_OK) {
+                    // 偶然 CRC が一致した（長さ 2 以上のフレームの約 1/65536）
+                    accepted++;
+                    if (parser.GetLength() > buffer.size - COBS_FRAME_CRC_SIZE) {
+                        stats.failures++;
+                    }
+                }
+            }
+            stats.count += data.size();
+            stats.failures += buffer.Intact() ? 0 : 1;
+        }
+        char note[96];
+        snprintf(note, sizeof (note), "  (frames %llu, CRC matched by chance %llu)", (unsigned long long)frames, (unsigned long long)accepted);
+        pass &= summary("fuzz random bytes", stats, note);
+    }
+
+    // ファズ試験 １ビット反転したフレーム（反転後に次の正しいフレームで同期が戻ること）
+    //   データバイトの反転（0x00 にならないもの）はデコード結果の１ビット誤りなので、CRC で必ず検出する
+    //   コードバイトの反転・0x00 になる反転はブロックの構造が変わるため、CRC が偶然一致する（約 1/65536）ことがある
+    {
+        Stats       stats = {};
+        uint64_t    structural = 0;
+        uint64_t    structuralAccepted = 0;
+        std::vector<uint8_t> stream;
+        std::vector<bool> isCode;
+        parser.Reset(buffer.data.data(), buffer.size);
+        for (int n = 0; n < BENCH_FLIP_FRAMES; n++) {
+            size_t length = 1 + random() % 64;
+            makePayload(random, payload, length, 10, 5);
+            size_t size = CobsFrameParser::Encode(payload, length, encoded.data(), encoded.size());
+            // コードバイトの位置
+            isCode.assign(size, false);
+            for (size_t pos = 1; pos + 1 < size; pos += encoded[pos]) {
+                isCode[pos] = true;
+            }
+            // 区切りコードを除く各ビットを反転する
+            for (size_t pos = 1; pos + 1 < size; pos++) {
+                for (int bit = 0; bit < 8; bit++) {
+                    stream.assign(encoded.begin(), encoded.begin() + size);
+                    stream[pos] ^= (uint8_t)(1 << bit);
+                    bool dataFlip = !isCode[pos] && (stream[pos] != COBS_FRAME_DELIMITER);
+                    size_t decoded = 0;
+                    int errors = 0;
+                    int ok = feed(&parser, stream.data(), stream.size(), &decoded, &errors);
+                    bool accepted = (ok != 0) && ((decoded != length) || (memcmp(buffer.data.data(), payload, length) != 0));
+                    if (dataFlip) {
+                        // データバイトの誤りを受け付けた
+                        stats.failures += accepted ? 1 : 0;
+                    }
+                    else {
+                        structural++;
+                        structuralAccepted += accepted ? 1 : 0;
+                    }
+                    // 正しいフレームで同期が戻ること
+                    ok = feed(&parser, encoded.data(), size, &decoded, &errors);
+                    stats.count++;
+                    stats.failures += ((ok == 1) && (decoded == length) && (memcmp(buffer.data.data(), payload, length) == 0) &&
+                                       buffer.Intact()) ? 0 : 1;
+                }
+            }
+        }
+        char note[96];
+        snprintf(note, sizeof (note), "  (structural flips %llu, CRC matched by chance %llu)", (unsigned long long)structural,
+                 (unsigned long long)structuralAccepted);
+        pass &= summary("fuzz bit flips + resync", stats, note);
+    }
+
+    // ファズ試験 切り詰めたフレーム・小さい格納先
+    //   CRC の下位バイトが 0x00 のフレームは、末尾のコードバイト（0x01）が欠落すると、最後の 0x00 を除いたデータとして
+    //   CRC が一致する（剰余 0 の CRC は末尾の 0x00 の有無で剰余が変わらない）。この場合は数えて、失敗としない
+    {
+        Stats       stats = {};
+        uint64_t    trailingZero = 0;
+        Buffer      small(16);
+        for (int n = 0; n < BENCH_FLIP_FRAMES; n++) {
+            size_t length = random() % 64;
+            makePayload(random, payload, length, 10, 5);
+            size_t size = CobsFrameParser::Encode(payload, length, encoded.data(), encoded.size());
+            size_t decoded = 0;
+            int errors = 0;
+            // 途中で切り詰めて区切りコードを続ける
+            size_t cut = 1 + random() % (size - 2);
+            parser.Reset(buffer.data.data(), buffer.size);
+            std::vector<uint8_t> stream(encoded.begin(), encoded.begin() + cut);
+            stream.push_back(COBS_FRAME_DELIMITER);
+            int ok = feed(&parser, stream.data(), stream.size(), &decoded, &errors);
+            stats.count++;
+            if ((ok != 0) && (cut == size - 2) && (encoded[cut] == 0x01)) {
+                // 末尾のコードバイトの欠落（CRC の下位バイト 0x00）
+                trailingZero++;
+            }
+            else {
+                stats.failures += (ok == 0) ? 0 : 1;
+            }
+            // 格納先より長いフレームは RESULT_ERR_OVERFLOW、格納先の外に書き込まない
+            parser.Reset(small.data.data(), small.size);
+            ok = feed(&parser, encoded.data(), size, &decoded, &errors);
+            bool fits = (length + COBS_FRAME_CRC_SIZE) <= small.size;
+            stats.count++;
+            stats.failures += ((fits ? (ok == 1) : (ok == 0)) && small.Intact()) ? 0 : 1;
+        }
+        char note[96];
+        snprintf(note, sizeof (note), "  (last code byte dropped, CRC low byte 0x00 %llu)", (unsigned long long)trailingZero);
+        pass &= summary("fuzz truncation + overflow", stats, note);
+    }
+
+    // 処理速度
+    {
+        static const size_t lengths[] = { 16, 64, 254, 600 };
+        for (size_t length : lengths) {
+            makePayload(random, payload, length, 5, 5);
+            size_t size = CobsFrameParser::Encode(payload, length, encoded.data(), encoded.size());
+            long frames = (long)(BENCH_SPEED_BYTES / size);
+            uint64_t checksum = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (long n = 0; n < frames; n++) {
+                payload[0] = (uint8_t)n;
+                checksum += CobsFrameParser::Encode(payload, length, encoded.data(), encoded.size());
+            }
+            double encodeSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            size = CobsFrameParser::Encode(payload, length, encoded.data(), encoded.size());
+            parser.Reset(buffer.data.data(), buffer.size);
+            start = std::chrono::steady_clock::now();
+            for (long n = 0; n < frames; n++) {
+                for (size_t i = 0; i < size; i++) {
+                    checksum += parser.Feed(encoded[i]);
+                }
+            }
+            double feedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            for (long n = 0; n < frames; n++) {
+                payload[0] = (uint8_t)n;
+                checksum += Crc16Calc(payload, length);
+            }
+            double crcSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            printf("payload %3zu B  Feed %6.1f MB/s (%5.1f ns/frame)  Encode %6.1f MB/s  Crc16Calc %6.1f MB/s  [%llu]\n", length,
+                   frames * size / feedSec / 1e6, feedSec / frames * 1e9, frames * length / encodeSec / 1e6,
+                   frames * length / crcSec / 1e6, (unsigned long long)checksum);
+        }
+    }
+
+    printf("%s\n", pass ? "PASS: all frames round-tripped, no corrupted frame accepted" : "FAIL");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
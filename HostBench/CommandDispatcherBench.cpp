@@ -0,0 +1,239 @@
+/******************************************************************************
+ * @file       CommandDispatcherBench.cpp
+ * @brief      コマンドディスパッチャ 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat と同じコマンド定義表で、正常・未定義コマンド・引数不正を混ぜたコマンド行を 1,000,000行振り分け、
+ *             振り分け結果と処理関数の呼び出し回数を検査する
+ *             M5AtomSat の dispatchCommand と同じく、コマンド行の写しを作ってから振り分ける
+ *             また１行の振り分け時間と、コマンド検索（二分探索と先頭からの strcmp の比較）の時間を計測する
+ *             整数引数は先頭の 0 で8進数とせず 10進数（0x で16進数）で解析することを検査する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "CommandDispatcher.h"
+
+#define BENCH_COMMANDS          1000000     // 振り分けるコマンド行数
+#define BENCH_LINE_SIZE         128         // コマンド行の写しのサイズ（M5AtomSat の受信スロットサイズ）
+
+static const char * const tlm_format_names[] = { "text", "frame", "delta", NULL };
+static const char * const channel_names[] = { "attitude", "temp", "imu", "status", NULL };
+
+static uint32_t handlerCalls;               // 処理関数の呼び出し回数
+static uint64_t argCount;                   // 受け取った引数の数の合計
+
+// 処理関数（呼び出し回数と引数の数を記録する）
+static void handler(const CommandDispatcher::CommandArgs &args)
+{
+    handlerCalls++;
+    argCount += args.count;
+}
+
+// M5AtomSat と同じ並びのコマンド定義表
+constexpr CommandDispatcher::CommandDef cmd_table[] = {
+    //  コマンド名  処理関数    引数仕様    列挙名表
+    {   "at",       handler,    "is",       NULL    },
+    {   "cmdstat",  handler,    "",         NULL    },
+    {   "deltastat", handler,   "",         NULL    },
+    {   "imustat",  handler,    "",         NULL    },
+    {   "rxstat",   handler,    "",         NULL    },
+    {   "taskstat", handler,    "",         NULL    },
+    {   "temp",     handler,    "",         NULL    },
+    {   "timeline", handler,    "I",        NULL    },
+    {   "tlmdict",  handler,    "",         NULL    },
+    {   "tlmdump",  handler,    "II",       NULL    },
+    {   "tlmfmt",   handler,    "e",        tlm_format_names    },
+    {   "tlmoff",   handler,    "",         NULL    },
+    {   "tlmon",    handler,    "",         NULL    },
+    {   "tlmrate",  handler,    "EF",       channel_names   },
+    {   "txstat",   handler,    "",         NULL    },
+};
+static_assert(CommandDispatcher::IsSorted(cmd_table), "cmd_table must be sorted by command name");
+
+struct Sample {                             // 評価用コマンド行
+    const char                  *line;      // コマンド行
+    CommandDispatcher::RESULT   result;     // 期待する振り分け結果
+};
+
+static const Sample samples[] = {
+    { "temp",                       CommandDispatcher::RESULT_SUCCESS },
+    { "tlmon",                      CommandDispatcher::RESULT_SUCCESS },
+    { "tlmoff",                     CommandDispatcher::RESULT_SUCCESS },
+    { "rxstat",                     CommandDispatcher::RESULT_SUCCESS },
+    { "txstat",                     CommandDispatcher::RESULT_SUCCESS },
+    { "  taskstat  ",               CommandDispatcher::RESULT_SUCCESS },
+    { "tlmrate attitude 10",        CommandDispatcher::RESULT_SUCCESS },
+    { "tlmrate\timu\t0.5",          CommandDispatcher::RESULT_SUCCESS },
+    { "tlmrate",                    CommandDispatcher::RESULT_SUCCESS },
+    { "tlmfmt delta",               CommandDispatcher::RESULT_SUCCESS },
+    { "tlmdump 0x10 32",            CommandDispatcher::RESULT_SUCCESS },
+    { "timeline",                   CommandDispatcher::RESULT_SUCCESS },
+    { "at 120 tlmrate temp 1",      CommandDispatcher::RESULT_SUCCESS },
+    { "",                           CommandDispatcher::RESULT_NO_COMMAND },
+    { "tmp",                        CommandDispatcher::RESULT_ERR_UNKNOWN_CMD },
+    { "zzz 1 2 3",                  CommandDispatcher::RESULT_ERR_UNKNOWN_CMD },
+    { "TEMP",                       CommandDispatcher::RESULT_ERR_UNKNOWN_CMD },
+    { "temp 1",                     CommandDispatcher::RESULT_ERR_ARGS },
+    { "tlmfmt",                     CommandDispatcher::RESULT_ERR_ARGS },
+    { "tlmdump 1 2 3",              CommandDispatcher::RESULT_ERR_ARGS },
+    { "at 10",                      CommandDispatcher::RESULT_ERR_ARGS },
+    { "tlmfmt json",                CommandDispatcher::RESULT_ERR_ARG_TYPE },
+    { "tlmrate gps 1",              CommandDispatcher::RESULT_ERR_ARG_TYPE },
+    { "tlmrate temp fast",          CommandDispatcher::RESULT_ERR_ARG_TYPE },
+    { "at 1x temp",                 CommandDispatcher::RESULT_ERR_ARG_TYPE },
+};
+#define SAMPLE_NUM  (sizeof (samples) / sizeof (samples[0]))
+
+struct IntSample {                          // 整数引数の解析の評価用コマンド行
+    const char                  *line;      // コマンド行（tlmdump 引数２個）
+    CommandDispatcher::RESULT   result;     // 期待する振り分け結果
+    long                        first;      // 期待する第１引数
+    long                        second;     // 期待する第２引数
+};
+
+static const IntSample intSamples[] = {
+    { "tlmdump 010 08",             CommandDispatcher::RESULT_SUCCESS,      10,     8   },
+    { "tlmdump 09 0",               CommandDispatcher::RESULT_SUCCESS,      9,      0   },
+    { "tlmdump 0x10 0X1f",          CommandDispatcher::RESULT_SUCCESS,      16,     31  },
+    { "tlmdump -010 +0x10",         CommandDispatcher::RESULT_SUCCESS,      -10,    16  },
+    { "tlmdump 0x 1",               CommandDispatcher::RESULT_ERR_ARG_TYPE, 0,      0   },
+    { "tlmdump 08a 1",              CommandDispatcher::RESULT_ERR_ARG_TYPE, 0,      0   },
+};
+
+static long intArgs[2];                     // 受け取った整数引数
+
+// 整数引数を記録する処理関数
+static void intHandler(const CommandDispatcher::CommandArgs &args)
+{
+    intArgs[0] = args.arg[0].i;
+    intArgs[1] = args.arg[1].i;
+}
+
+constexpr CommandDispatcher::CommandDef int_table[] = {
+    //  コマンド名  処理関数    引数仕様    列挙名表
+    {   "tlmdump",  intHandler, "ii",       NULL    },
+};
+
+// 先頭から strcmp で探すコマンド検索（比較用）
+static const CommandDispatcher::CommandDef *findLinear(const char *name)
+{
+    for (const CommandDispatcher::CommandDef &def : cmd_table) {
+        if (strcmp(name, def.name) == 0) {
+            return &def;
+        }
+    }
+    return NULL;
+}
+
+int main()
+{
+    CommandDispatcher   dispatcher(cmd_table);
+    std::mt19937        random(20261016);
+    std::vector<uint8_t> order(BENCH_COMMANDS);
+    uint32_t            counts[CommandDispatcher::RESULT_NUM] = {};
+    uint32_t            expectedCalls = 0;
+    uint32_t            mismatches = 0;
+    char                command[BENCH_LINE_SIZE];
+    bool                pass = true;
+
+    for (uint8_t &index : order) {
+        index = (uint8_t)(random() % SAMPLE_NUM);
+    }
+
+    // 振り分け（dispatchCommand と同じく写しを解析する）
+    handlerCalls = 0;
+    argCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint8_t index : order) {
+        const char *line = samples[index].line;
+        strncpy(command, line, sizeof (command) - 1);
+        command[sizeof (command) - 1] = '\0';
+        CommandDispatcher::RESULT result = dispatcher.Dispatch(command);
+        counts[result]++;
+        if (result != samples[index].result) {
+            if (mismatches++ < 5) {
+                printf("  mismatch \"%s\": expected %d actual %d\n", line, samples[index].result, result);
+            }
+        }
+    }
+    double dispatchNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_COMMANDS;
+
+    for (uint8_t index : order) {
+        expectedCalls += (samples[index].result == CommandDispatcher::RESULT_SUCCESS) ? 1 : 0;
+    }
+
+    printf("dispatch %u lines (%u commands, %u patterns)\n", BENCH_COMMANDS, (unsigned)(sizeof (cmd_table) / sizeof (cmd_table[0])),
+           (unsigned)SAMPLE_NUM);
+    printf("  success %u  no command %u  unknown %u  args %u  arg type %u\n", counts[CommandDispatcher::RESULT_SUCCESS],
+           counts[CommandDispatcher::RESULT_NO_COMMAND], counts[CommandDispatcher::RESULT_ERR_UNKNOWN_CMD],
+           counts[CommandDispatcher::RESULT_ERR_ARGS], counts[CommandDispatcher::RESULT_ERR_ARG_TYPE]);
+    printf("  handler calls %u (expected %u)  args %llu  result mismatches %u\n", handlerCalls, expectedCalls,
+           (unsigned long long)argCount, mismatches);
+    printf("Dispatch (with line copy)   %6.1f ns/line\n", dispatchNs);
+    if ((mismatches != 0) || (handlerCalls != expectedCalls)) {
+        pass = false;
+    }
+
+    // 整数引数の解析（先頭の 0 は 10進数、0x で16進数）
+    {
+        CommandDispatcher   intDispatcher(int_table);
+        uint32_t            intMismatches = 0;
+
+        for (const IntSample &sample : intSamples) {
+            intArgs[0] = intArgs[1] = -1;
+            strncpy(command, sample.line, sizeof (command) - 1);
+            command[sizeof (command) - 1] = '\0';
+            CommandDispatcher::RESULT result = intDispatcher.Dispatch(command);
+            bool ok = (result == sample.result) &&
+                      ((result != CommandDispatcher::RESULT_SUCCESS) || ((intArgs[0] == sample.first) && (intArgs[1] == sample.second)));
+            if (!ok) {
+                printf("  mismatch \"%s\": expected %d (%ld, %ld) actual %d (%ld, %ld)\n", sample.line, sample.result, sample.first,
+                       sample.second, result, intArgs[0], intArgs[1]);
+                intMismatches++;
+            }
+        }
+        printf("integer args (decimal, 0x hex)  %u lines  mismatches %u\n", (unsigned)(sizeof (intSamples) / sizeof (intSamples[0])),
+               intMismatches);
+        if (intMismatches != 0) {
+            pass = false;
+        }
+    }
+
+    // コマンド検索（全コマンド名と未定義の名前）
+    {
+        const char *names[] = { "at", "cmdstat", "deltastat", "imustat", "rxstat", "taskstat", "temp", "timeline",
+                                "tlmdict", "tlmdump", "tlmfmt", "tlmoff", "tlmon", "tlmrate", "txstat", "tmp", "zzz", "TEMP" };
+        const size_t nameNum = sizeof (names) / sizeof (names[0]);
+        uintptr_t found = 0;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_COMMANDS; i++) {
+            found += (uintptr_t)dispatcher.Find(names[i % nameNum]);
+        }
+        double binaryNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_COMMANDS;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_COMMANDS; i++) {
+            found -= (uintptr_t)findLinear(names[i % nameNum]);
+        }
+        double linearNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_COMMANDS;
+
+        printf("Find (binary search)        %6.1f ns/lookup\n", binaryNs);
+        printf("linear strcmp               %6.1f ns/lookup  [difference %llu]\n", linearNs, (unsigned long long)found);
+        if (found != 0) {
+            // 検索結果が一致しない
+            pass = false;
+        }
+    }
+
+    printf("%s\n", pass ? "PASS: all lines dispatched as expected" : "FAIL: unexpected dispatch result");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+ * @file       CommandTimelineBench.cpp
+ * @brief      コマンドタイムライン 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の CommandTimeline（最小ヒープ）に数千件のコマンドを登録して評価する
+ *               ・順序試験 : 同じ実行時刻を多く含むランダムな実行時刻で登録・取り出しを繰り返し、
+ *                            実行時刻順・同一時刻は登録順に取り出されることを std::multimap と比較する
+ *               ・満杯試験 : 登録可能数まで登録し、次の登録が RESULT_ERR_FULL になること、全件が順序どおり取り出されること
+ *               ・処理時間 : 登録数を変えて Add・PopDue の１件あたりの時間を、整列した配列への挿入（O(n)）と比較する
+ *                            また GetNext による全件の列挙（１件あたり O(n)）の時間を求める
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "CommandTimeline.h"
+
+#define BENCH_CAPACITY          16384       // 登録可能コマンド数
+#define BENCH_COMMAND_MAX       47          // コマンド最大長[byte]（M5AtomSat の TIMELINE_CMD_MAX）
+#define BENCH_ORDER_OPS         2000000     // 順序試験の操作数
+#define BENCH_TIMING_OPS        2000000     // 処理時間測定の操作数
+
+typedef CommandTimeline<BENCH_CAPACITY, BENCH_COMMAND_MAX> BenchTimeline;
+
+// 整列した配列（比較用、実行時刻順に挿入位置を探して後ろをずらす）
+struct SortedArray {
+    struct Item {
+        uint32_t            runTime;        // 実行時刻
+        char                command[BENCH_COMMAND_MAX + 1]; // コマンド文字列
+    };
+    std::vector<Item>       items;          // 要素（先頭が最も早い）
+    size_t                  count;          // 要素数
+
+    SortedArray() : items(BENCH_CAPACITY), count(0) {}
+    void Add(uint32_t runTime, const char *command)
+    {
+        size_t index = count;
+        while ((index > 0) && (items[index - 1].runTime > runTime)) {
+            index--;
+        }
+        memmove(&items[index + 1], &items[index], (count - index) * sizeof (Item));
+        items[index].runTime = runTime;
+        strcpy(items[index].command, command);
+        count++;
+    }
+    bool PopDue(uint32_t now, char *command)
+    {
+        if ((count == 0) || (items[0].runTime > now)) {
+            return false;
+        }
+        strcpy(command, items[0].command);
+        count--;
+        memmove(&items[0], &items[1], count * sizeof (Item));
+        return true;
+    }
+};
+
+// コマンド文字列生成
+static void makeCommand(uint32_t index, char *command)
+{
+    snprintf(command, BENCH_COMMAND_MAX + 1, "tlmrate attitude %u", index);
+}
+
+int main()
+{
+    static BenchTimeline    timeline;
+    std::mt19937            random(20261016);
+    char                    command[BENCH_COMMAND_MAX + 1];
+    char                    popped[BENCH_COMMAND_MAX + 1];
+    bool                    pass = true;
+
+    // 順序試験（登録と取り出しを混ぜ、時刻を進めながら std::multimap と比較する）
+    {
+        std::multimap<uint32_t, std::string>    reference;  // 同じキーは挿入順に並ぶ
+        uint64_t    mismatches = 0;
+        uint64_t    adds = 0;
+        uint64_t    pops = 0;
+        uint64_t    fullErrors = 0;
+        uint32_t    now = 0;
+        uint32_t    index = 0;
+
+        timeline.Clear();
+        for (int op = 0; op < BENCH_ORDER_OPS; op++) {
+            if ((random() % 100) < 52) {
+                // 登録（現在時刻から 0〜999 後、同じ時刻が多くなるよう 10 単位に丸める）
+                uint32_t runTime = now + (uint32_t)(random() % 100) * 10;
+                makeCommand(index++, command);
+                CommandTimelineBase::RESULT result = timeline.Add(runTime, command);
+                if (reference.size() >= BENCH_CAPACITY) {
+                    // 満杯 RESULT_ERR_FULL になること
+                    fullErrors++;
+                    mismatches += (result == CommandTimelineBase::RESULT_ERR_FULL) ? 0 : 1;
+                    continue;
+                }
+                mismatches += (result == CommandTimelineBase::RESULT_SUCCESS) ? 0 : 1;
+                reference.insert(std::make_pair(runTime, std::string(command)));
+                adds++;
+            }
+            else {
+                // 時刻を進めて、実行時刻に達したものをすべて取り出す
+                now += (uint32_t)(random() % 3);
+                uint32_t runTime;
+                while (timeline.PopDue(now, popped, sizeof (popped), &runTime) == CommandTimelineBase::RESULT_SUCCESS) {
+                    auto first = reference.begin();
+                    if ((first == reference.end()) || (first->first != runTime) || (first->second != popped) || (runTime > now)) {
+                        mismatches++;
+                    }
+                    if (first != reference.end()) {
+                        reference.erase(first);
+                    }
+                    pops++;
+                }
+                // 実行時刻に達したものが残っていないこと
+                if (!reference.empty() && (reference.begin()->first <= now)) {
+                    mismatches++;
+                }
+            }
+            if (timeline.Count() != reference.size()) {
+                mismatches++;
+            }
+        }
+        // 残りを実行時刻順に取り出す
+        while (timeline.PopDue(UINT32_MAX, popped, sizeof (popped)) == CommandTimelineBase::RESULT_SUCCESS) {
+            if (reference.empty() || (reference.begin()->second != popped)) {
+                mismatches++;
+            }
+            if (!reference.empty()) {
+                reference.erase(reference.begin());
+            }
+            pops++;
+        }
+        mismatches += reference.empty() ? 0 : 1;
+        printf("order vs std::multimap   adds %8llu  pops %8llu  full %6llu  mismatches %llu\n", (unsigned long long)adds,
+               (unsigned long long)pops, (unsigned long long)fullErrors, (unsigned long long)mismatches);
+        pass &= (mismatches == 0);
+    }
+
+    // 満杯試験（登録可能数まで登録し、次の登録が RESULT_ERR_FULL、取り出しが実行時刻順・同一時刻は登録順）
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> expected;    // 実行時刻と登録順
+        uint64_t    mismatches = 0;
+
+        timeline.Clear();
+        for (uint32_t index = 0; index < BENCH_CAPACITY; index++) {
+            uint32_t runTime = (uint32_t)(random() % 1000);
+            makeCommand(index, command);
+            mismatches += (timeline.Add(runTime, command) == CommandTimelineBase::RESULT_SUCCESS) ? 0 : 1;
+            expected.push_back(std::make_pair(runTime, index));
+        }
+        mismatches += (timeline.Add(0, command) == CommandTimelineBase::RESULT_ERR_FULL) ? 0 : 1;
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b) { return a.first < b.first; });
+        for (const std::pair<uint32_t, uint32_t> &item : expected) {
+            uint32_t runTime;
+            makeCommand(item.second, command);
+            if ((timeline.PopDue(UINT32_MAX, popped, sizeof (popped), &runTime) != CommandTimelineBase::RESULT_SUCCESS) ||
+                (runTime != item.first) || (strcmp(popped, command) != 0)) {
+                mismatches++;
+            }
+        }
+        mismatches += (timeline.PopDue(UINT32_MAX, popped, sizeof (popped)) == CommandTimelineBase::RESULT_EMPTY) ? 0 : 1;
+        printf("fill to capacity         entries %5u  mismatches %llu\n", BENCH_CAPACITY, (unsigned long long)mismatches);
+        pass &= (mismatches == 0);
+    }
+
+    // 処理時間（登録数 n を保ったまま、登録と取り出しを交互に行う）
+    static const size_t sizes[] = { 64, 1024, 4096, 16383 };
+    for (size_t n : sizes) {
+        std::vector<uint32_t>   offsets(BENCH_TIMING_OPS);
+        for (uint32_t &offset : offsets) {
+            offset = (uint32_t)(random() % 100000);
+        }
+        makeCommand(0, command);
+
+        // ヒープ
+        timeline.Clear();
+        for (size_t i = 0; i < n; i++) {
+            timeline.Add(offsets[i], command);
+        }
+        uint32_t    runTime = 0;
+        uint64_t    checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int op = 0; op < BENCH_TIMING_OPS; op++) {
+            timeline.PopDue(UINT32_MAX, popped, sizeof (popped), &runTime);
+            timeline.Add(runTime + offsets[op], command);
+            checksum += runTime;
+        }
+        double heapNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_TIMING_OPS;
+
+        // 整列した配列
+        SortedArray *sorted = new SortedArray();
+        for (size_t i = 0; i < n; i++) {
+            sorted->Add(offsets[i], command);
+        }
+        int arrayOps = (n > 1024) ? (BENCH_TIMING_OPS / 20) : BENCH_TIMING_OPS;
+        start = std::chrono::steady_clock::now();
+        for (int op = 0; op < arrayOps; op++) {
+            runTime = sorted->items[0].runTime;
+            sorted->PopDue(UINT32_MAX, popped);
+            sorted->Add(runTime + offsets[op], command);
+            checksum += runTime;
+        }
+        double arrayNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / arrayOps;
+        delete sorted;
+
+        // 全件の列挙
+        CommandTimelineBase::Entry  entry;
+        size_t                      listed = 0;
+        start = std::chrono::steady_clock::now();
+        for (bool found = timeline.GetNext(NULL, &entry); found; found = timeline.GetNext(&entry, &entry)) {
+            listed++;
+        }
+        double listMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        printf("entries %5zu  heap pop+add %6.1f ns  sorted array pop+add %8.1f ns (x%.1f)  list all %8.2f ms (%zu)  [%llu]\n", n, heapNs,
+               arrayNs, arrayNs / heapNs, listMs, listed, (unsigned long long)checksum);
+        pass &= (listed == n);
+    }
+
+    printf("%s\n", pass ? "PASS: popped in run time order, ties in insertion order" : "FAIL: order differs");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
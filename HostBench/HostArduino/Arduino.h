@@ -0,0 +1,111 @@
+/******************************************************************************
+ * @file       Arduino.h
+ * @brief      Arduino 模擬（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の SerialReceive・SerialTransmit・TaskPeriod をホスト上で動かすための Arduino の代替
+ *             Print・Stream・HardwareSerial・時刻・端子出力の、使用している API だけを実装する
+ *             HardwareSerial は UART の模擬で、受信 FIFO（既定 256バイト、溢れた分は破棄して数える）と UART受信通知を持つ
+ *             送信したバイトは送信先関数に渡す（未設定は標準出力）。Serial は標準出力に出力する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "freertos/FreeRTOS.h"
+
+// UART受信通知（HardwareSerial::onReceive）のある arduino-esp32 として扱う
+#define ESP_ARDUINO_VERSION_VAL(major, minor, patch)    (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_ARDUINO_VERSION     ESP_ARDUINO_VERSION_VAL(2, 0, 14)
+
+#define LOW                     0
+#define HIGH                    1
+#define INPUT                   0x01
+#define OUTPUT                  0x03
+#define HOST_PIN_NUM            64          // 端子数
+
+#define HOST_UART_RX_SIZE       256         // 受信 FIFO サイズ[byte]（既定値、arduino-esp32 の既定の受信バッファと同じ）
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// 出力
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return (str == NULL) ? 0 : write((const uint8_t *)str, strlen(str)); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char *str) { return write(str); }
+    size_t println(const char *str) { return print(str) + print("\r\n"); }
+    size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+};
+
+// 入出力
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    // 読み出し（待たずに、読み出せるだけ読み出す）
+    size_t readBytes(uint8_t *buffer, size_t length);
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+};
+
+// UART の模擬
+class HardwareSerial : public Stream
+{
+public:
+    typedef std::function<void(const uint8_t *data, size_t size)> TxSink;
+
+    HardwareSerial(size_t rxSize = HOST_UART_RX_SIZE) : _rxSize(rxSize), _overflows(0), _sink(0), _onReceive(0) {}
+
+    // 受信（相手側から受信 FIFO に格納し、格納できたバイト数を返す。格納したら UART受信通知を呼ぶ）
+    size_t Inject(const uint8_t *data, size_t size);
+    // 受信 FIFO の溢れで破棄したバイト数
+    uint32_t Overflows() const { return _overflows; }
+    // 送信先関数設定
+    void SetTxSink(TxSink sink) { _sink = sink; }
+
+    void onReceive(std::function<void(void)> function, bool onlyOnTimeout = false) { _onReceive = function; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t data) override { return write(&data, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int availableForWrite() override { return 128; }
+
+private:
+    std::mutex                      _mutex;         // 受信 FIFO の排他
+    std::deque<uint8_t>             _rx;            // 受信 FIFO
+    size_t                          _rxSize;        // 受信 FIFO サイズ
+    uint32_t                        _overflows;     // 溢れで破棄したバイト数
+    TxSink                          _sink;          // 送信先関数
+    std::function<void(void)>       _onReceive;     // UART受信通知
+};
+
+extern HardwareSerial Serial;
+
+#endif /* _HOST_ARDUINO_H_ */
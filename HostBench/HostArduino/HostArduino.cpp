@@ -0,0 +1,332 @@
+/******************************************************************************
+ * @file       HostArduino.cpp
+ * @brief      Arduino・FreeRTOS・M5Atom ライブラリ模擬（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    Arduino.h・freertos/FreeRTOS.h・M5Atom.h で宣言した模擬の実装
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 tick を手動で進める試験用の操作を追加
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include "M5Atom.h"
+
+struct HostTaskControl {                    // タスク制御
+    std::mutex                  mutex;      // 通知値の排他
+    std::condition_variable     cond;       // 通知待ち
+    uint32_t                    value;      // 通知値
+};
+
+struct HostQueue {                          // キュー
+    std::mutex                  mutex;      // キューの排他
+    std::condition_variable     notEmpty;   // 受信待ち
+    std::condition_variable     notFull;    // 送信待ち
+    std::vector<uint8_t>        storage;    // 要素領域
+    UBaseType_t                 length;     // 要素数
+    UBaseType_t                 itemSize;   // 要素サイズ
+    UBaseType_t                 head;       // 先頭要素の位置
+    UBaseType_t                 count;      // 格納要素数
+};
+
+typedef std::chrono::steady_clock   HostClock;
+
+static const HostClock::time_point  hostStart = HostClock::now();   // 起動時刻
+static thread_local TaskHandle_t    hostCurrentTask = NULL;         // 実行中のタスク
+static uint8_t                      hostPins[HOST_PIN_NUM];         // 端子出力値
+static std::atomic<bool>            hostManualTick(false);          // tick を手動で進める
+static std::atomic<TickType_t>      hostTick(0);                    // 手動の tick
+
+HardwareSerial Serial;
+
+// 待ち時間の期限
+static HostClock::time_point deadline(TickType_t ticks)
+{
+    return HostClock::now() + std::chrono::milliseconds(ticks * portTICK_PERIOD_MS);
+}
+
+uint32_t micros()
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(HostClock::now() - hostStart).count();
+}
+
+uint32_t millis()
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(HostClock::now() - hostStart).count();
+}
+
+void delay(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin < HOST_PIN_NUM) {
+        __atomic_store_n(&hostPins[pin], val, __ATOMIC_RELEASE);
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (pin < HOST_PIN_NUM) ? __atomic_load_n(&hostPins[pin], __ATOMIC_ACQUIRE) : LOW;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t  count = 0;
+    while ((count < size) && (write(buffer[count]) == 1)) {
+        count++;
+    }
+    return count;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char        buffer[256];
+    va_list     args;
+
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof (buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    if (length >= (int)sizeof (buffer)) {
+        // 長い出力は領域を確保して書式変換する
+        std::vector<char> large(length + 1);
+        va_start(args, format);
+        vsnprintf(large.data(), large.size(), format, args);
+        va_end(args);
+        return write((const uint8_t *)large.data(), length);
+    }
+    return write((const uint8_t *)buffer, length);
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t  count = 0;
+    int     data;
+    while ((count < length) && ((data = read()) >= 0)) {
+        buffer[count++] = (uint8_t)data;
+    }
+    return count;
+}
+
+size_t HardwareSerial::Inject(const uint8_t *data, size_t size)
+{
+    size_t  count;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        count = _rxSize - _rx.size();
+        if (count > size) {
+            count = size;
+        }
+        _rx.insert(_rx.end(), data, data + count);
+        _overflows += size - count;
+    }
+    if ((count > 0) && _onReceive) {
+        _onReceive();
+    }
+    return count;
+}
+
+int HardwareSerial::available()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_rx.size();
+}
+
+int HardwareSerial::read()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_rx.empty()) {
+        return -1;
+    }
+    int data = _rx.front();
+    _rx.pop_front();
+    return data;
+}
+
+int HardwareSerial::peek()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _rx.empty() ? -1 : _rx.front();
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (_sink) {
+        _sink(buffer, size);
+    }
+    else {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    if (hostCurrentTask == NULL) {
+        // Task 以外のスレッド（main など）は最初の呼び出しでタスク制御を割り当てる
+        hostCurrentTask = new HostTaskControl();
+        hostCurrentTask->value = 0;
+    }
+    return hostCurrentTask;
+}
+
+TickType_t xTaskGetTickCount()
+{
+    if (hostManualTick) {
+        return hostTick;
+    }
+    return (TickType_t)(millis() / portTICK_PERIOD_MS);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (hostManualTick) {
+        hostTick += ticks;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t increment)
+{
+    *previousWakeTime += increment;
+    if (hostManualTick) {
+        // 起床時刻を過ぎていなければ起床時刻まで進める（過ぎていれば待たずに戻る）
+        TickType_t now = hostTick;
+        if ((TickType_t)(*previousWakeTime - now) < 0x80000000UL) {
+            hostTick = *previousWakeTime;
+        }
+        return;
+    }
+    std::this_thread::sleep_until(hostStart + std::chrono::milliseconds((uint64_t)*previousWakeTime * portTICK_PERIOD_MS));
+}
+
+void HostSetManualTick(bool manual, TickType_t tick)
+{
+    hostTick = tick;
+    hostManualTick = manual;
+}
+
+void HostAdvanceTick(TickType_t ticks)
+{
+    hostTick += ticks;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->value++;
+    }
+    task->cond.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+    TaskHandle_t                    task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex>    lock(task->mutex);
+
+    if (ticks == portMAX_DELAY) {
+        task->cond.wait(lock, [task]() { return task->value > 0; });
+    }
+    else {
+        task->cond.wait_until(lock, deadline(ticks), [task]() { return task->value > 0; });
+    }
+    uint32_t value = task->value;
+    if (value > 0) {
+        task->value = clearOnExit ? 0 : (value - 1);
+    }
+    return value;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t *storage, StaticQueue_t *queueStatic)
+{
+    HostQueue *queue = new HostQueue();
+    queue->storage.resize(length * itemSize);
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex>    lock(queue->mutex);
+    auto                            notFull = [queue]() { return queue->count < queue->length; };
+
+    if (ticks == portMAX_DELAY) {
+        queue->notFull.wait(lock, notFull);
+    }
+    else if (!queue->notFull.wait_until(lock, deadline(ticks), notFull)) {
+        return pdFAIL;
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[tail * queue->itemSize], item, queue->itemSize);
+    queue->count++;
+    lock.unlock();
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex>    lock(queue->mutex);
+    auto                            notEmpty = [queue]() { return queue->count > 0; };
+
+    if (ticks == portMAX_DELAY) {
+        queue->notEmpty.wait(lock, notEmpty);
+    }
+    else if (!queue->notEmpty.wait_until(lock, deadline(ticks), notEmpty)) {
+        return pdFAIL;
+    }
+    memcpy(item, &queue->storage[queue->head * queue->itemSize], queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    lock.unlock();
+    queue->notFull.notify_one();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->length - queue->count;
+}
+
+void Task::start(void *taskData)
+{
+    TaskHandle_t task = new HostTaskControl();
+    task->value = 0;
+    std::thread([this, task, taskData]() {
+        hostCurrentTask = task;
+        run(taskData);
+    }).detach();
+}
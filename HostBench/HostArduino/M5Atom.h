@@ -0,0 +1,40 @@
+/******************************************************************************
+ * @file       M5Atom.h
+ * @brief      M5Atom ライブラリ模擬（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat のタスククラスが継承する Task の代替（start で std::thread を起動して run を呼ぶ）
+ *             run は終了しないため、評価プログラムは std::_Exit で終了する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _HOST_M5ATOM_H_
+#define _HOST_M5ATOM_H_
+
+#include <string>
+#include "Arduino.h"
+
+class Task
+{
+public:
+    Task(std::string taskName = "Task", uint16_t stackSize = 10000, uint8_t priority = 5) : _name(taskName) {}
+    virtual ~Task() {}
+
+    void setStackSize(uint16_t stackSize) {}
+    void setPriority(uint8_t priority) {}
+    void setName(std::string name) { _name = name; }
+    void setCore(BaseType_t coreId) {}
+    // タスク起動（スレッドを起動し、タスクハンドルを割り当てて run を呼ぶ）
+    void start(void *taskData = nullptr);
+    void stop() {}
+    static void delay(int ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+
+    virtual void run(void *data) = 0;
+
+private:
+    std::string     _name;                  // タスク名
+};
+
+#endif /* _HOST_M5ATOM_H_ */
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * @file       FreeRTOS.h
+ * @brief      FreeRTOS 模擬（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の SerialReceive・SerialTransmit・TaskPeriod をホスト上で動かすための FreeRTOS の代替
+ *             タスクは std::thread、キューとタスク通知は mutex と condition_variable で実装する（1tick = 1ms）
+ *             使用している API だけを実装し、割り込みハンドラ用の API・優先度・コア指定は扱わない
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 tick を手動で進める試験用の操作を追加
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t    TickType_t;
+typedef int         BaseType_t;
+typedef unsigned    UBaseType_t;
+
+#define pdFALSE                 0
+#define pdTRUE                  1
+#define pdFAIL                  0
+#define pdPASS                  1
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFUL)
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+struct HostTaskControl;                     // タスク制御（通知値）
+struct HostQueue;                           // キュー
+
+typedef HostTaskControl     *TaskHandle_t;
+typedef TaskHandle_t        xTaskHandle;
+typedef HostQueue           *QueueHandle_t;
+
+struct StaticQueue_t {                      // キュー管理領域（模擬では使用しない）
+    void        *reserved;
+};
+
+// タスク
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t increment);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+
+// tick 操作（模擬のみ、試験用）
+// 手動にすると tick は実時間で進まず、HostAdvanceTick・vTaskDelay・vTaskDelayUntil（待たずに起床時刻まで進める）でだけ進む
+void HostSetManualTick(bool manual, TickType_t tick = 0);
+void HostAdvanceTick(TickType_t ticks);
+
+// キュー（storage・queueStatic は使用せず、模擬の中で領域を確保する）
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t *storage, StaticQueue_t *queueStatic);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+
+#endif /* _HOST_FREERTOS_H_ */
@@ -0,0 +1,12 @@
+/******************************************************************************
+ * @file       task.h
+ * @brief      FreeRTOS 模擬（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    FreeRTOS.h にまとめて定義している
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include "FreeRTOS.h"
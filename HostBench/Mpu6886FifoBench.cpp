@@ -0,0 +1,156 @@
+/******************************************************************************
+ * @file       Mpu6886FifoBench.cpp
+ * @brief      MPU6886 FIFO 一括取得 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の Mpu6886Fifo をレジスタ模擬（Mpu6886Model）に接続して動かし、
+ *             サンプルの欠落・重複・区切りのずれがないこと、FIFO 溢れから復帰できることを確認する
+ *             また従来のサンプル毎のレジスタ読み出しと、起床回数・トランザクション数・I2C 使用率を比較する
+ *             サンプルには通し番号（角速度 X）と固定値（温度・加速度 Z）を埋め込み、読み出した値で検査する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+#include "Mpu6886Fifo.h"
+#include "Mpu6886Model.h"
+
+#define BENCH_DURATION          10.0        // 模擬時間[秒]
+#define BENCH_INDEX_MOD         16384       // 通し番号の周期（角速度 X の生の値）
+#define BENCH_TEMP_RAW          0x1234      // 温度の生の値（固定）
+#define BENCH_ACCEL_Z_RAW       4096        // 加速度 Z の生の値（1G、固定）
+#define BENCH_BATCH_MAX         (MPU6886_FIFO_SIZE / MPU6886_FIFO_PACKET_SIZE)  // １回に読み出す最大サンプル数
+
+struct Result {                             // 評価結果
+    uint64_t                wakes;          // 起床回数
+    uint64_t                samples;        // 読み出したサンプル数
+    uint64_t                missing;        // 欠落したサンプル数（通し番号の飛び）
+    uint64_t                corrupt;        // 固定値が一致しない・通し番号が戻ったサンプル数
+    uint64_t                overflows;      // FIFO 溢れ回数
+};
+
+// 通し番号を埋め込んだサンプル生成
+static void source(double time, int16_t *raw)
+{
+    long index = lround(time * MPU6886_INTERNAL_RATE);  // 内部サンプリングの回数
+
+    raw[0] = 100;
+    raw[1] = -100;
+    raw[2] = BENCH_ACCEL_Z_RAW;
+    raw[3] = BENCH_TEMP_RAW;
+    raw[4] = (int16_t)(index % BENCH_INDEX_MOD);
+    raw[5] = 0;
+    raw[6] = 0;
+}
+
+// サンプルの検査（step は通し番号の間隔）
+static void check(const ImuSample &sample, long step, long *last, Result *result)
+{
+    long index = lroundf(sample.gx * MPU6886_GYRO_LSB);
+    long raw = lroundf((sample.temp - MPU6886_TEMP_OFFSET) * MPU6886_TEMP_LSB);
+
+    if ((raw != BENCH_TEMP_RAW) || (lroundf(sample.az * MPU6886_ACCEL_LSB) != BENCH_ACCEL_Z_RAW) ||
+        (index < 0) || (index >= BENCH_INDEX_MOD)) {
+        result->corrupt++;
+        return;
+    }
+    if (*last >= 0) {
+        long diff = (index - *last + BENCH_INDEX_MOD) % BENCH_INDEX_MOD;
+        if ((diff == 0) || ((diff % step) != 0)) {
+            result->corrupt++;
+        }
+        else {
+            result->missing += diff / step - 1;
+        }
+    }
+    *last = index;
+    result->samples++;
+}
+
+// 出力
+static void print(const char *name, const Result &result, const Mpu6886Model::Stats &stats, double duration)
+{
+    printf("%-28s wakes %6.0f/s  samples %6.0f/s  transactions %6.0f/s  I2C %5.1f%%  missing %4llu  corrupt %llu  overflows %llu\n",
+        name, result.wakes / duration, result.samples / duration, stats.transactions / duration,
+        100.0 * stats.bits / duration / MPU6886_MODEL_I2C_HZ, (unsigned long long)result.missing,
+        (unsigned long long)result.corrupt, (unsigned long long)result.overflows);
+}
+
+// 従来のサンプル毎のレジスタ読み出し（加速度・角速度・温度を別々に読み出す）
+static void perRegister(double periodSec)
+{
+    Mpu6886Model    model(source);
+    Result          result = {};
+    long            last = -1;
+    uint8_t         buffer[MPU6886_FIFO_PACKET_SIZE];
+
+    model.Write(MPU6886_REG_SMPLRT_DIV, 0);
+    for (double time = 0.0; time < BENCH_DURATION; time += periodSec) {
+        model.Advance(periodSec);
+        model.Read(MPU6886_REG_ACCEL_XOUT_H, &buffer[0], 6);
+        model.Read(MPU6886_REG_GYRO_XOUT_H, &buffer[8], 6);
+        model.Read(MPU6886_REG_TEMP_OUT_H, &buffer[6], 2);
+        result.wakes++;
+        // 取得周期の間のサンプルは読めないので、通し番号の間隔は取得周期
+        ImuSample sample;
+        sample.gx = (float)(int16_t)((buffer[8] << 8) | buffer[9]) / MPU6886_GYRO_LSB;
+        sample.temp = (float)(int16_t)((buffer[6] << 8) | buffer[7]) / MPU6886_TEMP_LSB + MPU6886_TEMP_OFFSET;
+        sample.az = (float)(int16_t)((buffer[4] << 8) | buffer[5]) / MPU6886_ACCEL_LSB;
+        check(sample, lround(periodSec * MPU6886_INTERNAL_RATE), &last, &result);
+    }
+    char name[64];
+    snprintf(name, sizeof (name), "register %4.0fHz", 1.0 / periodSec);
+    print(name, result, model.GetStats(), BENCH_DURATION);
+}
+
+// FIFO 一括取得（起床周期に jitter の揺らぎを加え、stallAt 秒に stall 秒止まる）
+static void fifo(uint32_t rateHz, double wakeSec, double jitter, double stallAt, double stall)
+{
+    Mpu6886Model    model(source);
+    Mpu6886Fifo     imu(&model);
+    Result          result = {};
+    long            last = -1;
+    ImuSample       samples[BENCH_BATCH_MAX];
+    std::mt19937    rng(1);
+    std::uniform_real_distribution<double> wobble(0.0, jitter);
+    bool            stalled = false;
+
+    if (imu.Init(rateHz) != Mpu6886Fifo::RESULT_SUCCESS) {
+        printf("init failed\n");
+        return;
+    }
+    model.ClearStats();
+    while (model.Time() < BENCH_DURATION) {
+        double sleep = wakeSec + wobble(rng);
+        if (!stalled && (stall > 0.0) && (model.Time() >= stallAt)) {
+            sleep += stall;
+            stalled = true;
+        }
+        model.Advance(sleep);
+        size_t count = imu.Drain(samples, BENCH_BATCH_MAX);
+        result.wakes++;
+        for (size_t index = 0; index < count; index++) {
+            check(samples[index], MPU6886_INTERNAL_RATE / rateHz, &last, &result);
+        }
+    }
+    Mpu6886Fifo::Stats stats;
+    imu.GetStats(&stats);
+    result.overflows = stats.overflows;
+    char name[64];
+    snprintf(name, sizeof (name), "fifo %4uHz wake %3.0fms%s", rateHz, wakeSec * 1000, (stall > 0.0) ? " stall" : "");
+    print(name, result, model.GetStats(), model.Time());
+}
+
+int main()
+{
+    perRegister(0.005);
+    perRegister(0.001);
+    fifo(1000, 0.020, 0.005, 0.0, 0.0);
+    fifo(1000, 0.050, 0.010, 0.0, 0.0);
+    fifo(500, 0.050, 0.010, 0.0, 0.0);
+    fifo(1000, 0.020, 0.005, 5.0, 0.2);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * @file       Mpu6886Model.h
+ * @brief      MPU6886 レジスタ模擬（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の Mpu6886Fifo を実機なしで動かすための、レジスタ単位の MPU6886 の模擬
+ *             模擬時刻を進めると、設定したサンプリング周波数でサンプルを生成してデータレジスタと FIFO に格納する
+ *             FIFO はバイト単位で格納し、FIFO_MODE=1 では満杯で格納を止め（サンプルの途中で止まることがある）、
+ *             FIFO_MODE=0 では古いデータを上書きする。溢れたら INT_STATUS の FIFO_OFLOW を立てる
+ *             読み出しのトランザクション数と I2C のビット数（400kHz での転送時間）を数える
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _MPU6886_MODEL_H_
+#define _MPU6886_MODEL_H_
+
+#include <deque>
+#include <functional>
+#include <string.h>
+#include "Mpu6886Fifo.h"
+
+#define MPU6886_MODEL_I2C_HZ        400000      // I2C クロック[Hz]
+#define MPU6886_MODEL_READ_BITS     29          // 読み出しトランザクションの固定部[bit]（アドレス・レジスタ・アドレス・開始・終了）
+
+class Mpu6886Model : public ImuRegisterBus
+{
+public:
+    // サンプル生成関数（時刻[秒]の 加速度 X, Y, Z、温度、角速度 X, Y, Z の生の値を raw に格納する）
+    typedef std::function<void(double time, int16_t *raw)> Source;
+
+    struct Stats {                          // 模擬統計
+        uint64_t    transactions;           // 読み出しトランザクション数
+        uint64_t    bits;                   // 読み出しの I2C ビット数
+        uint64_t    generated;              // 生成したサンプル数
+        uint64_t    dropped;                // FIFO に格納できなかったサンプル数（途中まで格納したものを含む）
+    };
+
+    Mpu6886Model(Source source, size_t maxRead = 126) : _source(source), _maxRead(maxRead), _time(0.0), _tick(0)
+    {
+        memset(_regs, 0, sizeof (_regs));
+        memset(&_stats, 0, sizeof (_stats));
+        _regs[MPU6886_REG_WHO_AM_I] = MPU6886_WHO_AM_I_VALUE;
+    }
+
+    // 模擬時刻を進める（内部サンプリング 1kHz 毎に、分周したサンプルを生成する）
+    void Advance(double seconds)
+    {
+        double end = _time + seconds;
+        // 模擬時刻の丸め誤差で内部サンプリングの時刻をまたぎ損ねないよう、わずかに余裕を持たせる
+        while ((double)(_tick + 1) / MPU6886_INTERNAL_RATE <= end + 1e-9) {
+            _tick++;
+            if ((_tick % ((uint64_t)_regs[MPU6886_REG_SMPLRT_DIV] + 1)) == 0) {
+                sample((double)_tick / MPU6886_INTERNAL_RATE);
+            }
+        }
+        _time = end;
+    }
+
+    double Time() const { return _time; }
+    const Stats &GetStats() const { return _stats; }
+    void ClearStats() { memset(&_stats, 0, sizeof (_stats)); }
+
+    bool Write(uint8_t reg, uint8_t value) override
+    {
+        if (reg >= sizeof (_regs)) {
+            return false;
+        }
+        _regs[reg] = value;
+        if ((reg == MPU6886_REG_USER_CTRL) && (value & MPU6886_USER_CTRL_FIFO_RST)) {
+            // FIFO リセット（自動で 0 に戻る）
+            _fifo.clear();
+            _regs[reg] &= (uint8_t)~MPU6886_USER_CTRL_FIFO_RST;
+        }
+        return true;
+    }
+
+    bool Read(uint8_t reg, uint8_t *dst, size_t length) override
+    {
+        if ((length == 0) || (length > _maxRead)) {
+            return false;
+        }
+        _stats.transactions++;
+        _stats.bits += MPU6886_MODEL_READ_BITS + 9 * length;
+        for (size_t index = 0; index < length; index++) {
+            if (reg == MPU6886_REG_FIFO_R_W) {
+                // FIFO は同じレジスタから続けて読み出す（空なら 0xFF）
+                if (_fifo.empty()) {
+                    dst[index] = 0xFF;
+                }
+                else {
+                    dst[index] = _fifo.front();
+                    _fifo.pop_front();
+                }
+                continue;
+            }
+            uint8_t addr = (uint8_t)(reg + index);
+            if (addr == MPU6886_REG_FIFO_COUNTH) {
+                dst[index] = (uint8_t)(_fifo.size() >> 8);
+            }
+            else if (addr == MPU6886_REG_FIFO_COUNTH + 1) {
+                dst[index] = (uint8_t)(_fifo.size() & 0xFF);
+            }
+            else {
+                dst[index] = _regs[addr];
+                if (addr == MPU6886_REG_INT_STATUS) {
+                    // 読み出しでクリア
+                    _regs[addr] = 0;
+                }
+            }
+        }
+        return true;
+    }
+
+    size_t MaxRead() const override { return _maxRead; }
+
+private:
+    Source                  _source;        // サンプル生成関数
+    size_t                  _maxRead;       // １回の連続読み出しの最大バイト数
+    double                  _time;          // 模擬時刻[秒]
+    uint64_t                _tick;          // 内部サンプリングの回数
+    uint8_t                 _regs[128];     // レジスタ
+    std::deque<uint8_t>     _fifo;          // FIFO
+    Stats                   _stats;         // 模擬統計
+
+    // サンプル生成
+    void sample(double time)
+    {
+        int16_t raw[7];                     // 加速度 X, Y, Z、温度、角速度 X, Y, Z
+        uint8_t packet[MPU6886_FIFO_PACKET_SIZE];
+
+        _source(time, raw);
+        _stats.generated++;
+        for (int index = 0; index < 7; index++) {
+            packet[index * 2] = (uint8_t)((uint16_t)raw[index] >> 8);
+            packet[index * 2 + 1] = (uint8_t)raw[index];
+        }
+        // データレジスタ（加速度・温度・角速度の順に連続している）
+        memcpy(&_regs[MPU6886_REG_ACCEL_XOUT_H], packet, sizeof (packet));
+
+        if (!(_regs[MPU6886_REG_USER_CTRL] & MPU6886_USER_CTRL_FIFO_EN) ||
+            (_regs[MPU6886_REG_FIFO_EN] != MPU6886_FIFO_EN_GYRO_ACCEL)) {
+            return;
+        }
+        bool stopWhenFull = (_regs[MPU6886_REG_CONFIG] & MPU6886_CONFIG_FIFO_MODE) != 0;
+        bool dropped = false;
+        for (size_t index = 0; index < sizeof (packet); index++) {
+            if (_fifo.size() >= MPU6886_FIFO_SIZE) {
+                dropped = true;
+                if (stopWhenFull) {
+                    break;
+                }
+                _fifo.pop_front();
+            }
+            _fifo.push_back(packet[index]);
+        }
+        if (dropped) {
+            _stats.dropped++;
+            _regs[MPU6886_REG_INT_STATUS] |= MPU6886_INT_FIFO_OFLOW;
+        }
+    }
+};
+
+#endif /* _MPU6886_MODEL_H_ */
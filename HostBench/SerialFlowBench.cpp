@@ -0,0 +1,207 @@
+/******************************************************************************
+ * @file       SerialFlowBench.cpp
+ * @brief      シリアル受信 フロー制御 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の SerialReceive・SerialReceiveMux を Arduino・FreeRTOS の模擬（HostArduino）の上で動かし、
+ *             処理の遅い受信側へリンク速度で 10,000行を送っても、フロー制御ありでは１行も失わないことを確認する
+ *             送信側は UART の模擬に 921600bps 相当の速度で書き込み、XOFF 受信中・RTS が HIGH の間は送信を止める
+ *             （停止要求を受けてから止まるまでに送信 FIFO 分（ポート毎に 16・128バイト）まで送る）
+ *             各行には通し番号を埋め込み、受信した行の欠落・順序・内容を検査する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "SerialReceive.h"
+
+#define BENCH_LINES             10000       // 送信行数
+#define BENCH_BAUD              921600      // リンク速度[bps]
+#define BENCH_IDLE_TIMEOUT      2000        // 受信終了判定の無受信時間[ms]
+#define BENCH_RTS_PIN           26          // RTS 端子番号（模擬）
+#define BENCH_XON               0x11        // 送信再開要求コード
+#define BENCH_XOFF              0x13        // 送信停止要求コード
+
+typedef SerialReceive<127, 4> BenchReceive;
+
+struct Port {                               // 評価ポート
+    const char                  *name;      // 名前
+    SerialReceiveBase::FLOW_CONTROL flow;   // フロー制御方式
+    uint32_t                    consumeUs;  // 受信側の１行あたりの処理時間[us]
+    int                         highWater;  // 送信停止要求キュー使用数
+    int                         txFifo;     // 送信側の送信 FIFO サイズ[byte]（停止要求後に送るバイト数の上限）
+    HardwareSerial              *uart;      // UART の模擬
+    BenchReceive                *receiver;  // シリアル受信
+    std::atomic<bool>           xoff;       // XOFF 受信中
+    std::atomic<bool>           sent;       // 送信完了
+    uint32_t                    received;   // 受信行数
+    uint32_t                    orderErrors;    // 通し番号の戻り・内容の不一致数
+    double                      seconds;    // 最後の行を受信するまでの時間[秒]
+};
+
+// 行の生成（通し番号と、通し番号で変わる内容）
+static int makeLine(uint32_t index, char *line, size_t size)
+{
+    return snprintf(line, size, "L%05u,%08X,%s\r\n", index, index * 2654435761U, ((index % 7) == 0) ? "tlmrate 500" : "temp");
+}
+
+// 送信側（リンク速度で送信し、停止要求中は止まる）
+static void sender(Port *port)
+{
+    const double    bytesPerUs = (double)BENCH_BAUD / 10.0 / 1000000.0;
+    char            line[64];
+    int             length = 0;
+    int             offset = 0;
+    uint32_t        index = 0;
+    double          credit = 0.0;
+    auto            last = std::chrono::steady_clock::now();
+
+    while (index < BENCH_LINES) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        auto now = std::chrono::steady_clock::now();
+        credit += std::chrono::duration<double, std::micro>(now - last).count() * bytesPerUs;
+        last = now;
+        bool paused = port->xoff.load() || ((port->flow == SerialReceiveBase::FLOW_CONTROL_RTS) && (digitalRead(BENCH_RTS_PIN) == HIGH));
+        if (paused) {
+            // 停止要求中 送信しない（停止中の時間は送信に使えない）
+            credit = 0.0;
+            continue;
+        }
+        // 送信 FIFO 分まで送信する
+        int budget = (credit < port->txFifo) ? (int)credit : port->txFifo;
+        credit -= budget;
+        while ((budget > 0) && (index < BENCH_LINES)) {
+            if (offset == length) {
+                length = makeLine(index, line, sizeof (line));
+                offset = 0;
+            }
+            int count = ((length - offset) < budget) ? (length - offset) : budget;
+            port->uart->Inject((const uint8_t *)line + offset, count);
+            offset += count;
+            budget -= count;
+            if (offset == length) {
+                index++;
+            }
+        }
+    }
+    port->sent = true;
+}
+
+// 受信側（１行毎に処理時間だけ待つ）
+static void consumer(Port *port)
+{
+    SerialReceiveBase::RecvMsg  msg;
+    char                        expected[64];
+    long                        last = -1;
+    auto                        start = std::chrono::steady_clock::now();
+
+    while (port->received < BENCH_LINES) {
+        if (port->receiver->ReceiveMsg(&msg, BENCH_IDLE_TIMEOUT) != SerialReceiveBase::RESULT_SUCCESS) {
+            if (port->sent) {
+                // 送信完了後に受信が途絶えた
+                break;
+            }
+            continue;
+        }
+        // 通し番号が増えていること、内容が通し番号の行と一致することを検査する
+        long index = (msg.data[0] == 'L') ? strtol(msg.data + 1, NULL, 10) : -1;
+        int length = (index >= 0) ? (makeLine((uint32_t)index, expected, sizeof (expected)) - 2) : 0;
+        if ((msg.type != SerialReceiveBase::MSG_TYPE_TEXT) || (index <= last) || (msg.length != length) ||
+            (memcmp(msg.data, expected, length) != 0)) {
+            port->orderErrors++;
+        }
+        last = index;
+        port->received++;
+        port->receiver->ReleaseMsg(&msg);
+        std::this_thread::sleep_for(std::chrono::microseconds(port->consumeUs));
+    }
+    port->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 評価（ports を１つの SerialReceiveMux で受信する）
+static bool bench(const char *title, Port *ports, int portNum, bool expectZeroLoss)
+{
+    SerialReceiveMux    *mux = new SerialReceiveMux(SerialReceiveBase::LOG_DISABLED);
+    std::thread         threads[2 * SERIAL_RECEIVE_PORT_MAX];
+    bool                pass = true;
+
+    for (int i = 0; i < portNum; i++) {
+        Port *port = &ports[i];
+        port->uart = new HardwareSerial();
+        port->uart->SetTxSink([port](const uint8_t *data, size_t size) {
+            // 受信側からの XON/XOFF
+            for (size_t k = 0; k < size; k++) {
+                if (data[k] == BENCH_XOFF) {
+                    port->xoff = true;
+                }
+                else if (data[k] == BENCH_XON) {
+                    port->xoff = false;
+                }
+            }
+        });
+        port->receiver = new BenchReceive(SerialReceiveBase::LOG_DISABLED);
+        port->receiver->SetPort(port->uart, (uint8_t)i);
+        port->receiver->SetFlowControl(port->flow, port->highWater, SERIAL_RECEIVE_FLOW_LOW_DEFAULT, BENCH_RTS_PIN);
+        port->receiver->Init(false, 0, SerialReceiveBase::RECV_MODE_EVENT);
+        port->xoff = false;
+        port->sent = false;
+        port->received = 0;
+        port->orderErrors = 0;
+        mux->AddPort(port->receiver);
+    }
+    mux->Start();
+    delay(10);
+    for (int i = 0; i < portNum; i++) {
+        threads[2 * i] = std::thread(consumer, &ports[i]);
+        threads[2 * i + 1] = std::thread(sender, &ports[i]);
+    }
+    for (int i = 0; i < 2 * portNum; i++) {
+        threads[i].join();
+    }
+
+    printf("%s\n", title);
+    for (int i = 0; i < portNum; i++) {
+        Port                        *port = &ports[i];
+        SerialReceiveBase::RecvStats stats;
+        port->receiver->GetRecvStats(&stats);
+        uint32_t lost = BENCH_LINES - port->received;
+        printf("  %-8s high %d  tx fifo %3d  consumer %3uus/line  lines %5u/%u  lost %5u  order %u  uart overflow %u  queue drops %5u"
+               "  pauses %4u  stalls %4u  %5.2fs\n",
+               port->name, port->highWater, port->txFifo, port->consumeUs, port->received, BENCH_LINES, lost, port->orderErrors,
+               port->uart->Overflows(), stats.queueFullDrops, stats.flowPauses, stats.flowStalls, port->seconds);
+        if (expectZeroLoss && ((lost != 0) || (port->orderErrors != 0) || (port->uart->Overflows() != 0) || (stats.queueFullDrops != 0))) {
+            pass = false;
+        }
+    }
+
+    return pass;
+}
+
+int main()
+{
+    // フロー制御なし 受信側が遅いとキューフルで行を破棄する
+    Port none[1] = {
+        { "none", SerialReceiveBase::FLOW_CONTROL_NONE, 800, 3, 16 },
+    };
+    bench("flow control none (921600bps, 10000 lines)", none, 1, false);
+
+    // フロー制御あり 遅い受信側が２つ（XON/XOFF・RTS）と、リンク速度で処理する受信側（フロー制御なし）を１つの受信タスクで受信する
+    // RTS のポートは停止要求をキュー段数（満杯）とし、停止要求後も 128バイト送る送信側とする
+    // （キューフルで受信メッセージを保留し、残りを UART受信バッファに残して次の起床で再送信する処理を通す）
+    Port flow[3] = {
+        { "xonxoff", SerialReceiveBase::FLOW_CONTROL_XONXOFF, 800, 3, 16 },
+        { "rts", SerialReceiveBase::FLOW_CONTROL_RTS, 800, 4, 128 },
+        { "fast", SerialReceiveBase::FLOW_CONTROL_NONE, 0, 3, 16 },
+    };
+    bool pass = bench("flow control xonxoff/rts + fast port on one SerialReceiveMux (921600bps, 10000 lines)", flow, 3, true);
+
+    printf("%s\n", pass ? "PASS: zero loss" : "FAIL: lines lost");
+    fflush(stdout);
+    // 受信タスク（スレッド）は終了しないため、そのまま終了する
+    std::_Exit(pass ? EXIT_SUCCESS : EXIT_FAILURE);
+}
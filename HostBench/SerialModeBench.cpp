@@ -0,0 +1,181 @@
+/******************************************************************************
+ * @file       SerialModeBench.cpp
+ * @brief      シリアル受信 ポーリング／イベント駆動 比較（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の SerialReceive を Arduino・FreeRTOS の模擬（HostArduino）の上で動かし、
+ *             同じ行の列をポーリング（1ms 周期）とイベント駆動（UART受信通知）で受信して、
+ *             無通信時と受信中のタスク起床回数[回/s]、受信統計情報（RecvStats）の受信→キュー送信遅延 平均・最大を並べて出力する
+ *             送信側は 115200bps で１行を送り終えた時刻に行全体を UART の模擬に書き込む
+ *             （ESP32 の onReceive は短い行では行末の RX タイムアウトで通知されるため、それに相当する）
+ *             キュー段数・UART受信バッファは、ホストのスケジューリングで受信タスク・受信側が止まっても行を失わない大きさとする
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "SerialReceive.h"
+
+#define BENCH_BAUD              115200      // リンク速度[bps]
+#define BENCH_IDLE_MS           2000        // 無通信時の計測時間[ms]
+#define BENCH_STREAM_MS         3000        // 受信中の計測時間[ms]
+#define BENCH_WAIT_TIMEOUT      100         // 受信側の受信待ち時間[ms]
+#define BENCH_DRAIN_MS          500         // 送信終了後、最後の行を受け取るまでの待ち時間[ms]
+#define BENCH_UART_RX_SIZE      2048        // UART受信バッファサイズ[byte]（setRxBufferSize 相当、ホストのスケジューリングによる停止でも溢れない大きさ）
+
+#define BENCH_QUEUE_NUM         16          // キュー段数（ホストのスケジューリングで受信側が止まってもキューフルにならない段数）
+
+typedef SerialReceive<127, BENCH_QUEUE_NUM> BenchReceive;
+
+struct Run {                                // 評価条件
+    const char                  *name;      // 名前
+    SerialReceiveBase::RECV_MODE mode;      // シリアル受信モード
+    uint32_t                    rate;       // 送信行数[行/s]
+};
+
+struct Result {                             // 評価結果
+    double                      idleWakeups;    // 無通信時のタスク起床回数[回/s]
+    double                      streamWakeups;  // 受信中のタスク起床回数[回/s]
+    uint32_t                    sent;       // 送信行数
+    uint32_t                    received;   // 受信行数
+    uint32_t                    errors;     // 通し番号の戻り・内容の不一致数
+    uint32_t                    overflows;  // UART受信バッファ溢れバイト数
+    SerialReceiveBase::RecvStats stats;     // 受信統計情報
+};
+
+// 行の生成（通し番号と、通し番号で変わる内容）
+static int makeLine(uint32_t index, char *line, size_t size)
+{
+    return snprintf(line, size, "L%05u,%08X,%s\r\n", index, index * 2654435761U, ((index % 7) == 0) ? "tlmrate 500" : "temp");
+}
+
+// 送信側（rate 行/s で、１行を送り終える時刻に行全体を書き込む）
+static void sender(HardwareSerial *uart, uint32_t rate, uint32_t durationMs, uint32_t *sent)
+{
+    char    line[64];
+    auto    start = std::chrono::steady_clock::now();
+    auto    end = start + std::chrono::milliseconds(durationMs);
+
+    for (uint32_t index = 0; ; index++) {
+        int length = makeLine(index, line, sizeof (line));
+        // 行の送信開始時刻（rate で等間隔）に、リンク速度での送信時間を加える
+        auto done = start + std::chrono::microseconds((uint64_t)index * 1000000 / rate) +
+                    std::chrono::microseconds((uint64_t)length * 10 * 1000000 / BENCH_BAUD);
+        if (done > end) {
+            break;
+        }
+        std::this_thread::sleep_until(done);
+        uart->Inject((const uint8_t *)line, length);
+        *sent = index + 1;
+    }
+}
+
+// 受信側（通し番号と内容を検査する）
+static void consumer(BenchReceive *receiver, std::atomic<bool> *done, Result *result)
+{
+    SerialReceiveBase::RecvMsg  msg;
+    char                        expected[64];
+    long                        last = -1;
+
+    while (!done->load()) {
+        if (receiver->ReceiveMsg(&msg, BENCH_WAIT_TIMEOUT) != SerialReceiveBase::RESULT_SUCCESS) {
+            continue;
+        }
+        long index = (msg.data[0] == 'L') ? strtol(msg.data + 1, NULL, 10) : -1;
+        int length = (index >= 0) ? (makeLine((uint32_t)index, expected, sizeof (expected)) - 2) : 0;
+        if ((index <= last) || (msg.length != length) || (memcmp(msg.data, expected, length) != 0)) {
+            result->errors++;
+        }
+        last = index;
+        result->received++;
+        receiver->ReleaseMsg(&msg);
+    }
+}
+
+// 区間のタスク起床回数[回/s]
+static double wakeupRate(uint32_t startWakeups, uint32_t endWakeups, uint32_t startTime, uint32_t endTime)
+{
+    return (double)(endWakeups - startWakeups) * 1e6 / (double)(endTime - startTime);
+}
+
+// 評価（受信開始後、無通信時間を計測してから行を送る）
+static Result bench(const Run &run)
+{
+    HardwareSerial              *uart = new HardwareSerial(BENCH_UART_RX_SIZE);
+    BenchReceive                *receiver = new BenchReceive(SerialReceiveBase::LOG_DISABLED);
+    SerialReceiveBase::RecvStats stats;
+    std::atomic<bool>           done(false);
+    Result                      result = {};
+
+    receiver->SetPort(uart, 0);
+    receiver->Init(false, 0, run.mode);
+    receiver->Start();
+    std::thread receiveThread(consumer, receiver, &done, &result);
+    delay(100);
+
+    // 無通信時
+    receiver->GetRecvStats(&stats);
+    uint32_t wakeups = stats.wakeups;
+    uint32_t time = micros();
+    delay(BENCH_IDLE_MS);
+    receiver->GetRecvStats(&stats);
+    uint32_t now = micros();
+    result.idleWakeups = wakeupRate(wakeups, stats.wakeups, time, now);
+
+    // 受信中
+    wakeups = stats.wakeups;
+    time = now;
+    std::thread sendThread(sender, uart, run.rate, (uint32_t)BENCH_STREAM_MS, &result.sent);
+    sendThread.join();
+    receiver->GetRecvStats(&stats);
+    now = micros();
+    result.streamWakeups = wakeupRate(wakeups, stats.wakeups, time, now);
+
+    // 受信側が最後の行を受け取るまで待つ
+    delay(BENCH_DRAIN_MS);
+    done = true;
+    receiveThread.join();
+    receiver->GetRecvStats(&result.stats);
+    result.overflows = uart->Overflows();
+    // 受信タスク（スレッド）は終了しないため、受信ポート・受信側はそのまま残す
+    return result;
+}
+
+int main()
+{
+    static const Run runs[] = {
+        { "polling 1ms", SerialReceiveBase::RECV_MODE_POLLING,  50 },
+        { "event",       SerialReceiveBase::RECV_MODE_EVENT,    50 },
+        { "polling 1ms", SerialReceiveBase::RECV_MODE_POLLING,  1000 },
+        { "event",       SerialReceiveBase::RECV_MODE_EVENT,    1000 },
+    };
+    Result  results[sizeof (runs) / sizeof (runs[0])];
+    bool    pass = true;
+
+    printf("SerialReceive<127, %d> polling vs event (%dbps, idle %dms, stream %dms)\n", BENCH_QUEUE_NUM, BENCH_BAUD, BENCH_IDLE_MS,
+           BENCH_STREAM_MS);
+    printf("  %-12s %6s  %12s  %12s  %11s  %5s  %14s  %14s\n", "mode", "rate", "idle wake/s", "rx wake/s", "lines", "drops", "latency avg",
+           "latency max");
+    for (size_t i = 0; i < sizeof (runs) / sizeof (runs[0]); i++) {
+        const Run   &run = runs[i];
+        Result      &result = results[i];
+        result = bench(run);
+        printf("  %-12s %4u/s  %12.1f  %12.1f  %5u/%5u  %5u  %11u us  %11u us\n", run.name, run.rate, result.idleWakeups,
+               result.streamWakeups, result.received, result.sent, result.stats.queueFullDrops + result.overflows, result.stats.latencyAvg,
+               result.stats.latencyMax);
+        pass &= (result.received == result.sent) && (result.errors == 0) && (result.stats.queueFullDrops == 0) &&
+                (result.stats.latencyCount == result.sent) && (result.overflows == 0);
+    }
+    // イベント駆動は無通信時に起床しない（受信通知待ちのタイムアウトのみ）
+    pass &= (results[1].idleWakeups < results[0].idleWakeups) && (results[3].idleWakeups < results[2].idleWakeups);
+
+    printf("%s\n", pass ? "PASS: all lines received in both modes" : "FAIL");
+    fflush(stdout);
+    // 受信タスク（スレッド）は終了しないため、そのまま終了する
+    std::_Exit(pass ? EXIT_SUCCESS : EXIT_FAILURE);
+}
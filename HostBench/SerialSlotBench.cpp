@@ -0,0 +1,147 @@
+/******************************************************************************
+ * @file       SerialSlotBench.cpp
+ * @brief      シリアル受信 メッセージスロットプール 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の SerialReceive を Arduino・FreeRTOS の模擬（HostArduino）の上で動かし、
+ *             短い行と最大長の行について、受信タスクから受信側までの１秒あたりのメッセージ数を求める
+ *             受信側はスロット参照（ReceiveMsg・ReleaseMsg）と、呼び出し元バッファへのコピー（GetReceiveData）を比較する
+ *             送信側は UART の受信 FIFO に空きがある分だけ送り（CTS によるハードウェアフロー制御相当）、
+ *             受信側は RTS フロー制御とするため、行は失われない。各行の通し番号と長さで欠落・順序を検査する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "SerialReceive.h"
+
+#define BENCH_LINE_MAX          127         // 最大メッセージ長[byte]（M5AtomSat の SERIAL_RECV_LINE_MAX）
+#define BENCH_QUEUE_NUM         4           // キュー段数（M5AtomSat の SERIAL_RECV_QUEUE_NUM）
+#define BENCH_SHORT_LINES       200000      // 短い行の行数
+#define BENCH_LONG_LINES        50000       // 最大長の行の行数
+#define BENCH_TIMEOUT           2000        // 受信終了判定の無受信時間[ms]
+#define BENCH_RTS_PIN           26          // RTS 端子番号（模擬）
+
+typedef SerialReceive<BENCH_LINE_MAX, BENCH_QUEUE_NUM> BenchReceive;
+
+struct Run {                                // 評価条件
+    const char              *name;          // 名前
+    uint32_t                lines;          // 行数
+    int                     length;         // 行の長さ[byte]（CR/LF を含まない）
+    bool                    copy;           // true=GetReceiveData（コピー） false=ReceiveMsg（スロット参照）
+};
+
+// 行の生成（先頭に通し番号、残りを埋めて length バイトにする）
+static int makeLine(uint32_t index, int length, char *line)
+{
+    int count = snprintf(line, BENCH_LINE_MAX + 3, "%u", index);
+    for (int i = count; i < length; i++) {
+        line[i] = (char)('a' + ((index + i) % 26));
+    }
+    if (length > count) {
+        count = length;
+    }
+    line[count++] = '\r';
+    line[count++] = '\n';
+    return count;
+}
+
+// 送信側（受信 FIFO に空きがある分だけ１行ずつ送る）
+static void sender(HardwareSerial *uart, const Run *run)
+{
+    char    line[BENCH_LINE_MAX + 3];
+
+    for (uint32_t index = 0; index < run->lines; index++) {
+        int length = makeLine(index, run->length, line);
+        while ((uart->available() + length) > HOST_UART_RX_SIZE) {
+            std::this_thread::yield();
+        }
+        uart->Inject((const uint8_t *)line, length);
+    }
+}
+
+// 評価
+static bool bench(const Run &run)
+{
+    HardwareSerial              *uart = new HardwareSerial();
+    BenchReceive                *receiver = new BenchReceive(SerialReceiveBase::LOG_DISABLED);
+    SerialReceiveBase::RecvMsg  msg;
+    SerialReceiveBase::RecvStats stats;
+    char                        data[BenchReceive::SLOT_SIZE];
+    uint32_t                    received = 0;
+    uint32_t                    errors = 0;
+    uint64_t                    bytes = 0;
+
+    receiver->SetPort(uart, 0);
+    receiver->SetFlowControl(SerialReceiveBase::FLOW_CONTROL_RTS, SERIAL_RECEIVE_FLOW_HIGH_DEFAULT, SERIAL_RECEIVE_FLOW_LOW_DEFAULT,
+                             BENCH_RTS_PIN);
+    receiver->Init(false, 0, SerialReceiveBase::RECV_MODE_EVENT);
+    receiver->Start();
+    delay(10);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread thread(sender, uart, &run);
+    while (received < run.lines) {
+        const char  *text;
+        int         length;
+        if (run.copy) {
+            // 呼び出し元バッファへのコピー
+            if (receiver->GetReceiveData(data, BENCH_TIMEOUT) != SerialReceiveBase::RESULT_SUCCESS) {
+                break;
+            }
+            text = data;
+            length = (int)strlen(data);
+        }
+        else {
+            // スロット参照（検査後に解放する）
+            if (receiver->ReceiveMsg(&msg, BENCH_TIMEOUT) != SerialReceiveBase::RESULT_SUCCESS) {
+                break;
+            }
+            text = msg.data;
+            length = msg.length;
+        }
+        // 通し番号と長さの検査
+        if ((strtoul(text, NULL, 10) != received) || (length != run.length)) {
+            errors++;
+        }
+        bytes += length;
+        received++;
+        if (!run.copy) {
+            receiver->ReleaseMsg(&msg);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    thread.join();
+
+    receiver->GetRecvStats(&stats);
+    printf("  %-22s %6u/%u lines  %4d B/line  %8.0f msg/s  %6.2f MB/s  errors %u  queue drops %u  stalls %u  wakeups %u\n",
+           run.name, received, run.lines, run.length, received / seconds, bytes / seconds / 1e6, errors, stats.queueFullDrops,
+           stats.flowStalls, stats.wakeups);
+    return (received == run.lines) && (errors == 0) && (stats.queueFullDrops == 0) && (uart->Overflows() == 0);
+}
+
+int main()
+{
+    static const Run runs[] = {
+        { "short  ReceiveMsg",      BENCH_SHORT_LINES,  6,              false },
+        { "short  GetReceiveData",  BENCH_SHORT_LINES,  6,              true  },
+        { "max    ReceiveMsg",      BENCH_LONG_LINES,   BENCH_LINE_MAX, false },
+        { "max    GetReceiveData",  BENCH_LONG_LINES,   BENCH_LINE_MAX, true  },
+    };
+    bool pass = true;
+
+    printf("SerialReceive<%d, %d> slot pool (event mode, rts flow control)\n", BENCH_LINE_MAX, BENCH_QUEUE_NUM);
+    for (const Run &run : runs) {
+        pass &= bench(run);
+    }
+
+    printf("%s\n", pass ? "PASS: zero loss" : "FAIL: lines lost");
+    fflush(stdout);
+    // 受信タスク（スレッド）は終了しないため、そのまま終了する
+    std::_Exit(pass ? EXIT_SUCCESS : EXIT_FAILURE);
+}
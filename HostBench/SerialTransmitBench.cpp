@@ -0,0 +1,230 @@
+/******************************************************************************
+ * @file       SerialTransmitBench.cpp
+ * @brief      シリアル送信 複数投入リング 負荷試験（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の SerialTransmit を Arduino・FreeRTOS の模擬（HostArduino）の上で動かし、
+ *             複数の std::thread から同時に write・WriteLine・printf で投入して、ロックなしのリング（複数投入・単一出力）を検査する
+ *               ・投入できたメッセージはすべて、他のメッセージと混ざらず（複数レコードに分割したものも連続して）出力されること
+ *               ・投入側毎のメッセージの順序が保たれること、投入できなかったメッセージは出力されないこと
+ *               ・投入レコード数・破棄レコード数・送信バイト数の統計が、投入側で数えた値と一致すること
+ *             また投入１回あたりの時間を求める
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SerialTransmit.h"
+
+#define BENCH_PRODUCERS         8           // 投入スレッド数
+#define BENCH_MESSAGES          100000      // 投入スレッドあたりのメッセージ数
+#define BENCH_PAYLOAD_MAX       300         // メッセージ本体の最大長[byte]
+#define BENCH_DRAIN_TIMEOUT     10000       // 出力完了待ちの上限[ms]
+
+// 送信先（送信タスクが出力したバイトを蓄える）
+class Sink : public Print
+{
+public:
+    size_t write(uint8_t data) override { return write(&data, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _data.append((const char *)buffer, size);
+        return size;
+    }
+    std::string Take()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::string data;
+        data.swap(_data);
+        return data;
+    }
+
+private:
+    std::mutex                  _mutex;         // 蓄積データの排他
+    std::string                 _data;          // 蓄積データ
+};
+
+struct Producer {                               // 投入スレッド
+    uint32_t                    id;             // 番号
+    std::vector<bool>           accepted;       // メッセージ毎の投入結果
+    uint64_t                    records;        // 投入できたレコード数
+    uint64_t                    dropRecords;    // 投入できなかったレコード数
+    uint64_t                    bytes;          // 投入できたバイト数
+    double                      seconds;        // 投入にかかった時間[秒]
+};
+
+// メッセージ本体の生成（番号・通し番号と、それで決まる長さ・内容）
+static std::string makeBody(uint32_t id, uint32_t seq)
+{
+    char        head[32];
+    uint32_t    hash = (id * 2654435761U) ^ (seq * 40503U);
+    size_t      length = hash % BENCH_PAYLOAD_MAX;
+    std::string body(head, snprintf(head, sizeof (head), "P%u:%u:", id, seq));
+    for (size_t i = 0; i < length; i++) {
+        body += (char)('A' + ((hash + i) % 26));
+    }
+    return body;
+}
+
+// 投入スレッド（write・WriteLine・printf を順に使う）
+template <class Transmit>
+static void produce(Transmit *transmitter, Producer *producer, uint32_t recordSize)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t seq = 0; seq < BENCH_MESSAGES; seq++) {
+        std::string body = makeBody(producer->id, seq);
+        size_t      total = body.size() + 2;
+        bool        ok;
+        switch (seq % 3) {
+        case 0:
+            ok = transmitter->WriteLine(body.c_str());
+            break;
+        case 1:
+            body += "\r\n";
+            ok = (transmitter->write((const uint8_t *)body.data(), body.size()) == body.size());
+            break;
+        default:
+            ok = (transmitter->printf("%s\r\n", body.c_str()) == total);
+            break;
+        }
+        uint64_t records = (total + recordSize - 1) / recordSize;
+        producer->accepted[seq] = ok;
+        if (ok) {
+            producer->records += records;
+            producer->bytes += total;
+        }
+        else {
+            producer->dropRecords += records;
+        }
+    }
+    producer->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 評価
+template <size_t RecordSize, size_t Depth>
+static bool bench(const char *title)
+{
+    SerialTransmit<RecordSize, Depth>   *transmitter = new SerialTransmit<RecordSize, Depth>();
+    Sink                                *sink = new Sink();
+    Producer                            producers[BENCH_PRODUCERS];
+    std::thread                         threads[BENCH_PRODUCERS];
+    uint64_t                            records = 0;
+    uint64_t                            dropRecords = 0;
+    uint64_t                            bytes = 0;
+    uint64_t                            accepted = 0;
+    double                              seconds = 0.0;
+
+    transmitter->SetPort(sink);
+    transmitter->Start();
+    delay(10);
+
+    for (uint32_t i = 0; i < BENCH_PRODUCERS; i++) {
+        producers[i].id = i;
+        producers[i].accepted.assign(BENCH_MESSAGES, false);
+        producers[i].records = 0;
+        producers[i].dropRecords = 0;
+        producers[i].bytes = 0;
+        threads[i] = std::thread(produce<SerialTransmit<RecordSize, Depth>>, transmitter, &producers[i], (uint32_t)RecordSize);
+    }
+    for (uint32_t i = 0; i < BENCH_PRODUCERS; i++) {
+        threads[i].join();
+        records += producers[i].records;
+        dropRecords += producers[i].dropRecords;
+        bytes += producers[i].bytes;
+        seconds += producers[i].seconds;
+        for (bool ok : producers[i].accepted) {
+            accepted += ok ? 1 : 0;
+        }
+    }
+
+    // 送信タスクがすべて出力するまで待つ
+    SerialTransmitBase::TxStats stats;
+    uint32_t waited = 0;
+    do {
+        delay(1);
+        transmitter->GetTxStats(&stats);
+    } while (((stats.queued != 0) || (stats.bytes != (uint32_t)bytes)) && (++waited < BENCH_DRAIN_TIMEOUT));
+
+    // 出力の検査（行毎に、内容・投入側毎の順序・投入結果との一致）
+    std::string             output = sink->Take();
+    std::vector<uint32_t>   next(BENCH_PRODUCERS, 0);   // 投入側毎の次に期待する通し番号の下限
+    uint64_t                lines = 0;
+    uint64_t                corrupted = 0;
+    uint64_t                orderErrors = 0;
+    uint64_t                unexpected = 0;
+    uint64_t                missing = 0;
+    size_t                  pos = 0;
+    while (pos < output.size()) {
+        size_t end = output.find("\r\n", pos);
+        if (end == std::string::npos) {
+            corrupted++;
+            break;
+        }
+        std::string line = output.substr(pos, end - pos);
+        pos = end + 2;
+        lines++;
+        unsigned id, seq;
+        if ((sscanf(line.c_str(), "P%u:%u:", &id, &seq) != 2) || (id >= BENCH_PRODUCERS) || (seq >= BENCH_MESSAGES) ||
+            (line != makeBody(id, seq))) {
+            // 他のメッセージと混ざった、または内容が壊れた
+            corrupted++;
+            continue;
+        }
+        if (!producers[id].accepted[seq]) {
+            // 投入できなかったメッセージが出力された
+            unexpected++;
+        }
+        if (seq < next[id]) {
+            // 投入側の順序と違う（または重複）
+            orderErrors++;
+        }
+        else {
+            // 間の投入できたメッセージが出力されていない
+            for (uint32_t skipped = next[id]; skipped < seq; skipped++) {
+                missing += producers[id].accepted[skipped] ? 1 : 0;
+            }
+            next[id] = seq + 1;
+        }
+    }
+    for (uint32_t id = 0; id < BENCH_PRODUCERS; id++) {
+        for (uint32_t skipped = next[id]; skipped < BENCH_MESSAGES; skipped++) {
+            missing += producers[id].accepted[skipped] ? 1 : 0;
+        }
+    }
+    bool statsOk = (stats.records == (uint32_t)records) && (stats.drops == (uint32_t)dropRecords) && (stats.bytes == (uint32_t)bytes) &&
+                   (output.size() == bytes);
+
+    printf("%s\n", title);
+    printf("  %d threads x %d messages  accepted %llu  lines out %llu  corrupted %llu  order %llu  unexpected %llu  missing %llu\n",
+           BENCH_PRODUCERS, BENCH_MESSAGES, (unsigned long long)accepted, (unsigned long long)lines, (unsigned long long)corrupted,
+           (unsigned long long)orderErrors, (unsigned long long)unexpected, (unsigned long long)missing);
+    printf("  stats records %u/%llu  drops %u/%llu  bytes %u/%llu  max queued %u/%u  %s  enqueue %.0f ns/message\n", stats.records,
+           (unsigned long long)records, stats.drops, (unsigned long long)dropRecords, stats.bytes, (unsigned long long)bytes,
+           stats.highWater, stats.depth, statsOk ? "match" : "MISMATCH", seconds / BENCH_PRODUCERS / BENCH_MESSAGES * 1e9);
+    return (lines == accepted) && (corrupted == 0) && (orderErrors == 0) && (unexpected == 0) && (missing == 0) && statsOk;
+}
+
+int main()
+{
+    bool pass = true;
+
+    // M5AtomSat と同じ構成（128バイト×32、長いメッセージは最大 3レコード）
+    pass &= bench<128, 32>("SerialTransmit<128, 32> (M5AtomSat)");
+    // 小さいレコード（長いメッセージは最大 20レコード、リングが頻繁に一周する）
+    pass &= bench<16, 64>("SerialTransmit<16, 64> (multi-record messages)");
+    // 最小構成（ほとんどのメッセージが全レコードを使う・入らない）
+    pass &= bench<64, 8>("SerialTransmit<64, 8> (small ring)");
+
+    printf("%s\n", pass ? "PASS: no interleaving, order kept, stats match" : "FAIL");
+    fflush(stdout);
+    // 送信タスク（スレッド）は終了しないため、そのまま終了する
+    std::_Exit(pass ? EXIT_SUCCESS : EXIT_FAILURE);
+}
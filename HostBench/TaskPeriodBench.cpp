@@ -0,0 +1,81 @@
+/******************************************************************************
+ * @file       TaskPeriodBench.cpp
+ * @brief      タスク周期実行 周期超過判定 試験（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の TaskPeriod を FreeRTOS の模擬（HostArduino、1tick = 1ms）の上で動かし、
+ *             tick を手動で進めて（HostSetManualTick）、各周期の処理で起床予定時刻から決まった tick 数だけ進め、
+ *             Wait の戻り値・起床した tick・周期超過回数・飛ばした起床予定時刻の数を検査する
+ *             （実時間の tick ではホストのスケジューリングで起床が遅れ、ちょうど起床予定時刻に終わる処理を作れないため）
+ *               ・処理がちょうど１周期（次の起床予定時刻の tick に終わる）: 周期超過ではなく、待たずに次の起床予定時刻に起床する
+ *               ・処理が１周期＋1tick : 周期超過、起床予定時刻を１つ飛ばす
+ *               ・処理がちょうど２周期 : 周期超過、起床予定時刻を１つ飛ばし、２つ目の起床予定時刻に遅れずに起床する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "TaskPeriod.h"
+
+#define BENCH_PERIOD_MS         10          // 周期[ms]
+#define BENCH_CYCLES            100         // 起床回数
+
+struct Case {                               // 試験条件
+    const char              *name;          // 名前
+    uint32_t                workTicks;      // 起床予定時刻からの処理時間[tick]
+    uint32_t                periods;        // 期待する Wait の戻り値（進んだ周期数）
+    bool                    overrun;        // 期待する周期超過
+};
+
+// 試験（起床予定時刻から workTicks 後の tick まで処理し、Wait する）
+static bool test(const Case &c)
+{
+    TaskPeriod          period;
+    TaskPeriod::Stats   stats;
+    uint32_t            wrongPeriods = 0;   // Wait の戻り値の不一致数
+    uint32_t            wrongWakes = 0;     // 起床した tick の不一致数
+
+    HostSetManualTick(true, 1000);
+    period.Start(BENCH_PERIOD_MS);
+    TickType_t wake = xTaskGetTickCount();  // 起床予定時刻[tick]
+
+    for (int cycle = 0; cycle < BENCH_CYCLES; cycle++) {
+        // 処理（起床予定時刻から workTicks 後の tick まで進める）
+        HostAdvanceTick(wake + c.workTicks - xTaskGetTickCount());
+        uint32_t periods = period.Wait();
+        wake += periods * pdMS_TO_TICKS(BENCH_PERIOD_MS);
+        wrongPeriods += (periods == c.periods) ? 0 : 1;
+        wrongWakes += (xTaskGetTickCount() == wake) ? 0 : 1;
+    }
+    period.GetStats(&stats);
+    HostSetManualTick(false);
+
+    uint32_t overruns = c.overrun ? BENCH_CYCLES : 0;
+    uint32_t skipped = overruns * (c.periods - 1);
+    bool pass = (wrongPeriods == 0) && (wrongWakes == 0) && (stats.overruns == overruns) && (stats.skipped == skipped);
+    printf("  %-22s work %2u ticks  periods %u  cycles %3u  overruns %3u/%3u  skipped %3u/%3u  wrong periods %u  wrong wakes %u  %s\n",
+           c.name, c.workTicks, c.periods, stats.cycles, stats.overruns, overruns, stats.skipped, skipped, wrongPeriods, wrongWakes,
+           pass ? "ok" : "NG");
+    return pass;
+}
+
+int main()
+{
+    static const Case cases[] = {
+        { "within period",          BENCH_PERIOD_MS / 2,    1, false },
+        { "exactly one period",     BENCH_PERIOD_MS,        1, false },
+        { "one period + 1 tick",    BENCH_PERIOD_MS + 1,    2, true  },
+        { "exactly two periods",    BENCH_PERIOD_MS * 2,    2, true  },
+    };
+    bool pass = true;
+
+    printf("TaskPeriod %dms (1 tick = %dms)\n", BENCH_PERIOD_MS, portTICK_PERIOD_MS);
+    for (const Case &c : cases) {
+        pass &= test(c);
+    }
+
+    printf("%s\n", pass ? "PASS: overrun only when the next wake time has passed" : "FAIL");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * @file       TelemetryDeltaBench.cpp
+ * @brief      差分圧縮テレメトリ 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の TelemetryDeltaEncoder・TelemetryDeltaDecoder を IMU の姿勢のトレースで評価する
+ *             実機で記録したトレースはないため、AttitudeFilterBench と同じ模擬軌道（真の姿勢から生成したジャイロ・加速度に
+ *             バイアス・雑音・振動を加えたもの）を AttitudeFilter に 1kHz で入力し、その出力の姿勢をトレースとして合成する
+ *             内部温度（緩やかな上昇と雑音）、カウンタ（まれに増加）、姿勢区間統計（前回出力からの Pitch, Roll の統計）も合成する
+ *             各トレースをキーフレーム間隔 32 フレーム（M5AtomSat の既定値）で符号化し、チャネル別フレームとの圧縮率と、
+ *             符号化・復号の１フレームあたりの時間を求める。また復号した値がすべて元の値と一致することを検査する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "AttitudeFilter.h"
+#include "TelemetryDelta.h"
+
+#define BENCH_IMU_RATE          1000        // 姿勢推定の更新周波数[Hz]（FIFO 一括取得のサンプリング周波数）
+#define BENCH_TLM_RATE          10          // テレメトリ出力周波数[Hz]（最も速いチャネル）
+#define BENCH_DURATION          600         // トレースの長さ[秒]
+#define BENCH_STILL_TIME        2.0         // 開始時の静止時間[秒]（ジャイロバイアス推定）
+#define BENCH_KEY_INTERVAL      32          // キーフレーム間隔[フレーム]（M5AtomSat の TLM_DELTA_KEY_INTERVAL）
+#define BENCH_TIMING_FRAMES     1000000     // 時間計測のフレーム数
+
+static const double RAD = M_PI / 180.0;     // 度 → ラジアン
+
+struct Scenario {                           // 模擬軌道
+    const char              *name;          // 名前
+    double                  amplitude[3];   // 角速度の振幅[度/秒]（X, Y, Z）
+    double                  frequency[3];   // 角速度の周波数[Hz]
+    double                  yawRate;        // Z 軸の一定角速度[度/秒]
+    double                  vibration;      // 振動加速度の振幅[G]
+    double                  vibrationHz;    // 振動の周波数[Hz]
+};
+
+struct Rates {                              // チャネル毎の出力間隔[フレーム]（0 は出力しない）
+    const char              *name;          // 名前
+    uint32_t                every[TLM_CHANNEL_NUM]; // 出力間隔
+};
+
+struct Frame {                              // トレースの１フレーム
+    TelemetrySample         sample;         // テレメトリサンプル
+    TelemetryCounters       counters;       // テレメトリカウンタ・姿勢区間統計
+    uint8_t                 mask;           // 出力時刻に達したチャネル
+};
+
+struct Interval {                           // 姿勢区間統計の集計
+    uint32_t                count;          // サンプル数
+    double                  min;            // 最小
+    double                  max;            // 最大
+    double                  sum;            // 合計
+    double                  sum2;           // ２乗和
+
+    void Clear() { count = 0; min = INFINITY; max = -INFINITY; sum = 0.0; sum2 = 0.0; }
+    void Add(double value)
+    {
+        count++;
+        min = fmin(min, value);
+        max = fmax(max, value);
+        sum += value;
+        sum2 += value * value;
+    }
+    double Mean() const { return (count > 0) ? (sum / count) : 0.0; }
+    double Variance() const { return (count > 0) ? fmax(0.0, sum2 / count - Mean() * Mean()) : 0.0; }
+};
+
+// クォータニオンの重力方向（機体座標）
+static void gravityOf(const double *q, double *gravity)
+{
+    gravity[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    gravity[1] = 2 * (q[0] * q[1] + q[2] * q[3]);
+    gravity[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+// トレースの合成（模擬軌道を姿勢推定フィルタに入力し、テレメトリ出力周波数で値を取り出す）
+static std::vector<Frame> generate(const Scenario &sc, const Rates &rates, unsigned seed)
+{
+    std::mt19937                    rng(seed);
+    std::normal_distribution<double> gyroNoise(0.0, 0.1);   // ジャイロ雑音[度/秒]
+    std::normal_distribution<double> accelNoise(0.0, 0.01); // 加速度雑音[G]
+    std::normal_distribution<double> tempNoise(0.0, 0.05);  // 温度雑音[℃]
+    std::uniform_real_distribution<double> event(0.0, 1.0);
+    const double    bias[3] = { 1.5, -0.8, 0.6 };           // ジャイロバイアス[度/秒]
+    const double    dt = 1.0 / BENCH_IMU_RATE;
+    double          q[4];                                   // 真の姿勢（機体座標 → 基準座標）
+    AttitudeFilter  filter;
+    Interval        pitchStats;
+    Interval        rollStats;
+    TelemetryCounters counters = {};
+    std::vector<Frame> out;
+
+    // 初期姿勢 ピッチ 10 度、ロール -20 度
+    double cr = cos(-20.0 * RAD / 2), sr = sin(-20.0 * RAD / 2), cp = cos(10.0 * RAD / 2), sp = sin(10.0 * RAD / 2);
+    q[0] = cr * cp; q[1] = sr * cp; q[2] = cr * sp; q[3] = -sr * sp;
+    pitchStats.Clear();
+    rollStats.Clear();
+
+    for (long n = 0; n < (long)BENCH_DURATION * BENCH_IMU_RATE; n++) {
+        double  t = n * dt;
+        double  w[3] = { 0.0, 0.0, 0.0 };   // 角速度[rad/s]
+        if (t >= BENCH_STILL_TIME) {
+            for (int axis = 0; axis < 3; axis++) {
+                w[axis] = sc.amplitude[axis] * sin(2 * M_PI * sc.frequency[axis] * (t - BENCH_STILL_TIME)) * RAD;
+            }
+            w[2] += sc.yawRate * RAD;
+        }
+        double h = 0.5 * dt;
+        double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+        q[0] += h * (-q1 * w[0] - q2 * w[1] - q3 * w[2]);
+        q[1] += h * (q0 * w[0] + q2 * w[2] - q3 * w[1]);
+        q[2] += h * (q0 * w[1] - q1 * w[2] + q3 * w[0]);
+        q[3] += h * (q0 * w[2] + q1 * w[1] - q2 * w[0]);
+        double norm = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        for (int index = 0; index < 4; index++) {
+            q[index] /= norm;
+        }
+
+        // 模擬センサ出力を姿勢推定フィルタに入力する
+        double gv[3];
+        gravityOf(q, gv);
+        double vib = sc.vibration * sin(2 * M_PI * sc.vibrationHz * t);
+        double vibAxis[3] = { 0.6, 0.48, 0.64 };
+        float g[3], a[3];
+        for (int axis = 0; axis < 3; axis++) {
+            g[axis] = (float)(w[axis] / RAD + bias[axis] + gyroNoise(rng));
+            a[axis] = (float)(gv[axis] + vib * vibAxis[axis] + accelNoise(rng));
+        }
+        filter.Update(g[0], g[1], g[2], a[0], a[1], a[2], (float)dt);
+        float pitch, roll, yaw;
+        filter.GetEuler(&pitch, &roll, &yaw);
+        pitchStats.Add(pitch);
+        rollStats.Add(roll);
+
+        if (((n + 1) % (BENCH_IMU_RATE / BENCH_TLM_RATE)) != 0) {
+            continue;
+        }
+
+        // テレメトリ出力
+        Frame   frame;
+        uint32_t index = (uint32_t)out.size();
+        frame.mask = 0;
+        for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+            if ((rates.every[ch] != 0) && ((index % rates.every[ch]) == 0)) {
+                frame.mask |= TLM_CHANNEL_BIT(ch);
+            }
+        }
+        frame.sample.counter = index;
+        frame.sample.missionTime = (uint32_t)((n + 1) / BENCH_IMU_RATE);
+        frame.sample.pitch = TelemetryToCenti(pitch);
+        frame.sample.roll = TelemetryToCenti(roll);
+        frame.sample.yaw = TelemetryToCenti(yaw);
+        frame.sample.temp = TelemetryToCenti((float)(38.0 + 4.0 * (1.0 - exp(-t / 300.0)) + tempNoise(rng)));
+        // コマンド実行はまれ（平均 30 秒に１回）、送信破棄はさらにまれ
+        counters.commands += (event(rng) < (1.0 / (30.0 * BENCH_TLM_RATE))) ? 1 : 0;
+        counters.txDrops += (event(rng) < (1.0 / (600.0 * BENCH_TLM_RATE))) ? 1 : 0;
+        if ((frame.mask & TLM_CHANNEL_BIT(TLM_CHANNEL_ATT_STATS)) != 0) {
+            // 前回出力からの姿勢区間統計
+            counters.attSamples = pitchStats.count;
+            counters.pitchMin = TelemetryToCenti((float)pitchStats.min);
+            counters.pitchMax = TelemetryToCenti((float)pitchStats.max);
+            counters.pitchMean = TelemetryToCenti((float)pitchStats.Mean());
+            counters.pitchVar = TelemetryToCenti32((float)pitchStats.Variance());
+            counters.rollMin = TelemetryToCenti((float)rollStats.min);
+            counters.rollMax = TelemetryToCenti((float)rollStats.max);
+            counters.rollMean = TelemetryToCenti((float)rollStats.Mean());
+            counters.rollVar = TelemetryToCenti32((float)rollStats.Variance());
+            pitchStats.Clear();
+            rollStats.Clear();
+        }
+        frame.counters = counters;
+        out.push_back(frame);
+    }
+    return out;
+}
+
+// 復号した値の検査（全フレームに格納する項目と、出力したチャネルの項目が一致すること）
+static bool matches(const Frame &frame, const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask)
+{
+    if (mask != frame.mask) {
+        return false;
+    }
+    for (size_t field = 0; field < TLM_FIELD_NUM; field++) {
+        if (TelemetryFieldSelected(field, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | frame.mask) &&
+            (TelemetryFields[field].get(sample, counters) != TelemetryFields[field].get(frame.sample, frame.counters))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 評価（符号化・復号・検査と時間計測）
+static bool evaluate(const Scenario &sc, const Rates &rates)
+{
+    std::vector<Frame>      trace = generate(sc, rates, 1);
+    std::vector<uint8_t>    stream(trace.size() * TLM_DELTA_SIZE_MAX);
+    std::vector<uint32_t>   sizes(trace.size());
+    TelemetryDeltaEncoder   encoder(BENCH_KEY_INTERVAL);
+    TelemetryDeltaDecoder   decoder;
+    TelemetryDeltaEncoder::Stats stats;
+    size_t                  total = 0;
+    uint32_t                errors = 0;
+
+    // 符号化
+    for (size_t i = 0; i < trace.size(); i++) {
+        sizes[i] = (uint32_t)encoder.Encode(trace[i].sample, trace[i].counters, trace[i].mask, &stream[total], TLM_DELTA_SIZE_MAX);
+        total += sizes[i];
+    }
+    encoder.GetStats(&stats);
+
+    // 復号・検査
+    size_t offset = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        TelemetrySample     sample;
+        TelemetryCounters   counters;
+        uint8_t             mask;
+        size_t              frameSize;
+        TelemetryDeltaDecoder::RESULT result = decoder.Decode(&stream[offset], total - offset, &frameSize, &sample, &counters, &mask);
+        if ((result != TelemetryDeltaDecoder::RESULT_SUCCESS) || (frameSize != sizes[i]) || !matches(trace[i], sample, counters, mask)) {
+            errors++;
+            if (result != TelemetryDeltaDecoder::RESULT_SUCCESS) {
+                break;
+            }
+        }
+        offset += frameSize;
+    }
+
+    // 符号化時間（トレースを繰り返し符号化する）
+    uint8_t     frame[TLM_DELTA_SIZE_MAX];
+    uint64_t    checksum = 0;
+    TelemetryDeltaEncoder timingEncoder(BENCH_KEY_INTERVAL);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_TIMING_FRAMES; i++) {
+        const Frame &f = trace[i % trace.size()];
+        checksum += timingEncoder.Encode(f.sample, f.counters, f.mask, frame, sizeof (frame));
+    }
+    double encodeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_TIMING_FRAMES;
+
+    // 復号時間（符号化したトレースを繰り返し復号する）
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < (BENCH_TIMING_FRAMES / (int)trace.size()) + 1; pass++) {
+        TelemetryDeltaDecoder   timingDecoder;
+        TelemetrySample         sample;
+        TelemetryCounters       counters;
+        uint8_t                 mask;
+        size_t                  frameSize;
+        for (offset = 0; offset < total; offset += frameSize) {
+            timingDecoder.Decode(&stream[offset], total - offset, &frameSize, &sample, &counters, &mask);
+            checksum += mask;
+        }
+    }
+    int decoded = ((BENCH_TIMING_FRAMES / (int)trace.size()) + 1) * (int)trace.size();
+    double decodeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / decoded;
+
+    printf("%-15s %-6s frames %5u  key %3u  channel frames %7u B  delta %6u B  %5.2f B/frame  ratio %5.2f"
+           "  encode %5.1f ns  decode %5.1f ns  errors %u  [%llu]\n",
+           sc.name, rates.name, stats.frames, stats.keyframes, stats.rawBytes, stats.encodedBytes,
+           (double)stats.encodedBytes / stats.frames, (double)stats.rawBytes / stats.encodedBytes, encodeNs, decodeNs, errors,
+           (unsigned long long)checksum);
+    return (errors == 0) && (total == stats.encodedBytes);
+}
+
+int main()
+{
+    static const Scenario scenarios[] = {
+        // 名前              角速度振幅[度/秒]  周波数[Hz]          Yaw[度/秒] 振動[G] 振動[Hz]
+        { "still+vibration", {  0,  0,  0 },  { 0.0, 0.0, 0.0 },    0.0,  0.3,  37.0 },
+        { "slow tilt",       { 20, 30, 10 },  { 0.10, 0.07, 0.05 }, 5.0,  0.0,   0.0 },
+        { "fast maneuver",   { 150, 120, 90 }, { 0.5, 0.4, 0.3 },   20.0, 0.1,  23.0 },
+    };
+    static const Rates rates[] = {
+        // 名前      時刻 姿勢 温度 カウンタ 姿勢区間統計（出力間隔[フレーム]、1フレーム=0.1秒）
+        { "all",    { 1, 1, 1, 1, 1 } },
+        { "mixed",  { 10, 1, 10, 50, 10 } },
+    };
+    bool pass = true;
+
+    printf("synthetic IMU traces (%d s, filter %d Hz, telemetry %d Hz, key interval %d)\n", BENCH_DURATION, BENCH_IMU_RATE,
+           BENCH_TLM_RATE, BENCH_KEY_INTERVAL);
+    for (const Scenario &sc : scenarios) {
+        for (const Rates &rate : rates) {
+            pass &= evaluate(sc, rate);
+        }
+    }
+
+    printf("%s\n", pass ? "PASS: all frames decoded to the original values" : "FAIL: decoded values differ");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
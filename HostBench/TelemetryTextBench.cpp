@@ -0,0 +1,209 @@
+/******************************************************************************
+ * @file       TelemetryTextBench.cpp
+ * @brief      テレメトリ文字列生成 評価（ホスト）
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    M5AtomSat の TelemetryText の出力を、従来の sprintf("%6.2f") の出力とバイト単位で比較する（ゴールデン出力試験）
+ *               ・固定小数点の全 int16 の値（TelemetryFormatCenti と sprintf("%6.2f", centi / 100.0)）
+ *               ・実数の値（TelemetryFormatFloat と sprintf("%6.2f", float)）
+ *                 0.01 単位の各値と丸めの境界（x.xx5）の前後の float、ランダムな全ビットパターン（NaN・無限大・非正規化数を含む）
+ *               ・テレメトリ文字列（TelemetryFormatTextValues と従来の setTelemetryMsg の sprintf）
+ *             また１行の生成時間を sprintf と比較する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "TelemetryText.h"
+
+#define BENCH_BOUNDARY_CENTI    2000000     // 丸めの境界を調べる範囲[0.01単位]（±20000.00）
+#define BENCH_RANDOM_FLOATS     20000000    // ランダムなビットパターンの数
+#define BENCH_RANDOM_LINES      2000000     // ランダムなテレメトリ文字列の数
+#define BENCH_LINES             1000000     // 生成時間の計測行数
+#define BENCH_CENTI32_LIMIT     21474836.47 // 飽和せずに変換できる絶対値の上限
+
+struct Result {                             // 比較結果
+    uint64_t        checked;                // 比較した数
+    uint64_t        mismatches;             // 不一致の数
+    uint64_t        skipped;                // 飽和する範囲のため比較しなかった数
+};
+
+// 不一致の表示（最初の数件）
+static void report(Result *result, const char *what, const char *expected, const char *actual)
+{
+    if (result->mismatches++ < 5) {
+        printf("  mismatch %s: expected \"%s\" actual \"%s\"\n", what, expected, actual);
+    }
+}
+
+// 実数１つの比較
+static void checkFloat(float value, Result *result)
+{
+    char    expected[64];
+    char    actual[64];
+
+    if (isfinite(value) && (fabs((double)value) > BENCH_CENTI32_LIMIT)) {
+        // 32 ビットの固定小数点の範囲外（飽和する）
+        result->skipped++;
+        return;
+    }
+    snprintf(expected, sizeof (expected), "%6.2f", value);
+    *TelemetryFormatFloat(actual, value) = '\0';
+    result->checked++;
+    if (strcmp(expected, actual) != 0) {
+        char what[32];
+        snprintf(what, sizeof (what), "float %a", value);
+        report(result, what, expected, actual);
+    }
+}
+
+// テレメトリ文字列１行の比較
+static void checkLine(int counter, uint32_t runTime, float pitch, float roll, float yaw, float temp, Result *result)
+{
+    char    expected[128];
+    char    actual[TLM_TEXT_VALUES_SIZE_MAX];
+
+    // 従来の setTelemetryMsg
+    int hour = runTime / 3600;
+    int min  = (runTime - (hour * 3600)) / 60;
+    int sec  = runTime % 60;
+    snprintf(expected, sizeof (expected), "TLM, %d, %02d:%02d:%02d, %6.2f, %6.2f, %6.2f, %6.2f", counter, hour, min, sec, pitch, roll, yaw, temp);
+
+    size_t length = TelemetryFormatTextValues(counter, runTime, pitch, roll, yaw, temp, actual, sizeof (actual));
+    result->checked++;
+    if ((length != strlen(expected)) || (strcmp(expected, actual) != 0)) {
+        report(result, "line", expected, actual);
+    }
+}
+
+// 結果表示
+static bool summary(const char *name, const Result &result)
+{
+    printf("%-34s checked %10llu  mismatches %llu", name, (unsigned long long)result.checked, (unsigned long long)result.mismatches);
+    if (result.skipped > 0) {
+        printf("  (saturated, not compared %llu)", (unsigned long long)result.skipped);
+    }
+    printf("\n");
+    return result.mismatches == 0;
+}
+
+int main()
+{
+    std::mt19937        random(20261016);
+    bool                pass = true;
+
+    // 固定小数点の全 int16 の値（記録したテレメトリ・チャネル別形式）
+    {
+        Result  result = {};
+        char    expected[64];
+        char    actual[64];
+        for (int32_t centi = INT16_MIN; centi <= INT16_MAX; centi++) {
+            snprintf(expected, sizeof (expected), "%6.2f", centi / 100.0);
+            *TelemetryFormatCenti(actual, centi) = '\0';
+            result.checked++;
+            if (strcmp(expected, actual) != 0) {
+                report(&result, "centi", expected, actual);
+            }
+        }
+        pass &= summary("centi16 all values", result);
+    }
+
+    // 0.01 単位の各値と、丸めの境界の前後の float
+    {
+        Result  result = {};
+        for (int32_t centi = -BENCH_BOUNDARY_CENTI; centi <= BENCH_BOUNDARY_CENTI; centi++) {
+            float value = (float)(centi / 100.0);
+            float boundary = (float)((centi + 0.5) / 100.0);
+            checkFloat(value, &result);
+            checkFloat(boundary, &result);
+            checkFloat(nextafterf(boundary, -INFINITY), &result);
+            checkFloat(nextafterf(boundary, INFINITY), &result);
+        }
+        // 0 に丸める負の値・特殊な値
+        const float specials[] = {
+            -0.0f, 0.0f, -0.001f, -0.004999f, -0.005f, -0.0050001f, 0.004999f, 0.005f, 0.125f, -0.125f, 0.375f, 2.675f,
+            1e-45f, -1e-45f, 1.17549435e-38f, -1.17549435e-38f, 21474836.0f, -21474836.0f,
+            NAN, -NAN, INFINITY, -INFINITY,
+        };
+        for (float value : specials) {
+            checkFloat(value, &result);
+        }
+        pass &= summary("float rounding boundaries", result);
+    }
+
+    // ランダムな全ビットパターン
+    {
+        Result  result = {};
+        for (int i = 0; i < BENCH_RANDOM_FLOATS; i++) {
+            uint32_t    bits = random();
+            float       value;
+            memcpy(&value, &bits, sizeof (value));
+            checkFloat(value, &result);
+        }
+        pass &= summary("float random bit patterns", result);
+    }
+
+    // テレメトリ文字列（番号・経過時間の端の値と、姿勢・温度の範囲のランダムな値）
+    {
+        Result                                  result = {};
+        std::uniform_real_distribution<float>   angle(-200.0f, 200.0f);
+        std::uniform_real_distribution<float>   small(-0.01f, 0.01f);
+        const int       counters[] = { 0, 1, 99, 100, 2147483647, -1, -2147483647 - 1 };
+        const uint32_t  times[] = { 0, 59, 60, 3599, 3600, 359999, 360000, 2147483647U };
+        for (int counter : counters) {
+            for (uint32_t time : times) {
+                checkLine(counter, time, 0.0f, -0.0f, -0.001f, 25.0f, &result);
+                checkLine(counter, time, -89.995f, 179.999f, -180.0f, -40.0f, &result);
+                checkLine(counter, time, NAN, INFINITY, -INFINITY, 1000.0f, &result);
+            }
+        }
+        for (int i = 0; i < BENCH_RANDOM_LINES; i++) {
+            bool tiny = (i & 1) != 0;
+            checkLine((int)random(), random() % 360000, angle(random), angle(random), tiny ? small(random) : angle(random),
+                      tiny ? small(random) : angle(random), &result);
+        }
+        pass &= summary("TLM line", result);
+    }
+
+    // 生成時間
+    {
+        std::vector<float>  values(4 * 1024);
+        std::uniform_real_distribution<float>   angle(-180.0f, 180.0f);
+        for (float &value : values) {
+            value = angle(random);
+        }
+        char        line[128];
+        uint64_t    checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_LINES; i++) {
+            const float *v = &values[(i * 4) & (values.size() - 1)];
+            int hour = i / 3600;
+            int min  = (i - (hour * 3600)) / 60;
+            int sec  = i % 60;
+            checksum += sprintf(line, "TLM, %d, %02d:%02d:%02d, %6.2f, %6.2f, %6.2f, %6.2f", i, hour, min, sec, v[0], v[1], v[2], v[3]);
+        }
+        double sprintfNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_LINES;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_LINES; i++) {
+            const float *v = &values[(i * 4) & (values.size() - 1)];
+            checksum += TelemetryFormatTextValues(i, i, v[0], v[1], v[2], v[3], line, sizeof (line));
+        }
+        double formatNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_LINES;
+
+        printf("sprintf                   %7.1f ns/line\n", sprintfNs);
+        printf("TelemetryFormatTextValues %7.1f ns/line  (x%.1f)   [checksum %llu]\n", formatNs, sprintfNs / formatNs,
+               (unsigned long long)checksum);
+    }
+
+    printf("%s\n", pass ? "PASS: byte-identical to sprintf" : "FAIL: output differs from sprintf");
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,19 +3,76 @@
  * @brief      姿勢情報取得
  * @version    1.00
  * @author     SONODA Takehiko (OzoraKobo)
- * @details    加速度・ジャイロセンサ MPU6886 から姿勢情報（Pitch, Roll）および内部温度を取得する
+ * @details    加速度・ジャイロセンサ MPU6886 から姿勢情報（Pitch, Roll, Yaw）および内部温度を取得する
  * @date       2021/09/09 v1.00 新規作成
+ * @date       2026/10/16 v1.01 ログ・プロパティ出力先設定追加
+ * @date       2026/10/16 v1.02 姿勢情報・内部温度をシーケンスロックで保護したスナップショットで受け渡す
+ *                              スナップショットは２面を交互に書き込み、読み出し中の面を書き換えないため、
+ *                              読み出し側は取得タスクの優先度にかかわらず待たされない
+ * @date       2026/10/16 v1.03 Pitch, Roll の区間統計（最小・最大・平均・分散）追加
+ *                              取得毎に Welford 法で更新し、スナップショットと一緒に公開する
+ *                              区間のリセット要求は公開済みのサンプル順序番号と同じ語で受け付け、
+ *                              取得したスナップショットの次のサンプルから新しい区間とする（サンプルの欠落・重複なし）
+ * @date       2026/10/16 v1.04 加速度だけの姿勢（M5.IMU.getAttitude）を、ジャイロ・加速度の姿勢推定フィルタ（AttitudeFilter）に変更
+ *                              取得毎に角速度・加速度を読み出してフィルタを更新し、振動の影響を抑えた Pitch, Roll と
+ *                              ジャイロ積分による Yaw、クォータニオンを公開する
+ * @date       2026/10/16 v1.05 MPU6886 の FIFO からの一括取得（ACQUIRE_FIFO）追加
+ *                              FIFO に一定周期（既定 1kHz）でサンプルを溜め、取得周期毎にまとめて読み出して
+ *                              全サンプルでフィルタを更新する。区間統計は全サンプルで求め、公開は取得周期毎に１回とする
+ * @date       2026/10/16 v1.06 取得周期の delay を固定位相の周期実行（TaskPeriod）に変更
+ *                              取得処理の時間で取得周期が伸びず、実測周波数・周期ジッタを取得できる
  * @par     
  * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
  ******************************************************************************/
 
 #include <freertos/FreeRTOS.h>
+#include <Wire.h>
 #include "Attitude.h"
 
-Attitude::Attitude(Attitude::LOG_LEVEL logLevel)
+#define ATTITUDE_STATS_RESET    1           // 区間統計リセット要求（_snapshotSeq の bit0、サンプル順序番号は bit1 以上）
+#define ATTITUDE_DT_MAX         0.1f        // 姿勢推定フィルタの更新間隔の上限[秒]（タスクが長く止まった場合の積分誤差を抑える）
+#define ATTITUDE_IMU_WIRE       Wire1       // MPU6886 の I2C（M5Atom ライブラリの IMU と同じ SDA=25, SCL=21）
+#define ATTITUDE_IMU_READ_MAX   126         // １回の連続読み出しの最大バイト数（Wire のバッファ 128 バイトに収まるサンプル数 9 個分）
+
+// MPU6886 のレジスタ読み書き（I2C）
+class AttitudeImuBus : public ImuRegisterBus
+{
+public:
+    bool Write(uint8_t reg, uint8_t value) override
+    {
+        ATTITUDE_IMU_WIRE.beginTransmission(MPU6886_ADDRESS);
+        ATTITUDE_IMU_WIRE.write(reg);
+        ATTITUDE_IMU_WIRE.write(value);
+        return (ATTITUDE_IMU_WIRE.endTransmission() == 0);
+    }
+
+    bool Read(uint8_t reg, uint8_t *dst, size_t length) override
+    {
+        ATTITUDE_IMU_WIRE.beginTransmission(MPU6886_ADDRESS);
+        ATTITUDE_IMU_WIRE.write(reg);
+        // リピーテッドスタートで続けて読み出す
+        if (ATTITUDE_IMU_WIRE.endTransmission(false) != 0) {
+            return false;
+        }
+        if (ATTITUDE_IMU_WIRE.requestFrom((int)MPU6886_ADDRESS, (int)length) != (int)length) {
+            return false;
+        }
+        for (size_t index = 0; index < length; index++) {
+            dst[index] = (uint8_t)ATTITUDE_IMU_WIRE.read();
+        }
+        return true;
+    }
+
+    size_t MaxRead() const override { return ATTITUDE_IMU_READ_MAX; }
+};
+
+static AttitudeImuBus   attitudeImuBus;     // MPU6886 のレジスタ読み書き
+
+Attitude::Attitude(Attitude::LOG_LEVEL logLevel) : _fifo(&attitudeImuBus)
 {
     // 姿勢情報取得プロパティ初期化
     _logLevel = logLevel;                   // ログ出力レベル
+    _out = &Serial;                         // ログ出力先
     init = false;                           // 初期化済フラグ
     _acquire_period = 50;                   // 姿勢情報取得周期[ms]
     _tempSample = 1000 / _acquire_period;   // 平均温度サンプル数
@@ -25,12 +82,26 @@ Attitude::Attitude(Attitude::LOG_LEVEL logLevel)
     // ワーク変数初期化
     pitch = 0.0;                            // 姿勢 ピッチ
     roll = 0.0;                             // 姿勢 ロール
-    yaw = 0.0;                              // 姿勢 ヨー（未使用）
+    yaw = 0.0;                              // 姿勢 ヨー
     arc = 0.0;                              // 極座標角
     val = 0.0;                              // 合成ベクトルの大きさ
     r_rand = 180 / PI;                      // ラジアン → 角度変換係数
     tempBuffIndex = 0;                      // 温度移動平均計算用バッファ入出力インデックス
     averageTemp = 0.0;                      // 内部温度（移動平均）
+    memset(_snapshot, 0, sizeof (_snapshot));   // 姿勢情報スナップショット
+    _snapshotSeq.store(0, std::memory_order_relaxed);   // 公開済みのサンプル順序番号（未取得）
+    _lastUpdate = 0;                        // 姿勢推定フィルタの前回の更新時刻[us]
+    _acquireMode = ACQUIRE_REGISTER;        // IMU 取得方式
+    _batchSamples = 0;                      // 今回の公開までのサンプル数
+    _batchPitchM2 = 0.0f;                   // 今回の公開までのピッチ偏差平方和
+    _batchRollM2 = 0.0f;                    // 今回の公開までのロール偏差平方和
+    memset(&_batchPitch, 0, sizeof (_batchPitch));  // 今回の公開までのピッチ統計
+    memset(&_batchRoll, 0, sizeof (_batchRoll));    // 今回の公開までのロール統計
+    _statsSamples = 0;                      // 区間統計 サンプル数
+    _pitchM2 = 0.0f;                        // 区間統計 ピッチ偏差平方和
+    _rollM2 = 0.0f;                         // 区間統計 ロール偏差平方和
+    memset(&_pitchStats, 0, sizeof (_pitchStats));  // 区間統計 ピッチ
+    memset(&_rollStats, 0, sizeof (_rollStats));    // 区間統計 ロール
 
     running = false;                        // タスク駆動中
     status = STATUS_CREATED;                // 姿勢情報取得状態（生成済）
@@ -53,36 +124,46 @@ void Attitude::DispProperties()
         return;
     }
 
-    Serial.print("Serial Receiver values of object.\n");
+    _out->print("Serial Receiver values of object.\n");
 
     // 初期化済フラグ
-    Serial.printf("init : %d\n", init);
+    _out->printf("init : %d\n", init);
     // 姿勢情報取得周期[ms][ms]
-    Serial.printf("acquisition period : %d\n", _acquire_period);
+    _out->printf("acquisition period : %d\n", _acquire_period);
     // 平均温度サンプル数
-    Serial.printf("number of samples : %d\n", _tempSample);
+    _out->printf("number of samples : %d\n", _tempSample);
     // コールバック関数へポインタ
-    Serial.printf("callback function: %08X\n", _callback);
+    _out->printf("callback function: %08X\n", _callback);
     // 移動平均温度計算用バッファへのポインタ
-    Serial.printf("temperature buffer : %08X\n", _tempBuff);
+    _out->printf("temperature buffer : %08X\n", _tempBuff);
     // 姿勢 ピッチ
-    Serial.printf("ptich : %.2f\n", pitch);
+    _out->printf("ptich : %.2f\n", pitch);
     // 姿勢 ロール
-    Serial.printf("roll  : %.2f\n", roll);
+    _out->printf("roll  : %.2f\n", roll);
     // 姿勢 ヨー
-    Serial.printf("yaw   : %.2f\n", yaw);
+    _out->printf("yaw   : %.2f\n", yaw);
+    // ジャイロバイアス
+    float biasX, biasY, biasZ;
+    _filter.GetGyroBias(&biasX, &biasY, &biasZ);
+    _out->printf("gyro bias : %.3f, %.3f, %.3f (%s)\n", biasX, biasY, biasZ, _filter.Calibrated() ? "calibrated" : "calibrating");
     // 極座標角
-    Serial.printf("arc   : %.2f\n", arc);
+    _out->printf("arc   : %.2f\n", arc);
     // 大きさ
-    Serial.printf("val   : %.2f\n", val);
+    _out->printf("val   : %.2f\n", val);
     // 移動平均温度計算用バッファ入出力インデックス
-    Serial.printf("temperature buffer index : %d\n", tempBuffIndex);
+    _out->printf("temperature buffer index : %d\n", tempBuffIndex);
     // 内部温度（移動平均）
-    Serial.printf("average temperature : %5.2f\n", averageTemp);
+    _out->printf("average temperature : %5.2f\n", averageTemp);
+    // 公開済みのサンプル順序番号
+    _out->printf("snapshot sequence : %u\n", _snapshotSeq.load(std::memory_order_relaxed) >> 1);
+    // 区間統計 サンプル数
+    _out->printf("statistics samples : %u\n", _statsSamples);
+    // IMU 取得方式
+    _out->printf("acquisition mode : %s\n", (_acquireMode == ACQUIRE_FIFO) ? "fifo" : "register");
     // タスク駆動中
-    Serial.printf("running : %d\n", running);
+    _out->printf("running : %d\n", running);
     // 姿勢情報取得状態
-    Serial.printf("status : %d\n", status);
+    _out->printf("status : %d\n", status);
 }
 
 // 姿勢情報取得オブジェクト初期化
@@ -136,6 +217,38 @@ Attitude::RESULT Attitude::Init(AttitudeCallback callback, int sample, int perio
     return RESULT_SUCCESS;
 }
 
+// IMU 取得方式設定
+Attitude::RESULT Attitude::SetAcquireMode(Attitude::ACQUIRE_MODE mode, uint32_t rateHz)
+{
+    if (!init || running) {
+        // 初期化前・取得開始後は変更できない
+        logOutput(LOG_ERROR, "Attitude acquisition mode must be set after Init and before Start\n");
+        return RESULT_ERR_STATE;
+    }
+    if (mode == ACQUIRE_REGISTER) {
+        _acquireMode = ACQUIRE_REGISTER;
+        return RESULT_SUCCESS;
+    }
+    if (mode != ACQUIRE_FIFO) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    // FIFO の初期化（M5.IMU.Init の後に、FIFO 用の設定で上書きする）
+    Mpu6886Fifo::RESULT result = _fifo.Init(rateHz);
+    if (result == Mpu6886Fifo::RESULT_ERR_ARGS) {
+        return RESULT_ERR_ARGS;
+    }
+    if (result != Mpu6886Fifo::RESULT_SUCCESS) {
+        // FIFO を使用できない データレジスタからの取得を続ける
+        logOutput(LOG_WARNING, "Attitude FIFO initialize failed, acquiring from data registers\n");
+        return RESULT_ERR_MISC;
+    }
+    _acquireMode = ACQUIRE_FIFO;
+
+    return RESULT_SUCCESS;
+}
+
 Attitude::RESULT Attitude::Start()
 {
     logOutput(LOG_INFO, "Attitude task starting...\n");
@@ -145,28 +258,98 @@ Attitude::RESULT Attitude::Start()
     return RESULT_SUCCESS;
 }
 
+// 姿勢情報スナップショット取得
+Attitude::RESULT Attitude::GetSnapshot(AttitudeSnapshot *snapshot) const
+{
+    uint32_t    seq;                        // 読み出したサンプル順序番号
+
+    if (snapshot == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    while (1) {
+        // 公開済みのサンプル順序番号の面を読み出す
+        seq = _snapshotSeq.load(std::memory_order_acquire) >> 1;
+        *snapshot = _snapshot[seq & 1];
+        // 読み出し中に次のサンプルが公開されていなければ、書き込み中の面（もう一方）を読んでいないので一貫している
+        // （公開されていれば読み出した面が次の次のサンプルで書き換えられた可能性があるため、読み直す）
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((_snapshotSeq.load(std::memory_order_relaxed) >> 1) == seq) {
+            break;
+        }
+    }
+
+    if (seq == 0) {
+        // 未取得
+        return RESULT_NO_RECV_DATA;
+    }
+    // 姿勢情報スナップショット取得成功
+    return RESULT_SUCCESS;
+}
+
+// 姿勢情報スナップショット取得・区間統計リセット
+Attitude::RESULT Attitude::TakeSnapshot(AttitudeSnapshot *snapshot)
+{
+    uint32_t    word;                       // 読み出したサンプル順序番号 × 2 ＋ 区間統計リセット要求
+
+    if (snapshot == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    while (1) {
+        // 公開済みのサンプル順序番号の面を読み出す
+        word = _snapshotSeq.load(std::memory_order_acquire);
+        *snapshot = _snapshot[(word >> 1) & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 読み出し中に次のサンプルが公開されていなければ、同じ操作でリセットを要求する
+        // （公開されていれば、そのサンプルが報告されずに区間から消えるので読み直す）
+        if (_snapshotSeq.compare_exchange_strong(word, word | ATTITUDE_STATS_RESET, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (word & ATTITUDE_STATS_RESET) {
+        // 前回の取得から新しいサンプルなし 区間統計は前回報告済み
+        snapshot->statsSamples = 0;
+        memset(&snapshot->pitchStats, 0, sizeof (snapshot->pitchStats));
+        memset(&snapshot->rollStats, 0, sizeof (snapshot->rollStats));
+    }
+    if ((word >> 1) == 0) {
+        // 未取得
+        return RESULT_NO_RECV_DATA;
+    }
+    // 姿勢情報スナップショット取得成功
+    return RESULT_SUCCESS;
+}
+
 // 姿勢情報取得データ取得
 Attitude::RESULT Attitude::GetAttitude(float *pfPitch, float *pfRoll, float *pfYaw, float *pfArc, float *pfVal)
 {
+    AttitudeSnapshot    snapshot;           // 姿勢情報スナップショット
+    RESULT              result = GetSnapshot(&snapshot);
+
     // 姿勢情報を出力する
-    *pfPitch = (float)pitch;        // 姿勢 ピッチ
-    *pfRoll = (float)roll;          // 姿勢 ロール
-    *pfYaw = (float)yaw;            // 姿勢 ヨー（未使用）
-    *pfArc = (float)arc;            // 極座標角
-    *pfVal = (float)val;            // 大きさ
+    *pfPitch = snapshot.pitch;      // 姿勢 ピッチ
+    *pfRoll = snapshot.roll;        // 姿勢 ロール
+    *pfYaw = snapshot.yaw;          // 姿勢 ヨー
+    *pfArc = snapshot.arc;          // 極座標角
+    *pfVal = snapshot.val;          // 大きさ
 
-    // 姿勢情報取得データ取得成功
-    return RESULT_SUCCESS;
+    return result;
 }
 
 // 内部温度データ取得
 Attitude::RESULT Attitude::GetTemperature(float *pfTemp)
 {
+    AttitudeSnapshot    snapshot;           // 姿勢情報スナップショット
+    RESULT              result = GetSnapshot(&snapshot);
+
     // 内部温度データを出力する
-    *pfTemp = averageTemp;
+    *pfTemp = snapshot.temp;
 
-    // 内部温度データ取得成功
-    return RESULT_SUCCESS;
+    return result;
 }
 
 // 姿勢情報取得状態取得
@@ -176,6 +359,32 @@ Attitude::STATUS Attitude::GetStatus()
     return status;
 }
 
+// IMU 取得統計出力
+void Attitude::DispImuStats()
+{
+    Mpu6886Fifo::Stats  stats;              // FIFO 一括取得統計情報
+
+    if (_acquireMode != ACQUIRE_FIFO) {
+        _out->printf("IMUSTAT, mode=register, period=%dms\n", _acquire_period);
+        return;
+    }
+    _fifo.GetStats(&stats);
+    _out->printf("IMUSTAT, mode=fifo, rate=%.0fHz, period=%dms, drains=%u, samples=%u, transactions=%u, overflows=%u, maxbatch=%u\n",
+        1.0f / _fifo.Period(), _acquire_period, stats.drains, stats.samples, stats.transactions, stats.overflows, stats.maxBatch);
+}
+
+// 周期実行統計情報取得
+void Attitude::GetPeriodStats(TaskPeriod::Stats *stats) const
+{
+    _taskPeriod.GetStats(stats);
+}
+
+// ログ・プロパティ出力先設定
+void Attitude::SetOutput(Print *out)
+{
+    _out = (out != NULL) ? out : &Serial;
+}
+
 void Attitude::run(void *data)
 {
     float   sumTemp = 0.0;  // 積算温度
@@ -193,17 +402,51 @@ void Attitude::run(void *data)
     running = true;
     // 姿勢情報取得動作中
     status = STATUS_RUN;
+    // 姿勢推定フィルタ初期化（最初のサンプルの加速度から姿勢を初期化する）
+    _filter.Reset();
+    _lastUpdate = micros();
+    if (_acquireMode == ACQUIRE_FIFO) {
+        // 取得開始前に溜まったサンプルを捨てる
+        _fifo.Reset();
+    }
+    // 取得周期の起点
+    _taskPeriod.Start(_acquire_period);
 
     while (1)
     {
-        // IMUから姿勢状態を取得する
-        M5.IMU.getAttitude(&pitch, &roll);
+        if (_acquireMode == ACQUIRE_FIFO) {
+            // FIFO に溜まったサンプルをまとめて読み出し、サンプリング周期毎に姿勢推定フィルタを更新する
+            size_t count = _fifo.Drain(_fifoSamples, ATTITUDE_FIFO_BATCH_MAX);
+            if (count == 0) {
+                // 新しいサンプルなし
+                _taskPeriod.Wait();
+                continue;
+            }
+            float dt = _fifo.Period();
+            float batchTemp = 0.0f;
+            for (size_t index = 0; index < count; index++) {
+                update(_fifoSamples[index], dt);
+                batchTemp += _fifoSamples[index].temp;
+            }
+            // 内部温度は読み出したサンプルの平均とする
+            curTemp = batchTemp / (float)count;
+        }
+        else {
+            ImuSample   sample;             // IMU の１サンプル
+
+            // IMUから角速度・加速度・内部温度を取得し、姿勢推定フィルタを更新する
+            M5.IMU.getGyroData(&sample.gx, &sample.gy, &sample.gz);
+            M5.IMU.getAccelData(&sample.ax, &sample.ay, &sample.az);
+            M5.IMU.getTempData(&sample.temp);
+            uint32_t now = micros();
+            float dt = (float)(now - _lastUpdate) * 1.0e-6f;
+            _lastUpdate = now;
+            update(sample, (dt < ATTITUDE_DT_MAX) ? dt : ATTITUDE_DT_MAX);
+            curTemp = sample.temp;
+        }
         arc = atan2(pitch, roll) * r_rand + 180;
         val = sqrt(pitch * pitch + roll * roll);
 
-        // IMUから内部温度を取得する
-        M5.IMU.getTempData(&curTemp);
-
         // 移動平均温度計算
         // 移動平均温度計算用バッファからsample数前の温度を取得
         float oldTemp = _tempBuff[tempBuffIndex];
@@ -223,16 +466,128 @@ void Attitude::run(void *data)
             status = STATUS_RUN;
         }
 
-        // 姿勢情報取得周期[ms]ウェイト
-        delay(_acquire_period);
+        // 姿勢情報・内部温度を１つのサンプルとして公開する（区間統計には今回の公開までの全サンプルを加える）
+        publish();
+
+        // 次の姿勢情報取得周期まで待つ
+        _taskPeriod.Wait();
     }
 }
 
+// 姿勢情報スナップショット公開
+void Attitude::publish()
+{
+    uint32_t            word = _snapshotSeq.load(std::memory_order_relaxed);       // 公開済みのサンプル順序番号 × 2 ＋ リセット要求
+    uint32_t            seq = (word >> 1) + 1;                                      // 公開するサンプル順序番号
+    AttitudeSnapshot    &snapshot = _snapshot[seq & 1];     // 書き込む面（公開済みでない方）
+
+    // 前回の公開より後に書き込む（書き込み途中の値を読んだ読み出し側が、前回の公開を必ず検出できるようにする）
+    std::atomic_thread_fence(std::memory_order_release);
+    snapshot.seq = seq;                     // サンプル順序番号
+    snapshot.timestamp = millis();          // 取得時刻[ms]
+    snapshot.pitch = (float)pitch;          // 姿勢 ピッチ
+    snapshot.roll = (float)roll;            // 姿勢 ロール
+    snapshot.yaw = (float)yaw;              // 姿勢 ヨー
+    snapshot.quaternion = _filter.GetQuaternion();  // 姿勢 クォータニオン
+    snapshot.arc = (float)arc;              // 極座標角
+    snapshot.val = (float)val;              // 大きさ
+    snapshot.temp = averageTemp;            // 内部温度（移動平均）
+    accumulate((word & ATTITUDE_STATS_RESET) != 0);
+    snapshot.statsSamples = _statsSamples;  // 区間統計
+    snapshot.pitchStats = _pitchStats;
+    snapshot.rollStats = _rollStats;
+    // 書き込み完了後に公開する（リセット要求はこの公開で受け付けたことになる）
+    while (!_snapshotSeq.compare_exchange_strong(word, seq << 1, std::memory_order_release, std::memory_order_relaxed)) {
+        // 書き込み中にリセットが要求された 要求時の区間に今回のサンプルは含まれないので、今回のサンプルから新しい区間とする
+        accumulate(true);
+        snapshot.statsSamples = _statsSamples;
+        snapshot.pitchStats = _pitchStats;
+        snapshot.rollStats = _rollStats;
+    }
+    // 今回の公開までのサンプルは区間統計に加えた
+    _batchSamples = 0;
+}
+
+// Welford 法による１項目の区間統計更新
+static inline void accumulateStats(AttitudeStats *stats, float *m2, float value, uint32_t samples)
+{
+    if (samples == 1) {
+        // 区間の最初のサンプル
+        stats->min = value;
+        stats->max = value;
+        stats->mean = value;
+        *m2 = 0.0f;
+    }
+    else {
+        float delta = value - stats->mean;
+        stats->mean += delta / (float)samples;
+        *m2 += delta * (value - stats->mean);
+        if (value < stats->min) {
+            stats->min = value;
+        }
+        if (value > stats->max) {
+            stats->max = value;
+        }
+    }
+    stats->variance = *m2 / (float)samples;
+}
+
+// Chan らの方法による１項目の区間統計へのサンプル群の統計の併合（samples は併合前の区間のサンプル数）
+static inline void mergeStats(AttitudeStats *stats, float *m2, uint32_t samples,
+    const AttitudeStats &batch, float batchM2, uint32_t batchSamples)
+{
+    if (samples == 0) {
+        // 区間の最初のサンプル群
+        *stats = batch;
+        *m2 = batchM2;
+        return;
+    }
+    float total = (float)(samples + batchSamples);
+    float delta = batch.mean - stats->mean;
+    stats->mean += delta * (float)batchSamples / total;
+    *m2 += batchM2 + delta * delta * (float)samples * (float)batchSamples / total;
+    if (batch.min < stats->min) {
+        stats->min = batch.min;
+    }
+    if (batch.max > stats->max) {
+        stats->max = batch.max;
+    }
+    stats->variance = *m2 / total;
+}
+
+// 区間統計更新
+void Attitude::accumulate(bool reset)
+{
+    if (reset) {
+        // 今回の公開のサンプルから新しい区間とする
+        _statsSamples = 0;
+    }
+    mergeStats(&_pitchStats, &_pitchM2, _statsSamples, _batchPitch, _batchPitchM2, _batchSamples);
+    mergeStats(&_rollStats, &_rollM2, _statsSamples, _batchRoll, _batchRollM2, _batchSamples);
+    _statsSamples += _batchSamples;
+}
+
+// １サンプルの処理
+void Attitude::update(const ImuSample &sample, float dt)
+{
+    float   fPitch, fRoll, fYaw;            // 推定した姿勢[度]
+
+    _filter.Update(sample.gx, sample.gy, sample.gz, sample.ax, sample.ay, sample.az, dt);
+    _filter.GetEuler(&fPitch, &fRoll, &fYaw);
+    pitch = fPitch;
+    roll = fRoll;
+    yaw = fYaw;
+    // 今回の公開までの統計に加える（公開時に区間統計へ併合する）
+    _batchSamples++;
+    accumulateStats(&_batchPitch, &_batchPitchM2, fPitch, _batchSamples);
+    accumulateStats(&_batchRoll, &_batchRollM2, fRoll, _batchSamples);
+}
+
 // ログ出力
 void Attitude::logOutput(Attitude::LOG_LEVEL logLevel, char *logMsg)
 {
     if (logLevel <= _logLevel) {
         // ログ出力レベルが規定値以下
-        Serial.print(logMsg);
+        _out->print(logMsg);
     }
 }
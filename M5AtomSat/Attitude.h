@@ -5,6 +5,12 @@
  * @author     SONODA Takehiko (OzoraKobo)
  * @details    姿勢情報取得のクラス定義
  * @date       2021/09/09 v1.00 新規作成
+ * @date       2026/10/16 v1.01 ログ・プロパティ出力先設定追加
+ * @date       2026/10/16 v1.02 姿勢情報・内部温度をシーケンスロックで保護したスナップショットで受け渡す
+ * @date       2026/10/16 v1.03 Pitch, Roll の区間統計（最小・最大・平均・分散）追加
+ * @date       2026/10/16 v1.04 ジャイロ・加速度の姿勢推定フィルタ（AttitudeFilter）による姿勢・Yaw 出力
+ * @date       2026/10/16 v1.05 MPU6886 の FIFO からの一括取得（取得方式設定・IMU 取得統計）追加
+ * @date       2026/10/16 v1.06 取得周期を固定位相の周期実行（TaskPeriod）とし、周期実行統計取得を追加
  * @par     
  * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
  ******************************************************************************/
@@ -12,12 +18,40 @@
 #ifndef _ATTITUDE_H_
 #define _ATTITUDE_H_
 
+#include <atomic>
 #include <functional>
 #include <M5Atom.h>
+#include "AttitudeFilter.h"
+#include "Mpu6886Fifo.h"
+#include "TaskPeriod.h"
 
+#define ATTITUDE_FIFO_RATE      1000        // FIFO 一括取得のサンプリング周波数の既定値[Hz]
+#define ATTITUDE_FIFO_BATCH_MAX (MPU6886_FIFO_SIZE / MPU6886_FIFO_PACKET_SIZE)  // １回に読み出す最大サンプル数（FIFO 満杯分）
 
 typedef std::function<void(int)> AttitudeCallback;
 
+struct AttitudeStats {                      // 区間統計（区間の開始から公開したサンプルまで。FIFO 一括取得では読み出した全サンプル）
+    float                   min;            // 最小
+    float                   max;            // 最大
+    float                   mean;           // 平均
+    float                   variance;       // 分散（母分散）
+};
+
+struct AttitudeSnapshot {                   // 姿勢情報スナップショット（同じサンプルの値の組）
+    uint32_t                seq;            // サンプル順序番号（公開毎に 1 ずつ増える。0 は未取得）
+    uint32_t                timestamp;      // 取得時刻[ms]（起動からの経過時間 millis()）
+    float                   pitch;          // 姿勢 ピッチ
+    float                   roll;           // 姿勢 ロール
+    float                   yaw;            // 姿勢 ヨー（起動時の向きからのジャイロ積分値）
+    AttitudeQuaternion      quaternion;     // 姿勢 クォータニオン
+    float                   arc;            // 極座標角
+    float                   val;            // 大きさ
+    float                   temp;           // 内部温度（移動平均）
+    uint32_t                statsSamples;   // 区間統計 サンプル数（0 は区間内のサンプルなし）
+    AttitudeStats           pitchStats;     // 区間統計 ピッチ
+    AttitudeStats           rollStats;      // 区間統計 ロール
+};
+
 class Attitude : public Task
 {
 public:
@@ -53,6 +87,12 @@ public:
         EVENT_NUM                           // 姿勢情報取得イベント数
     };
 
+    enum ACQUIRE_MODE {                     // IMU 取得方式
+        ACQUIRE_REGISTER = 0,               // 取得周期毎にデータレジスタから１サンプル読み出す
+        ACQUIRE_FIFO,                       // FIFO に溜めたサンプルを取得周期毎にまとめて読み出す
+        ACQUIRE_MODE_NUM                    // IMU 取得方式数
+    };
+
     enum LOG_LEVEL {                        // ログ出力レベル
         LOG_DISABLED = 0,                   // ログ出力レベル 出力なし
         LOG_ERROR,                          // ログ出力レベル エラー以下
@@ -71,25 +111,38 @@ public:
     void DispProperties();
     // 姿勢情報取得初期化
     RESULT Init(AttitudeCallback callback = 0, int sample = 200, int period = 5);
+    // IMU 取得方式設定（Init の後、Start の前に呼び出す。FIFO の初期化に失敗したらデータレジスタから取得する）
+    RESULT SetAcquireMode(ACQUIRE_MODE mode, uint32_t rateHz = ATTITUDE_FIFO_RATE);
     // 姿勢情報取得開始
     RESULT Start();
+    // 姿勢情報スナップショット取得（排他なし・待ちなし。未取得なら RESULT_NO_RECV_DATA）
+    RESULT GetSnapshot(AttitudeSnapshot *snapshot) const;
+    // 姿勢情報スナップショット取得・区間統計リセット（取得したサンプルの次のサンプルから新しい区間とする）
+    RESULT TakeSnapshot(AttitudeSnapshot *snapshot);
     // 姿勢情報取得データ取得
     RESULT GetAttitude(float *pfPitch, float *pfRoll, float *pfYaw, float *pfArc, float *pfVal);
     // 内部温度データ取得
     RESULT GetTemperature(float *pfTemp);
     // 姿勢情報取得状態取得
     STATUS GetStatus();
+    // IMU 取得統計出力
+    void DispImuStats();
+    // 周期実行統計情報取得（取得周期・実測周波数・周期超過・周期ジッタ分布）
+    void GetPeriodStats(TaskPeriod::Stats *stats) const;
+    // ログ・プロパティ出力先設定（既定は Serial）
+    void SetOutput(Print *out);
 
 private:
     bool                    init;               // 初期化済フラグ
     int                     _tempSample;        // 平均温度サンプル数
     int                     _acquire_period;    // 姿勢情報取得周期[ms]
+    TaskPeriod              _taskPeriod;        // 姿勢情報取得周期の周期実行
     AttitudeCallback        _callback;          // コールバック関数へのポインタ
     float                   *_tempBuff;         // 移動平均温度計算用バッファへのポインタ
     bool                    running;            // タスク駆動中
     double                  pitch;              // 姿勢 ピッチ
     double                  roll;               // 姿勢 ロール
-    double                  yaw;                // 姿勢 ヨー（未使用）
+    double                  yaw;                // 姿勢 ヨー
     double                  arc;                // 極座標角
     double                  val;                // 大きさ
     double                  r_rand;             // ラジアン → 角度変換係数
@@ -97,9 +150,33 @@ private:
     int                     tempBuffIndex;      // 移動平均温度計算用バッファ入出力インデックス
     STATUS                  status;             // 姿勢情報取得状態
     LOG_LEVEL               _logLevel;          // ログ出力レベル
+    Print                   *_out;              // ログ・プロパティ出力先
+    AttitudeSnapshot        _snapshot[2];       // 姿勢情報スナップショット（サンプル順序番号の偶奇で交互に書き込む）
+    std::atomic<uint32_t>   _snapshotSeq;       // 公開済みのサンプル順序番号 × 2 ＋ 区間統計リセット要求
+    AttitudeFilter          _filter;            // 姿勢推定フィルタ
+    uint32_t                _lastUpdate;        // 姿勢推定フィルタの前回の更新時刻[us]
+    ACQUIRE_MODE            _acquireMode;       // IMU 取得方式
+    Mpu6886Fifo             _fifo;              // FIFO 一括取得
+    ImuSample               _fifoSamples[ATTITUDE_FIFO_BATCH_MAX];  // FIFO から読み出したサンプル
+    uint32_t                _batchSamples;      // 今回の公開までのサンプル数（区間統計に加える前）
+    float                   _batchPitchM2;      // 今回の公開までのピッチ偏差平方和
+    float                   _batchRollM2;       // 今回の公開までのロール偏差平方和
+    AttitudeStats           _batchPitch;        // 今回の公開までのピッチ統計
+    AttitudeStats           _batchRoll;         // 今回の公開までのロール統計
+    uint32_t                _statsSamples;      // 区間統計 サンプル数
+    float                   _pitchM2;           // 区間統計 ピッチ偏差平方和
+    float                   _rollM2;            // 区間統計 ロール偏差平方和
+    AttitudeStats           _pitchStats;        // 区間統計 ピッチ（分散は公開時に求める）
+    AttitudeStats           _rollStats;         // 区間統計 ロール（分散は公開時に求める）
 
     // 姿勢情報取得タスク関数
     void run(void *data);
+    // １サンプルの処理（姿勢推定フィルタを dt[秒] 進め、今回の公開までの統計に加える）
+    void update(const ImuSample &sample, float dt);
+    // 姿勢情報スナップショット公開（姿勢情報取得タスクだけが呼び出す）
+    void publish();
+    // 区間統計更新（今回の公開までのサンプルを加える。reset が true なら今回の公開のサンプルから新しい区間とする）
+    void accumulate(bool reset);
     // ログ出力
     void logOutput(LOG_LEVEL logLevel, char *logMsg);
 };
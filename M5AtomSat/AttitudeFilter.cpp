@@ -0,0 +1,181 @@
+/******************************************************************************
+ * @file       AttitudeFilter.cpp
+ * @brief      姿勢推定フィルタ
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    Mahony フィルタ（相補フィルタのクォータニオン版）による姿勢推定
+ *             加速度だけの姿勢は振動・加減速をそのまま拾うため、ジャイロの積分を主とし、
+ *             加速度は長周期の重力方向の基準としてだけ使う（時定数 約 1/Kp 秒）
+ *             １回の更新は四則演算と平方根２回（初期化時のみ三角関数）で、サンプル数によらず一定時間で終わる
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include "AttitudeFilter.h"
+
+#define ATTITUDE_DEG_TO_RAD     0.017453292519943295f   // 度 → ラジアン変換係数
+#define ATTITUDE_RAD_TO_DEG     57.29577951308232f      // ラジアン → 度変換係数
+
+// コンストラクタ
+AttitudeFilter::AttitudeFilter(float kp, float ki, uint32_t biasSamples)
+{
+    _kp = kp;                               // 比例ゲイン
+    _ki = ki;                               // 積分ゲイン
+    _biasSamples = biasSamples;             // ジャイロバイアス推定サンプル数
+    Reset();
+}
+
+// 初期化
+void AttitudeFilter::Reset()
+{
+    _biasCount = 0;                         // ジャイロバイアス推定済みサンプル数
+    for (int axis = 0; axis < 3; axis++) {
+        _bias[axis] = 0.0f;                 // ジャイロバイアス
+        _biasMean[axis] = 0.0f;             // ジャイロバイアス推定中の角速度の平均
+        _integral[axis] = 0.0f;             // 積分補正
+    }
+    _initialized = false;                   // 姿勢未初期化
+    _q.w = 1.0f;                            // 姿勢（回転なし）
+    _q.x = 0.0f;
+    _q.y = 0.0f;
+    _q.z = 0.0f;
+}
+
+// 更新
+void AttitudeFilter::Update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+{
+    float   norm2 = ax * ax + ay * ay + az * az;    // 加速度の大きさの２乗
+
+    // 角速度をラジアンに変換し、ジャイロバイアスを差し引く
+    gx *= ATTITUDE_DEG_TO_RAD;
+    gy *= ATTITUDE_DEG_TO_RAD;
+    gz *= ATTITUDE_DEG_TO_RAD;
+    if (!Calibrated()) {
+        estimateBias(gx, gy, gz);
+    }
+    gx -= _bias[0];
+    gy -= _bias[1];
+    gz -= _bias[2];
+
+    if (!_initialized) {
+        // 最初のサンプル 加速度から姿勢を初期化する
+        if (norm2 > 0.0f) {
+            initialize(ax, ay, az);
+        }
+        return;
+    }
+
+    if ((norm2 >= ATTITUDE_FILTER_ACCEL_MIN * ATTITUDE_FILTER_ACCEL_MIN) &&
+        (norm2 <= ATTITUDE_FILTER_ACCEL_MAX * ATTITUDE_FILTER_ACCEL_MAX)) {
+        // 加速度がほぼ重力だけ 重力方向のずれで角速度を補正する
+        float recipNorm = 1.0f / sqrtf(norm2);
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+        // 姿勢から求めた重力方向（機体座標）の 1/2
+        float halfVx = _q.x * _q.z - _q.w * _q.y;
+        float halfVy = _q.w * _q.x + _q.y * _q.z;
+        float halfVz = _q.w * _q.w - 0.5f + _q.z * _q.z;
+        // 加速度の重力方向とのずれ（外積、回転軸と角度の正弦の 1/2）
+        float halfEx = ay * halfVz - az * halfVy;
+        float halfEy = az * halfVx - ax * halfVz;
+        float halfEz = ax * halfVy - ay * halfVx;
+        if (_ki > 0.0f) {
+            // 積分補正（Pitch, Roll 軸の残りのジャイロバイアスを追従する）
+            _integral[0] += 2.0f * _ki * halfEx * dt;
+            _integral[1] += 2.0f * _ki * halfEy * dt;
+            _integral[2] += 2.0f * _ki * halfEz * dt;
+            gx += _integral[0];
+            gy += _integral[1];
+            gz += _integral[2];
+        }
+        // 比例補正
+        gx += 2.0f * _kp * halfEx;
+        gy += 2.0f * _kp * halfEy;
+        gz += 2.0f * _kp * halfEz;
+    }
+
+    // 角速度を積分する（dq/dt = q ⊗ (0, ω) / 2）
+    gx *= 0.5f * dt;
+    gy *= 0.5f * dt;
+    gz *= 0.5f * dt;
+    AttitudeQuaternion q = _q;
+    _q.w += -q.x * gx - q.y * gy - q.z * gz;
+    _q.x += q.w * gx + q.y * gz - q.z * gy;
+    _q.y += q.w * gy - q.x * gz + q.z * gx;
+    _q.z += q.w * gz + q.x * gy - q.y * gx;
+
+    // 正規化
+    float recipNorm = 1.0f / sqrtf(_q.w * _q.w + _q.x * _q.x + _q.y * _q.y + _q.z * _q.z);
+    _q.w *= recipNorm;
+    _q.x *= recipNorm;
+    _q.y *= recipNorm;
+    _q.z *= recipNorm;
+}
+
+// オイラー角取得
+void AttitudeFilter::GetEuler(float *pitch, float *roll, float *yaw) const
+{
+    float sinPitch = 2.0f * (_q.w * _q.y - _q.x * _q.z);
+
+    // 丸め誤差で ±1 を超えないようにする
+    if (sinPitch > 1.0f) {
+        sinPitch = 1.0f;
+    }
+    else if (sinPitch < -1.0f) {
+        sinPitch = -1.0f;
+    }
+    *pitch = asinf(sinPitch) * ATTITUDE_RAD_TO_DEG;
+    *roll = atan2f(_q.w * _q.x + _q.y * _q.z, 0.5f - _q.x * _q.x - _q.y * _q.y) * ATTITUDE_RAD_TO_DEG;
+    *yaw = atan2f(_q.w * _q.z + _q.x * _q.y, 0.5f - _q.y * _q.y - _q.z * _q.z) * ATTITUDE_RAD_TO_DEG;
+}
+
+// ジャイロバイアス取得
+void AttitudeFilter::GetGyroBias(float *gx, float *gy, float *gz) const
+{
+    *gx = _bias[0] * ATTITUDE_RAD_TO_DEG;
+    *gy = _bias[1] * ATTITUDE_RAD_TO_DEG;
+    *gz = _bias[2] * ATTITUDE_RAD_TO_DEG;
+}
+
+// 加速度から姿勢を初期化する
+void AttitudeFilter::initialize(float ax, float ay, float az)
+{
+    float roll = atan2f(ay, az);                        // ロール[rad]
+    float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));    // ピッチ[rad]
+    float cr = cosf(roll * 0.5f);
+    float sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f);
+    float sp = sinf(pitch * 0.5f);
+
+    // Yaw = 0 の ZYX オイラー角からクォータニオンを求める
+    _q.w = cr * cp;
+    _q.x = sr * cp;
+    _q.y = cr * sp;
+    _q.z = -sr * sp;
+    _initialized = true;
+}
+
+// ジャイロバイアス推定
+void AttitudeFilter::estimateBias(float gx, float gy, float gz)
+{
+    const float motion = ATTITUDE_FILTER_BIAS_MOTION * ATTITUDE_DEG_TO_RAD;
+
+    if ((_biasCount > 0) &&
+        ((fabsf(gx - _biasMean[0]) > motion) || (fabsf(gy - _biasMean[1]) > motion) || (fabsf(gz - _biasMean[2]) > motion))) {
+        // 動いている 推定し直す
+        _biasCount = 0;
+    }
+    _biasCount++;
+    _biasMean[0] += (gx - _biasMean[0]) / (float)_biasCount;
+    _biasMean[1] += (gy - _biasMean[1]) / (float)_biasCount;
+    _biasMean[2] += (gz - _biasMean[2]) / (float)_biasCount;
+    if (Calibrated()) {
+        // 推定終了 以降の角速度から差し引く
+        _bias[0] = _biasMean[0];
+        _bias[1] = _biasMean[1];
+        _bias[2] = _biasMean[2];
+    }
+}
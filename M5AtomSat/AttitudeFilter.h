@@ -0,0 +1,73 @@
+/******************************************************************************
+ * @file       AttitudeFilter.h
+ * @brief      姿勢推定フィルタ ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    ジャイロ・加速度から姿勢（クォータニオン、Pitch, Roll, Yaw）を推定する Mahony フィルタのクラス定義
+ *             （Arduino に依存しないため、ホスト上で評価できる）
+ *             ジャイロの角速度を積分して姿勢を更新し、加速度から求めた重力方向とのずれを比例・積分補正で戻す
+ *             Yaw は重力方向から補正できないため、ジャイロの積分値（起動時の向きを 0 とする相対値）となる
+ *             起動直後に静止している間（ATTITUDE_FILTER_BIAS_SAMPLES 回）のジャイロの平均をバイアスとし、以降の角速度から差し引く
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _ATTITUDE_FILTER_H_
+#define _ATTITUDE_FILTER_H_
+
+#include <stdint.h>
+
+#define ATTITUDE_FILTER_KP          0.5f        // 比例ゲイン[1/s]（加速度で重力方向へ戻す速さ）
+#define ATTITUDE_FILTER_KI          0.01f       // 積分ゲイン[1/s^2]（Pitch, Roll 軸のジャイロバイアスの追従）
+#define ATTITUDE_FILTER_ACCEL_MIN   0.8f        // 補正に使う加速度の大きさの下限[G]（落下・加減速中は補正しない）
+#define ATTITUDE_FILTER_ACCEL_MAX   1.2f        // 補正に使う加速度の大きさの上限[G]
+#define ATTITUDE_FILTER_BIAS_SAMPLES 200        // ジャイロバイアス推定サンプル数
+#define ATTITUDE_FILTER_BIAS_MOTION 3.0f        // ジャイロバイアス推定中に静止とみなす角速度の変動[度/秒]（超えたら推定し直す）
+
+struct AttitudeQuaternion {                 // クォータニオン（機体座標から基準座標への回転）
+    float                   w;              // 実部
+    float                   x;              // 虚部 X
+    float                   y;              // 虚部 Y
+    float                   z;              // 虚部 Z
+};
+
+class AttitudeFilter
+{
+public:
+
+    // コンストラクタ（比例・積分ゲインとジャイロバイアス推定サンプル数（0 は推定しない）を指定する）
+    AttitudeFilter(float kp = ATTITUDE_FILTER_KP, float ki = ATTITUDE_FILTER_KI,
+                   uint32_t biasSamples = ATTITUDE_FILTER_BIAS_SAMPLES);
+
+    // 更新（角速度[度/秒]、加速度[G]、前回の更新からの時間[秒]。分岐以外にループを含まず一定時間で終わる）
+    void Update(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+    // 初期化（次の更新の加速度から姿勢を初期化し、ジャイロバイアスを推定し直す）
+    void Reset();
+    // クォータニオン取得
+    AttitudeQuaternion GetQuaternion() const { return _q; }
+    // オイラー角取得[度]（Pitch ±90、Roll ±180、Yaw ±180。Pitch, Roll は従来の加速度による姿勢と同じ向き）
+    void GetEuler(float *pitch, float *roll, float *yaw) const;
+    // ジャイロバイアス推定済みか
+    bool Calibrated() const { return _biasCount >= _biasSamples; }
+    // ジャイロバイアス取得[度/秒]
+    void GetGyroBias(float *gx, float *gy, float *gz) const;
+
+private:
+    float                   _kp;            // 比例ゲイン
+    float                   _ki;            // 積分ゲイン
+    uint32_t                _biasSamples;   // ジャイロバイアス推定サンプル数
+    uint32_t                _biasCount;     // ジャイロバイアス推定済みサンプル数
+    float                   _bias[3];       // ジャイロバイアス[rad/s]（推定が終わるまでは 0）
+    float                   _biasMean[3];   // ジャイロバイアス推定中の角速度の平均[rad/s]
+    float                   _integral[3];   // 積分補正[rad/s]
+    bool                    _initialized;   // 姿勢初期化済み
+    AttitudeQuaternion      _q;             // 姿勢
+
+    // 加速度から姿勢を初期化する（Yaw は 0）
+    void initialize(float ax, float ay, float az);
+    // ジャイロバイアス推定（静止中の角速度[rad/s]を平均する）
+    void estimateBias(float gx, float gy, float gz);
+};
+
+#endif /* _ATTITUDE_FILTER_H_ */
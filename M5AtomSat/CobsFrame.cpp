@@ -0,0 +1,151 @@
+/******************************************************************************
+ * @file       CobsFrame.cpp
+ * @brief      COBSフレーム解析
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    COBS＋CRC-16 フレームを１バイトずつデコードし、区切りコード受信時にCRCを検査する
+ *             CRCはデコードしながら逐次計算し、CRCを含めた剰余が 0 になることで検査する
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 フレーム受信完了の直後の区切りコードを空フレームとして扱う（CRCエラーにしない）
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include "CobsFrame.h"
+#include "Crc16.h"
+
+CobsFrameParser::CobsFrameParser()
+{
+    Reset(NULL, 0);
+}
+
+// フレーム解析開始
+void CobsFrameParser::Reset(uint8_t *buff, size_t size)
+{
+    _buff = buff;                   // デコード結果格納バッファへのポインタ
+    _size = size;                   // デコード結果格納バッファサイズ
+    length = 0;                     // デコード済バイト数
+    frameLength = 0;                // 受信完了したフレームのデコード済バイト数
+    remain = 0;                     // 現在のブロックの残りデータバイト数
+    pendingZero = false;            // 次のブロック開始時に 0x00 を補う
+    overflow = false;               // バッファサイズ超過
+    crc = CRC16_INIT;               // デコード済データの CRC-16
+}
+
+// １バイト入力
+CobsFrameParser::RESULT CobsFrameParser::Feed(uint8_t data)
+{
+    RESULT  result;     // フレーム解析結果
+
+    if (data != COBS_FRAME_DELIMITER) {
+        if (remain == 0) {
+            // ブロック先頭（コードバイト）
+            if (pendingZero) {
+                // 直前のブロックの後ろの 0x00 を補う
+                put(0x00);
+            }
+            // コードバイト 0xFF のブロックの後ろには 0x00 を補わない
+            pendingZero = (data != 0xFF);
+            remain = data - 1;
+        }
+        else {
+            // ブロック内データ
+            put(data);
+            remain--;
+        }
+        return RESULT_CONTINUE;
+    }
+
+    // 区切りコード受信 フレーム終了
+    if ((length == 0) && (remain == 0) && !pendingZero) {
+        // 空フレーム
+        result = RESULT_EMPTY;
+    }
+    else if (remain != 0) {
+        // ブロック途中で終了した
+        result = RESULT_ERR_FORMAT;
+    }
+    else if (overflow) {
+        // バッファサイズ超過
+        result = RESULT_ERR_OVERFLOW;
+    }
+    else if ((length < COBS_FRAME_CRC_SIZE) || (crc != CRC16_RESIDUE)) {
+        // CRCなし または CRC不一致
+        result = RESULT_ERR_CRC;
+    }
+    else {
+        // フレーム受信完了
+        result = RESULT_FRAME_OK;
+    }
+
+    // 次のフレームに備えて状態を初期化する（格納先は維持し、受信完了したフレームの長さは GetLength 用に残す）
+    size_t  decoded = length;
+    Reset(_buff, _size);
+    frameLength = (result == RESULT_FRAME_OK) ? decoded : 0;
+
+    return result;
+}
+
+// デコードしたペイロード長（CRCを除く）取得
+size_t CobsFrameParser::GetLength() const
+{
+    return (frameLength >= COBS_FRAME_CRC_SIZE) ? (frameLength - COBS_FRAME_CRC_SIZE) : 0;
+}
+
+// デコード結果１バイト格納
+void CobsFrameParser::put(uint8_t data)
+{
+    crc = Crc16Update(crc, data);
+    if (length < _size) {
+        _buff[length++] = data;
+    }
+    else {
+        overflow = true;
+    }
+}
+
+// フレームエンコード
+size_t CobsFrameParser::Encode(const uint8_t *payload, size_t length, uint8_t *dst, size_t dstSize)
+{
+    uint16_t    crcValue;       // ペイロードの CRC-16
+    uint8_t     crcBytes[COBS_FRAME_CRC_SIZE];  // CRC-16（ビッグエンディアン）
+    size_t      out;            // 出力位置
+    size_t      codePos;        // 現在のブロックのコードバイト位置
+    uint8_t     code;           // 現在のブロックのコード値
+
+    if (dstSize < COBS_ENCODED_MAX(length + COBS_FRAME_CRC_SIZE) + 2) {
+        // 格納先サイズ不足
+        return 0;
+    }
+
+    crcValue = Crc16Calc(payload, length);
+    crcBytes[0] = (uint8_t)(crcValue >> 8);
+    crcBytes[1] = (uint8_t)crcValue;
+
+    out = 0;
+    dst[out++] = COBS_FRAME_DELIMITER;
+    codePos = out++;
+    code = 1;
+    for (size_t i = 0; i < length + COBS_FRAME_CRC_SIZE; i++) {
+        uint8_t data = (i < length) ? payload[i] : crcBytes[i - length];
+        if (data == 0x00) {
+            // ブロック終了
+            dst[codePos] = code;
+            codePos = out++;
+            code = 1;
+            continue;
+        }
+        dst[out++] = data;
+        code++;
+        if (code == 0xFF) {
+            // 最大長ブロック
+            dst[codePos] = code;
+            codePos = out++;
+            code = 1;
+        }
+    }
+    dst[codePos] = code;
+    dst[out++] = COBS_FRAME_DELIMITER;
+
+    return out;
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * @file       CommandTimeline.cpp
+ * @brief      コマンドタイムライン
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    実行時刻と登録順をキーとする最小ヒープで予約コマンドを管理し、実行時刻に達したものから取り出す
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <string.h>
+#include "CommandTimeline.h"
+
+// コンストラクタ
+CommandTimelineBase::CommandTimelineBase(Node *heap, uint16_t *freeSlots, char *texts, uint16_t capacity, uint16_t textSize)
+{
+    _heap = heap;                           // ヒープ
+    _freeSlots = freeSlots;                 // 空きコマンド文字列スロット番号スタック
+    _texts = texts;                         // コマンド文字列スロット領域
+    _capacity = capacity;                   // 登録可能コマンド数
+    _textSize = textSize;                   // コマンド文字列スロットサイズ
+    Clear();
+}
+
+// 全コマンド削除
+void CommandTimelineBase::Clear()
+{
+    _count = 0;                             // 登録コマンド数
+    _seq = 0;                               // 次の登録順序番号
+    // すべてのスロットを空きスロットとする（小さい番号から使う）
+    for (uint16_t index = 0; index < _capacity; index++) {
+        _freeSlots[index] = (uint16_t)(_capacity - 1 - index);
+    }
+}
+
+// コマンド登録
+CommandTimelineBase::RESULT CommandTimelineBase::Add(uint32_t runTime, const char *command)
+{
+    size_t  length;         // コマンド長
+
+    if (command == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+    length = strlen(command);
+    if (length >= _textSize) {
+        // コマンドが長すぎる
+        return RESULT_ERR_TOO_LONG;
+    }
+    if (_count >= _capacity) {
+        // 登録数が上限に達している
+        return RESULT_ERR_FULL;
+    }
+
+    // 空きスロットにコマンド文字列を格納する（空きスロット数 = 登録可能数 - 登録数）
+    uint16_t slot = _freeSlots[_capacity - 1 - _count];
+    memcpy(_texts + ((size_t)slot * _textSize), command, length + 1);
+
+    // ヒープ末尾に追加して上方移動する
+    _heap[_count].runTime = runTime;
+    _heap[_count].seq = _seq++;
+    _heap[_count].slot = slot;
+    _count++;
+    siftUp(_count - 1);
+
+    return RESULT_SUCCESS;
+}
+
+// 実行時刻に達したコマンドの取り出し
+CommandTimelineBase::RESULT CommandTimelineBase::PopDue(uint32_t now, char *command, size_t size, uint32_t *runTime)
+{
+    if ((command == NULL) || (size == 0)) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+    if (_count == 0) {
+        // 登録コマンドなし
+        return RESULT_EMPTY;
+    }
+    if (_heap[0].runTime > now) {
+        // 先頭（最も早い）コマンドが実行時刻に達していない
+        return RESULT_NOT_DUE;
+    }
+
+    // 先頭コマンドを呼び出し元バッファにコピーする
+    const char *text = _texts + ((size_t)_heap[0].slot * _textSize);
+    size_t length = strlen(text);
+    if (length >= size) {
+        length = size - 1;
+    }
+    memcpy(command, text, length);
+    command[length] = '\0';
+    if (runTime != NULL) {
+        *runTime = _heap[0].runTime;
+    }
+
+    // スロットを空きスロットに戻し、末尾要素を先頭に移して下方移動する
+    _count--;
+    _freeSlots[_capacity - 1 - _count] = _heap[0].slot;
+    if (_count > 0) {
+        _heap[0] = _heap[_count];
+        siftDown(0);
+    }
+
+    return RESULT_SUCCESS;
+}
+
+// 最も早い実行時刻の取得
+bool CommandTimelineBase::PeekTime(uint32_t *runTime) const
+{
+    if (_count == 0) {
+        // 登録コマンドなし
+        return false;
+    }
+    if (runTime != NULL) {
+        *runTime = _heap[0].runTime;
+    }
+    return true;
+}
+
+// 実行時刻順の列挙
+bool CommandTimelineBase::GetNext(const Entry *prev, Entry *next) const
+{
+    const Node  *found = NULL;      // 次の要素
+    Node        key;                // 直前の要素の比較キー
+
+    if (next == NULL) {
+        return false;
+    }
+    if (prev != NULL) {
+        key.runTime = prev->runTime;
+        key.seq = prev->seq;
+    }
+
+    // 直前の要素より後で最も早い要素を探す（ヒープは変更しない）
+    for (size_t index = 0; index < _count; index++) {
+        const Node &node = _heap[index];
+        if ((prev != NULL) && !before(key, node)) {
+            continue;
+        }
+        if ((found == NULL) || before(node, *found)) {
+            found = &node;
+        }
+    }
+    if (found == NULL) {
+        // 列挙終了
+        return false;
+    }
+
+    next->runTime = found->runTime;
+    next->seq = found->seq;
+    next->command = _texts + ((size_t)found->slot * _textSize);
+    return true;
+}
+
+// ヒープ上方移動
+void CommandTimelineBase::siftUp(size_t index)
+{
+    Node    node = _heap[index];    // 移動する要素
+
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!before(node, _heap[parent])) {
+            break;
+        }
+        _heap[index] = _heap[parent];
+        index = parent;
+    }
+    _heap[index] = node;
+}
+
+// ヒープ下方移動
+void CommandTimelineBase::siftDown(size_t index)
+{
+    Node    node = _heap[index];    // 移動する要素
+
+    while (true) {
+        size_t child = (index * 2) + 1;
+        if (child >= _count) {
+            break;
+        }
+        if (((child + 1) < _count) && before(_heap[child + 1], _heap[child])) {
+            // 右の子の方が早い
+            child++;
+        }
+        if (!before(_heap[child], node)) {
+            break;
+        }
+        _heap[index] = _heap[child];
+        index = child;
+    }
+    _heap[index] = node;
+}
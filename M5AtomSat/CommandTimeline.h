@@ -0,0 +1,110 @@
+/******************************************************************************
+ * @file       CommandTimeline.h
+ * @brief      コマンドタイムライン ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    実行時刻を指定して登録したコマンドを、実行時刻の早い順に取り出す予約コマンド表（最小ヒープ）のクラス定義
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _COMMAND_TIMELINE_H_
+#define _COMMAND_TIMELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// コマンドタイムライン 共通部（ヒープ・コマンド文字列の領域は派生クラス CommandTimeline<MaxEntries, MaxCommand> が持つ）
+class CommandTimelineBase
+{
+public:
+
+    enum RESULT {                           // コマンドタイムライン処理結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_NOT_DUE,                     // 実行時刻に達したコマンドなし
+        RESULT_EMPTY,                       // 登録コマンドなし
+        RESULT_ERR_FULL,                    // 登録数が上限に達している
+        RESULT_ERR_TOO_LONG,                // コマンドが長すぎる
+        RESULT_ERR_ARGS,                    // 引数エラー
+        RESULT_NUM                          // コマンドタイムライン処理結果数
+    };
+
+    struct Entry {                          // 登録コマンド（列挙用）
+        uint32_t            runTime;        // 実行時刻
+        uint32_t            seq;            // 登録順序番号（同一実行時刻は登録順に実行する）
+        const char          *command;       // コマンド文字列へのポインタ（タイムライン内の領域を参照）
+    };
+
+    // コマンド登録（O(log n)）
+    RESULT Add(uint32_t runTime, const char *command);
+    // 実行時刻に達したコマンドの取り出し（O(log n)、now 以前の最も早いコマンドを１件取り出す）
+    RESULT PopDue(uint32_t now, char *command, size_t size, uint32_t *runTime = NULL);
+    // 最も早い実行時刻の取得（登録コマンドなしは false）
+    bool PeekTime(uint32_t *runTime) const;
+    // 実行時刻順の列挙（prev が NULL なら先頭、以降は直前に取得した要素を渡す、１件あたり O(n)）
+    bool GetNext(const Entry *prev, Entry *next) const;
+    // 全コマンド削除
+    void Clear();
+    // 登録コマンド数取得
+    size_t Count() const { return _count; }
+    // 登録可能コマンド数取得
+    size_t Capacity() const { return _capacity; }
+
+protected:
+    struct Node {                           // ヒープ要素（比較キーを持ち、文字列は参照しない）
+        uint32_t            runTime;        // 実行時刻
+        uint32_t            seq;            // 登録順序番号
+        uint16_t            slot;           // コマンド文字列スロット番号
+    };
+
+    // コンストラクタ（派生クラスから領域を渡す）
+    CommandTimelineBase(Node *heap, uint16_t *freeSlots, char *texts, uint16_t capacity, uint16_t textSize);
+
+private:
+    Node                    *_heap;         // ヒープ（実行時刻・登録順の最小ヒープ）
+    uint16_t                *_freeSlots;    // 空きコマンド文字列スロット番号スタック
+    char                    *_texts;        // コマンド文字列スロット領域
+    uint16_t                _capacity;      // 登録可能コマンド数
+    uint16_t                _textSize;      // コマンド文字列スロットサイズ（'\0'終端を含む）
+    uint16_t                _count;         // 登録コマンド数
+    uint32_t                _seq;           // 次の登録順序番号
+
+    // ヒープ順序比較（a が b より先に実行される）
+    static bool before(const Node &a, const Node &b)
+    {
+        return (a.runTime != b.runTime) ? (a.runTime < b.runTime) : (a.seq < b.seq);
+    }
+    // ヒープ上方移動
+    void siftUp(size_t index);
+    // ヒープ下方移動
+    void siftDown(size_t index);
+};
+
+// コマンドタイムライン（MaxEntries : 登録可能コマンド数、MaxCommand : コマンド最大長[byte]）
+// ヒープ・コマンド文字列の領域をインスタンス内に静的に確保する
+template <size_t MaxEntries, size_t MaxCommand>
+class CommandTimeline : public CommandTimelineBase
+{
+public:
+    static_assert(MaxEntries >= 1, "CommandTimeline MaxEntries must be at least 1");
+    static_assert(MaxEntries <= 0xFFFF, "CommandTimeline MaxEntries must fit in 16 bits");
+    static_assert((MaxCommand >= 1) && (MaxCommand < 0xFFFF), "CommandTimeline MaxCommand is out of range");
+
+    static constexpr size_t TEXT_SIZE = MaxCommand + 1;     // コマンド文字列スロットサイズ（'\0'終端を含む）
+
+    // 領域のバイト数（コンパイル時に確定、static_assert で RAM 予算を検査できる）
+    static constexpr size_t StorageSize()
+    {
+        return MaxEntries * (sizeof (Node) + sizeof (uint16_t) + TEXT_SIZE);
+    }
+
+    // コンストラクタ
+    CommandTimeline() : CommandTimelineBase(heapStorage, freeStorage, textStorage, MaxEntries, TEXT_SIZE) {}
+
+private:
+    Node                    heapStorage[MaxEntries];                // ヒープ領域
+    uint16_t                freeStorage[MaxEntries];                // 空きスロット番号スタック領域
+    char                    textStorage[MaxEntries * TEXT_SIZE];    // コマンド文字列スロット領域
+};
+#endif /* _COMMAND_TIMELINE_H_ */
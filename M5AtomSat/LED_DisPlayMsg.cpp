@@ -7,6 +7,9 @@
  * @date       2021/09/09 v1.00 新規作成
  * @date       2021/09/09 v1.01 LED 横×縦サイズ設定追加（M5Atom Library v0.0.5 対応）
  * @date       2021/09/20 v1.02 初期化に LED 横×縦サイズ パラメータ設定機能追加
+ * @date       2026/10/16 v1.03 ログ・プロパティ出力先設定追加
+ * @date       2026/10/16 v1.04 タスク駆動周期の delay を固定位相の周期実行（TaskPeriod）に変更
+ *                              表示処理の時間で１文字の表示時間が伸びない。周期超過で飛ばした周期も経過時間に加える
  * @par     
  * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
  ******************************************************************************/
@@ -21,6 +24,7 @@ LED_DisPlayMsg::LED_DisPlayMsg(LED_DisPlayMsg::LOG_LEVEL logLevel)
 {
     // LEDメッセージ表示初期化
     _logLevel = logLevel;                   // ログ出力レベル
+    _out = &Serial;                         // ログ出力先
     init = false;                           // 初期化済フラグ
     _length = 0;                            // 最大表示文字数
     _callback  = 0;                         // コールバック関数へポインタ
@@ -59,38 +63,38 @@ void LED_DisPlayMsg::DispProperties()
         return;
     }
 
-    Serial.println("LED DisPlayMsg value of object.");
+    _out->println("LED DisPlayMsg value of object.");
 
     // 初期化済フラグ
-    Serial.printf("init : %d\n", init);
+    _out->printf("init : %d\n", init);
     // 最大表示文字数
-    Serial.printf("params.length : %d\n", _length);
+    _out->printf("params.length : %d\n", _length);
     // コールバック関数へポインタ
-    Serial.printf("params.callback : %08X\n", _callback);
+    _out->printf("params.callback : %08X\n", _callback);
     // LEDメッセージ表示タイプ
-    Serial.printf("params.type : %d\n", _type);
+    _out->printf("params.type : %d\n", _type);
     // １文字の表示時間[ms]
-    Serial.printf("params.period : %d\n", _period);
+    _out->printf("params.period : %d\n", _period);
     // 表示メッセージ文字列
-    Serial.printf("msgBuff : %08X\n", msgBuff);
+    _out->printf("msgBuff : %08X\n", msgBuff);
     if (msgBuff) {
-        Serial.printf("msg : '%s'\n", msgBuff);
+        _out->printf("msg : '%s'\n", msgBuff);
     }
     else {
-        Serial.println("msg : None\n");
+        _out->println("msg : None\n");
     }
     // 表示メッセージ文字列長
-    Serial.printf("size : %d\n", size);
+    _out->printf("size : %d\n", size);
     // メッセージ表示インデックス
-    Serial.printf("index : %d\n", index);
+    _out->printf("index : %d\n", index);
     // LED表示メッセージ表示カラー
-    Serial.printf("color : %d, %d, %d\n", color.r, color.g, color.b);
+    _out->printf("color : %d, %d, %d\n", color.r, color.g, color.b);
     // タスク駆動周期[ms]
-    Serial.printf("_task_period : %d\n", _task_period);
+    _out->printf("_task_period : %d\n", _task_period);
     // タスク駆動中
-    Serial.printf("running : %d\n", running);
+    _out->printf("running : %d\n", running);
     // LEDメッセージ表示状態
-    Serial.printf("status : %d\n", status);
+    _out->printf("status : %d\n", status);
 }
 
 // LEDメッセージ表示オブジェクト初期化
@@ -257,6 +261,18 @@ LED_DisPlayMsg::RESULT LED_DisPlayMsg::DispClear()
     return RESULT_SUCCESS;
 }
 
+// ログ・プロパティ出力先設定
+void LED_DisPlayMsg::SetOutput(Print *out)
+{
+    _out = (out != NULL) ? out : &Serial;
+}
+
+// 周期実行統計情報取得
+void LED_DisPlayMsg::GetPeriodStats(TaskPeriod::Stats *stats) const
+{
+    _taskPeriod.GetStats(stats);
+}
+
 void LED_DisPlayMsg::run(void *data)
 {
     uint16_t    scroll_col = 0;     // スクロール表示カラムインデックス
@@ -271,6 +287,8 @@ void LED_DisPlayMsg::run(void *data)
     DispClear();      // LED表示クリア
     // タスク駆動中セット
     running = true;
+    // タスク駆動周期の起点
+    _taskPeriod.Start(_task_period);
 
     while (1)
     {
@@ -365,8 +383,12 @@ void LED_DisPlayMsg::run(void *data)
                 }
             }   
         }
-        delay(_task_period);
-        elapseTime += _task_period;   // 経過時間加算
+        // 次のタスク駆動周期まで待つ（表示メッセージ設定で周期が変わったら、同じ位相から新しい周期とする）
+        if (_taskPeriod.Period() != (uint32_t)_task_period) {
+            _taskPeriod.SetPeriod(_task_period);
+        }
+        uint32_t periods = _taskPeriod.Wait();
+        elapseTime += _task_period * periods;   // 経過時間加算
         if (elapseTime >= _period) {
             // １文字の表示時間[ms]経過
             // 経過時間クリア
@@ -491,6 +513,6 @@ void LED_DisPlayMsg::logOutput(LED_DisPlayMsg::LOG_LEVEL logLevel, char *logMsg)
 {
     if (logLevel <= _logLevel) {
         // ログ出力レベルが規定値以下
-        Serial.print(logMsg);
+        _out->print(logMsg);
     }
 }
@@ -6,6 +6,8 @@
  * @details    LEDメッセージ表示のクラス定義
  * @date       2021/09/09 v1.00 新規作成
  * @date       2021/09/20 v1.01 初期化メソッド(Init)に LED 横×縦サイズ パラメータ追加
+ * @date       2026/10/16 v1.02 ログ・プロパティ出力先設定追加
+ * @date       2026/10/16 v1.03 タスク駆動周期を固定位相の周期実行（TaskPeriod）とし、周期実行統計取得を追加
  * @par     
  * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
  ******************************************************************************/
@@ -16,6 +18,7 @@
 #include <functional>
 #include <M5Atom.h>
 #include "utility/LED_DisPlay.h"
+#include "TaskPeriod.h"
 
 #define LED_MATRIX_ROW      5               // LEDマトリクス 行数
 #define LED_MATRIX_COL      5               // LEDマトリクス 列数
@@ -94,6 +97,10 @@ public:
     RESULT DispStart();
     // LED表示クリア
     RESULT DispClear();
+    // ログ・プロパティ出力先設定（既定は Serial）
+    void SetOutput(Print *out);
+    // 周期実行統計情報取得（タスク駆動周期・実測周波数・周期超過・周期ジッタ分布）
+    void GetPeriodStats(TaskPeriod::Stats *stats) const;
 
 private:
     bool                    init;           // 初期化済フラグ
@@ -111,7 +118,9 @@ private:
     CRGB                    matrix[LED_MATRIX_ROW][LED_MATRIX_COL];     // 文字表示マトリクスデータ
     uint16_t                colIndex;       // 文字表示マトリクスカラムインデックス
     int                     _task_period;   // タスク駆動周期[ms]
+    TaskPeriod              _taskPeriod;    // タスク駆動周期の周期実行
     LOG_LEVEL               _logLevel;      // ログ出力レベル
+    Print                   *_out;          // ログ・プロパティ出力先
 
     // 1文字表示
     RESULT dispChr(int8_t chr, CRGB _color);
@@ -7,6 +7,27 @@
  * @details    人工衛星を模擬しシリアル通信による疑似コマンド入力・テレメトリ出力、および簡単なミッションを行う
  * @date       2021/09/09 v0.10 新規作成 シリアル受信機能のみ
  * @date       2021/09/20 v1.00 疑似コマンド・テレメトリ機能、LEDマトリクス表示機能追加
+ * @date       2026/10/16 v1.01 コマンド処理をコマンド定義表による振り分けに変更
+ * @date       2026/10/16 v1.02 受信コマンドの即時実行、コマンド実行遅延統計("cmdstat")追加
+ * @date       2026/10/16 v1.03 COBS＋CRC-16 フレームによるコマンド受信に対応
+ * @date       2026/10/16 v1.04 シリアル受信統計出力("rxstat")追加
+ * @date       2026/10/16 v1.05 シリアル受信の最大メッセージ長・キュー数をコンパイル時に指定し、RAM使用量を検査
+ * @date       2026/10/16 v1.06 実行時刻指定コマンド("at")、予約コマンド一覧("timeline")追加
+ * @date       2026/10/16 v1.07 地上局リンク・ペイロードリンクを１つの受信タスクで受信、コマンドに受信ポート番号を付加
+ * @date       2026/10/16 v1.08 バイナリテレメトリフレーム出力、テレメトリ形式切替("tlmfmt")追加
+ * @date       2026/10/16 v1.09 テレメトリ文字列を sprintf を使わず固定小数点から生成
+ * @date       2026/10/16 v1.10 テレメトリ記録（RAM・フラッシュ）、記録テレメトリ出力("tlmdump")追加
+ * @date       2026/10/16 v1.11 シリアル出力を送信タスク(SerialTransmit)に集約、送信統計出力("txstat")追加
+ * @date       2026/10/16 v1.12 テレメトリチャネル毎の出力周期設定("tlmrate")追加
+ * @date       2026/10/16 v1.13 差分圧縮テレメトリフレーム出力("tlmfmt delta")、圧縮統計出力("deltastat")追加
+ * @date       2026/10/16 v1.14 テレメトリ項目をチャネル定義表(TelemetryChannels.h)から生成、項目一覧出力("tlmdict")追加
+ * @date       2026/10/16 v1.15 姿勢情報・内部温度を同じサンプルのスナップショットから収集
+ * @date       2026/10/16 v1.16 姿勢区間統計チャネル（"tlmrate attstats"、Pitch, Roll の最小・最大・平均・分散）追加
+ * @date       2026/10/16 v1.17 姿勢情報 Yaw 出力（ジャイロ・加速度の姿勢推定フィルタによる）
+ * @date       2026/10/16 v1.18 IMU の FIFO 一括取得（IMU_FIFO_ENABLE）、IMU 取得統計出力("imustat")追加
+ * @date       2026/10/16 v1.19 各タスクの周期を固定位相の周期実行に変更、周期実行統計出力("taskstat")追加
+ * @date       2026/10/16 v1.20 コマンドエラー表示でコマンド行全体を出力する（振り分けはコマンド行の写しで行う）
+ * @date       2026/10/16 v1.21 テレメトリ記録のフラッシュ退避をテレメトリ収集から外し、ループ毎に最大１ブロックとする
  * @par     
  * @copyright  なし
  ******************************************************************************/
@@ -23,8 +44,39 @@
   *        シリアルポートへのテレメトリ出力を停止する
   *     3) "temp" 内部温度をLEDに表示する
   *        加速度・ジャイロセンサ（MPU6886）内部温度をLEDに表示する
+  *     4) "cmdstat" コマンド実行遅延統計を出力する
+  *        コマンド受信から実行開始までの遅延（直近128件）のパーセンタイルを出力する
+  *     5) "rxstat" シリアル受信統計を出力する
+  *        受信バイト数・行数・破棄数・キュー最大使用数・キュー滞留時間分布を出力する
+  *     6) "at <run_time> <command>" 実行時刻を指定してコマンドを予約する
+  *        起動からの経過時間(秒)が run_time に達したときに command を実行する（最大TIMELINE_CAPACITY件）
+  *     7) "timeline [count]" 予約コマンドを実行時刻順に出力する（既定TIMELINE_LIST_DEFAULT件）
+  *     8) "tlmfmt bin|text|delta" テレメトリ出力形式を切り替える
+  *        bin : 同期ワード・CRC-16 付きの固定小数点バイナリフレーム(TLM_FRAME_SIZEバイト)、text : ASCII文字列（既定）
+  *        delta : 直前のフレームとの差分を可変長整数で格納する圧縮フレーム（TLM_DELTA_KEY_INTERVALフレーム毎にキーフレーム）
+  *     9) "tlmdump [from] [to]" 記録したテレメトリを出力する
+  *        テレメトリ番号 from〜to（省略時は記録の先頭〜末尾）を現在のテレメトリ出力形式で出力する
+  *        送信レコードの空きの分だけループ毎に出力し、ループを待たせない
+  *    10) "txstat" シリアル送信統計を出力する
+  *        送信レコード投入数・送信バイト数・破棄数・送信待ち数／最大数を出力する
+  *    11) "tlmrate [channel] [hz]" テレメトリチャネルの出力周波数を設定する
+  *        channel : time|attitude|temp|counters|attstats、hz : 出力周波数[Hz]（0 は出力しない）
+  *        回線使用量の見積もりが予算（TLM_LINK_BUDGET[%]）を超える設定は拒否する。引数省略時は設定を出力する
+  *    12) "deltastat" 差分圧縮テレメトリの統計を出力する
+  *        符号化フレーム数・キーフレーム数・圧縮しない場合との比・１フレームあたりの符号化時間を出力する
+  *    13) "tlmdict" テレメトリ項目一覧を出力する
+  *        チャネル定義表の各チャネルのビット、各項目の番号・名前・チャネル・型・サイズ・倍率・単位・項目名を出力する
+  *    14) "imustat" IMU 取得統計を出力する
+  *        取得方式と、FIFO 一括取得では読み出し回数・サンプル数・I2C トランザクション数・FIFO 溢れ回数・最大一括数を出力する
+  *    15) "taskstat" 周期実行統計を出力する
+  *        周期実行するタスク（姿勢情報取得・LEDメッセージ表示・シリアル受信）毎に、周期・実測周波数・起床回数・
+  *        周期超過回数・周期ジッタ（平均・最大・log2 区間の分布）を出力する
+  *     受信したコマンドは受信通知を受けて即時に実行する
+  *     PAYLOAD_LINK_ENABLE を 1 にすると Grove 端子の Serial2 をペイロードリンクとして受信し、
+  *     地上局リンク(USBシリアル)と同じ受信タスク(SerialReceiveMux)で処理する。コマンドには受信ポート番号が渡される
+  *     0x00 で始まるメッセージは COBS＋CRC-16 フレームとしてデコードし、CRC正常ならペイロードをコマンドとして処理する
   * (3) テレメトリ出力機能
-  *     マイコンの状態をTLM_INTERVAL(秒)毎にシリアルポート(115200bps)に出力する
+  *     マイコンの状態をチャネル毎の出力周期でシリアルポート(115200bps)に出力する（既定は全チャネルTLM_INTERVAL(秒)毎）
   *     テレメトリデータの収集(getTelemetryData)は起動後から行うが、
   *     テレメトリ出力(setTelemetryMsg)は起動からIMER_CMD_RECV_EN(秒)経過後に開始する
   *     "tlmon", "tlmoff"コマンドでテレメトリ出力をON/OFFできる
@@ -33,9 +85,25 @@
   *     2) 起動からの経過時間（時：分：秒）
   *     3) 姿勢情報 Pitch
   *     4) 姿勢情報 Roll
-  *     5) 姿勢情報 Yaw　（MPU6886からは取得不可）
+  *     5) 姿勢情報 Yaw　（起動時の向きからのジャイロ積分値）
   *     6) 加速度・ジャイロセンサ(MPU6886)内部温度
-  * (4) LED秒数ドット表示機能
+  *     7) カウンタ（コマンド実行数、送信破棄数）　（既定は出力しない）
+  *     8) 姿勢区間統計（前回出力からの Pitch, Roll の最小・最大・平均・分散、サンプル数）　（既定は出力しない）
+  *        姿勢情報取得タスクがサンプル毎に更新し（FIFO 一括取得では読み出した全サンプル）、このチャネルを出力する時に取得してリセットする
+  *     出力する項目はテレメトリチャネル定義表(TelemetryChannels.h の TelemetryFields)で定義し、
+  *     文字列・フレーム・差分圧縮フレームの生成と各形式の最大サイズは定義表から生成する
+  *     "tlmfmt bin" でバイナリフレームに切り替えると、姿勢情報・温度を 0.01 単位の整数で出力する（TelemetryFrame.h 参照）
+  *     "tlmfmt delta" で差分圧縮フレームに切り替えると、出力するチャネルを直前のフレームとの差分で出力する（TelemetryDelta.h 参照）
+  *     出力時刻に達したチャネルが 2)〜6) のちょうど全部なら従来形式（"TLM"行・0xEB90 フレーム）、
+  *     それ以外はチャネル別形式（"TLMC"行・0xEB91 フレーム）で、同時期に達したチャネルを１つにまとめて出力する
+  *     収集したテレメトリは出力の有無（コマンド受信許可前、"tlmoff"）にかかわらず RAM に TLM_RECORD_CAPACITY 件記録する
+  *     テレメトリ番号の更新・記録は 2)〜6) のいずれかのチャネルの出力時刻毎に行う（カウンタ・姿勢区間統計だけの出力時刻では行わない）
+  *     TLM_RECORD_SPILL_ENABLE を 1 にすると、LittleFS のファイルに TLM_RECORD_FLASH_NUM 件まで退避する
+  *     フラッシュへの書き込みはループ毎に最大１ブロック（TLM_RECORD_SPILL_BLOCK 件）とし、テレメトリ収集では書き込まない
+  * (4) シリアル出力
+  *     テレメトリ・コマンド応答・各タスクのログは送信タスク(SerialTransmit)に書式変換済みのレコードとして投入し、
+  *     送信タスクだけがシリアルポートに出力する。投入側は待たず、空きがなければ破棄して破棄数を数える
+  * (5) LED秒数ドット表示機能
   *     25個のLEDを用い、0〜49秒を表す(setLedSecDotDisp)
   *     ここで言う秒は、起動からの経過時間を50で割った余りである
   *         0秒      : 全消灯
@@ -43,9 +111,12 @@
   *         25秒     : 全点灯
   *         26〜49秒 : 上から１行ずつ左から右へ１個ずつ消灯していく
   *     温度表示中は秒数ドット表示を行わない
-  * (5) LEDメッセージ温度表示機能
+  * (6) LEDメッセージ温度表示機能
   *     加速度・ジャイロセンサの内部温度をLEDマトリスクスにスクロール表示する(dispTemp)
   *     温度カラーテーブル(temp_col_tbl)を用い、音頭によって表示する色カラーを変えることができる
+  * (7) タスクの周期実行
+  *     姿勢情報取得・LEDメッセージ表示・シリアル受信（ポーリング）のタスクは TaskPeriod（vTaskDelayUntil）で固定位相の周期実行を行う
+  *     周期・実測周波数・周期超過・周期ジッタは "taskstat" で出力する
  ******************************************************************************/
 
 #include "M5Atom.h"
@@ -53,6 +124,15 @@
 #include "SerialReceive.h"
 #include "Attitude.h"
 #include "LED_DisPlayMsg.h"
+#include "CommandDispatcher.h"
+#include "CommandTimeline.h"
+#include "TelemetryChannels.h"
+#include "TelemetryFrame.h"
+#include "TelemetryText.h"
+#include "TelemetryRecorder.h"
+#include "TelemetryScheduler.h"
+#include "TelemetryDelta.h"
+#include "SerialTransmit.h"
 
 // タイマー
 M5Timer         timer;                          // M5Timer オブジェクト生成
@@ -64,18 +144,67 @@ uint32_t        run_time = 0;                   // 起動後の経過時間(秒)
 #define         TIMER_CMD_RECV_EN   30          // コマンド受信許可タイマー[秒]
 bool            cmd_recv_enable = false;        // コマンド受信許可フラグ
 
+// シリアル送信
+// 全タスクのシリアル出力を送信タスクに集約する（投入側は待たない）
+#define         SERIAL_TX_RECORD_SIZE   128     // 送信レコードサイズ[byte]
+#define         SERIAL_TX_QUEUE_NUM     32      // 送信レコード数（2のべき乗）
+#define         SERIAL_TX_RAM_MAX       4352    // 送信レコード領域の上限[byte]
+typedef SerialTransmit<SERIAL_TX_RECORD_SIZE, SERIAL_TX_QUEUE_NUM> SatSerialTransmit;
+static_assert(SatSerialTransmit::StorageSize() <= SERIAL_TX_RAM_MAX, "SerialTransmit storage exceeds SERIAL_TX_RAM_MAX");
+SatSerialTransmit   serialTransmitter;          // シリアル送信（全タスク共通）
+
 // シリアル受信
-SerialReceive   serialReceiver(SerialReceive::LOG_INFO);        // シリアル受信クラスインスタンス生成
-char            seralReceiveBuff[SERIAL_RECEIVE_BUFF_SIZE];     // シリアル受信バッファ
+#define         SERIAL_RECV_LINE_MAX    127     // シリアル受信 最大メッセージ長[byte]
+#define         SERIAL_RECV_QUEUE_NUM   4       // シリアル受信 メッセージキュー数
+#define         SERIAL_RECV_RAM_MAX     1280    // シリアル受信 バッファ・キュー領域の上限[byte]（１ポートあたり）
+#define         SERIAL_PORT_GROUND      0       // 地上局リンク（USBシリアル）ポート番号
+#define         SERIAL_PORT_PAYLOAD     1       // ペイロードリンク（Grove端子 Serial2）ポート番号
+#define         PAYLOAD_LINK_ENABLE     0       // ペイロードリンク 1=使用する 0=使用しない
+#define         PAYLOAD_LINK_BAUD       115200  // ペイロードリンク 通信速度[bps]
+#define         PAYLOAD_LINK_RX_PIN     32      // ペイロードリンク 受信端子（Grove G32）
+#define         PAYLOAD_LINK_TX_PIN     26      // ペイロードリンク 送信端子（Grove G26）
+typedef SerialReceive<SERIAL_RECV_LINE_MAX, SERIAL_RECV_QUEUE_NUM> SatSerialReceive;
+static_assert(SatSerialReceive::StorageSize() <= SERIAL_RECV_RAM_MAX, "SerialReceive storage exceeds SERIAL_RECV_RAM_MAX");
+SatSerialReceive    serialReceiver(SerialReceiveBase::LOG_INFO);    // 地上局リンク シリアル受信クラスインスタンス生成
+#if PAYLOAD_LINK_ENABLE
+SatSerialReceive    payloadReceiver(SerialReceiveBase::LOG_INFO);   // ペイロードリンク シリアル受信クラスインスタンス生成
+#endif
+SerialReceiveMux    serialReceiveMux(SerialReceiveBase::LOG_INFO);  // シリアル受信タスク（全ポート共通）
+
+// コマンド実行遅延統計
+// コマンド受信から実行開始までの遅延を直近CMD_LAT_SAMPLE_NUM件保持し、"cmdstat"コマンドでパーセンタイルを出力する
+#define         CMD_LAT_SAMPLE_NUM  128         // コマンド実行遅延サンプル数
+uint32_t        cmd_latency[CMD_LAT_SAMPLE_NUM];    // コマンド実行遅延サンプル[us]
+int             cmd_latency_index = 0;          // コマンド実行遅延サンプル格納インデックス
+uint32_t        cmd_exec_count = 0;             // コマンド実行回数
+uint32_t        cmd_recv_time = 0;              // 実行中コマンドの受信時刻[us]
+uint32_t        cmd_exec_time = 0;              // 実行中コマンドの実行開始時刻[us]
+
+// コマンドタイムライン
+// "at"コマンドで予約したコマンドを実行時刻（起動からの経過時間[秒]）の早い順に保持する
+#define         TIMELINE_CAPACITY       128     // 予約コマンド最大数
+#define         TIMELINE_CMD_MAX        47      // 予約コマンド最大長[byte]
+#define         TIMELINE_RAM_MAX        8192    // 予約コマンド領域の上限[byte]
+#define         TIMELINE_LIST_DEFAULT   10      // "timeline"コマンド既定出力件数
+typedef CommandTimeline<TIMELINE_CAPACITY, TIMELINE_CMD_MAX> SatCommandTimeline;
+static_assert(SatCommandTimeline::StorageSize() <= TIMELINE_RAM_MAX, "CommandTimeline storage exceeds TIMELINE_RAM_MAX");
+SatCommandTimeline  cmdTimeline;                // コマンドタイムライン
+char            timeline_cmd[SatCommandTimeline::TEXT_SIZE];    // 実行する予約コマンド
+extern CommandDispatcher    cmdDispatcher;      // コマンドディスパッチャ（コマンド定義表の後で定義）
 
 // 姿勢情報取得
+#define         IMU_FIFO_ENABLE         1       // IMU の FIFO 一括取得 1=使用する 0=使用しない（サンプル毎にレジスタから取得）
+#define         IMU_FIFO_RATE           1000    // FIFO 一括取得のサンプリング周波数[Hz]（1000 を割り切れる値）
+#define         IMU_FIFO_PERIOD         20      // FIFO 一括取得の取得周期[ms]（FIFO が溢れない 73 サンプル分未満とする）
+static_assert(IMU_FIFO_PERIOD * IMU_FIFO_RATE < ATTITUDE_FIFO_BATCH_MAX * 1000, "IMU_FIFO_PERIOD overflows the MPU6886 FIFO");
 Attitude        attitude(Attitude::LOG_INFO);   // 姿勢情報取得クラスインスタンス生成
 float           imu_pitch;                      // 姿勢 ピッチ
 float           imu_roll;                       // 姿勢 ロール
-float           imu_yaw;                        // 姿勢 ヨー（未使用）
+float           imu_yaw;                        // 姿勢 ヨー
 float           imu_arc;                        // 極座標角
 float           imu_val;                        // 大きさ
 float           imu_temp;                       // IMU（加速度・ジャイロセンサ）温度
+AttitudeSnapshot imu_stats;                     // 姿勢区間統計（最後に取得した区間）
 
 // LEDメッセージ表示
 LED_DisPlayMsg  ldm(LED_DisPlayMsg::LOG_INFO);  // LEDメッセージ表示クラスインスタンス生成
@@ -126,14 +255,61 @@ int             led_dot_disp_int_cnt = 0;       // LED秒数ドット表示イ
 bool            led_matrix[LED_MATRIX_ROW][LED_MATRIX_COL];     // LED秒数ドット表示マトリクス
 
 // テレメトリ出力
-// TLM_INTERVAL秒毎に姿勢情報と温度をテレメトリとして出力する
-#define         TLM_INTERVAL        10          // テレメトリ出力周期[s]
-#define         TLM_OUTPUT_MSG_SIZE 80          // テレメトリ出力メッセージバッファサイズ
+// チャネル毎の出力周期で姿勢情報・温度などをテレメトリとして出力する
+#define         TLM_INTERVAL        10          // テレメトリ出力周期[s]（時刻・姿勢・温度チャネルの既定値）
+#define         TLM_OUTPUT_MSG_SIZE 248         // テレメトリ出力メッセージバッファサイズ
+#define         TLM_LINK_BYTES      11520       // テレメトリ回線容量[byte/s]（115200bps、1文字10ビット）
+#define         TLM_LINK_BUDGET     50          // テレメトリに使う回線容量の割合[%]（残りはコマンド応答・ログ用）
+static_assert(TLM_OUTPUT_MSG_SIZE >= TLM_TEXT_SIZE_MAX, "TLM_OUTPUT_MSG_SIZE is smaller than TLM_TEXT_SIZE_MAX");
+static_assert(TLM_OUTPUT_MSG_SIZE >= TLM_TEXT_VALUES_SIZE_MAX, "TLM_OUTPUT_MSG_SIZE is smaller than TLM_TEXT_VALUES_SIZE_MAX");
+static_assert(TLM_OUTPUT_MSG_SIZE >= TLM_CH_TEXT_SIZE_MAX, "TLM_OUTPUT_MSG_SIZE is smaller than TLM_CH_TEXT_SIZE_MAX");
 bool            tlm_output_enable = false;      // テレメトリ出力許可フラグ [true=出力可能, false=出力不可]
-bool            tlm_output_flag = false;        // テレメトリ出力フラグ [true=出力，false=出力待ち]
-int             tlm_interval_counter = 0;       // テレメトリ出力インターバルカウンタ
 int             tlm_counter = 0;                // テレメトリ出力カウンタ
 char            tlm_output_msg[TLM_OUTPUT_MSG_SIZE];    // テレメトリ出力メッセージバッファ
+enum TLM_FORMAT {                               // テレメトリ出力形式（"tlmfmt"コマンドの列挙名表と同じ順序）
+    TLM_FORMAT_BIN = 0,                         // バイナリフレーム
+    TLM_FORMAT_TEXT,                            // ASCII文字列
+    TLM_FORMAT_DELTA,                           // 差分圧縮フレーム
+    TLM_FORMAT_NUM                              // テレメトリ出力形式数
+};
+const char * const  tlm_format_names[] = { "bin", "text", "delta", NULL };     // テレメトリ出力形式名
+TLM_FORMAT      tlm_format = TLM_FORMAT_TEXT;   // テレメトリ出力形式
+#define         TLM_OUTPUT_FRAME_SIZE   72      // テレメトリ出力フレームバッファサイズ
+static_assert(TLM_OUTPUT_FRAME_SIZE >= TLM_FRAME_SIZE, "TLM_OUTPUT_FRAME_SIZE is smaller than TLM_FRAME_SIZE");
+static_assert(TLM_OUTPUT_FRAME_SIZE >= TLM_CH_FRAME_SIZE_MAX, "TLM_OUTPUT_FRAME_SIZE is smaller than TLM_CH_FRAME_SIZE_MAX");
+static_assert(TLM_OUTPUT_FRAME_SIZE >= TLM_DELTA_SIZE_MAX, "TLM_OUTPUT_FRAME_SIZE is smaller than TLM_DELTA_SIZE_MAX");
+uint8_t         tlm_output_frame[TLM_OUTPUT_FRAME_SIZE];    // テレメトリ出力フレームバッファ
+TelemetryScheduler  tlmScheduler(TLM_LINK_BYTES, TLM_LINK_BUDGET);  // テレメトリスケジューラ
+
+// 差分圧縮テレメトリ
+// 出力するチャネルを直前のフレームとの差分で符号化し、TLM_DELTA_KEY_INTERVALフレーム毎にキーフレームを出力する
+#define         TLM_DELTA_KEY_INTERVAL  32      // キーフレーム間隔[フレーム]
+TelemetryDeltaEncoder   tlmDeltaEncoder(TLM_DELTA_KEY_INTERVAL);    // 差分圧縮テレメトリ符号化
+uint64_t        tlm_delta_cycles = 0;           // 符号化に要した CPU サイクル数の合計
+
+// テレメトリ記録
+// 収集したテレメトリをすべて記録し、"tlmdump"コマンドで出力する
+#define         TLM_RECORD_CAPACITY     1024    // RAM に記録するテレメトリ数（既定の出力周期 TLM_INTERVAL=10秒で約2.8時間）
+#define         TLM_RECORD_RAM_MAX      16384   // テレメトリ記録領域の上限[byte]
+#define         TLM_RECORD_SPILL_ENABLE 0       // フラッシュ退避 1=使用する 0=使用しない
+#define         TLM_RECORD_FLASH_NUM    32768   // フラッシュに記録するテレメトリ数（512KB、既定の出力周期で約91時間）
+#define         TLM_RECORD_FILE         "/tlm_record.bin"   // フラッシュ退避ファイル名
+#define         TLM_DUMP_BATCH          8       // 記録テレメトリ出力 一度に読み出す件数
+#define         TLM_DUMP_TX_RESERVE     8       // 記録テレメトリ出力 他の出力のために残す送信レコード数
+#if TLM_RECORD_SPILL_ENABLE
+#include <LittleFS.h>
+#endif
+typedef TelemetryRecorder<TLM_RECORD_CAPACITY> SatTelemetryRecorder;
+static_assert(SatTelemetryRecorder::StorageSize() <= TLM_RECORD_RAM_MAX, "TelemetryRecorder storage exceeds TLM_RECORD_RAM_MAX");
+SatTelemetryRecorder    tlmRecorder;            // テレメトリ記録
+bool            tlm_dump_active = false;        // 記録テレメトリ出力中フラグ
+uint32_t        tlm_dump_next;                  // 次に出力するテレメトリ番号
+uint32_t        tlm_dump_end;                   // 最後に出力するテレメトリ番号
+uint32_t        tlm_dump_count;                 // 出力したテレメトリ数
+uint32_t        tlm_dump_skipped;               // 出力前に上書きされたテレメトリ数
+TelemetrySample tlm_dump_buff[TLM_DUMP_BATCH];  // 記録テレメトリ読み出しバッファ
+size_t          tlm_dump_buff_num = 0;          // 読み出しバッファ内の件数
+size_t          tlm_dump_buff_index = 0;        // 読み出しバッファ内の次に出力する位置
 
 /******************************************************************************
  * @fn      timer_func_1sec
@@ -141,19 +317,13 @@ char            tlm_output_msg[TLM_OUTPUT_MSG_SIZE];    // テレメトリ出力
  * @param   void
  * @return  void 
  * @sa
- * @detail  タイマーで１秒毎に呼ばれるハンドラ関数、テレメトリ出力、LED秒数ドット表示のタイミングを決める
+ * @detail  タイマーで１秒毎に呼ばれるハンドラ関数、LED秒数ドット表示のタイミングを決める
+ *          テレメトリ出力のタイミングはテレメトリスケジューラ(tlmScheduler)が決める
  ******************************************************************************/
 void timer_func_1sec(void)
 {
     timer_1sec_flag = true;                     // 1秒タイマーフラグセット
     run_time++;                                 // 起動後の経過時間(秒)インクリメント
-    // テレメトリ出力インターバル
-    tlm_interval_counter++;                     // テレメトリ出力インターバルカウンタインクリメント
-    if (tlm_interval_counter >= TLM_INTERVAL) {
-        //　テレメトリ出力周期の時間経過
-        tlm_output_flag = true;                 // テレメトリ出力フラグセット
-        tlm_interval_counter = 0;               // テレメトリ出力インターバルカウンタクリア
-    }
     // LED秒数ドット表示
     led_dot_disp_int_cnt++;                     // テレメトリ出力インターバルカウンタインクリメント
     if (led_dot_disp_int_cnt >= LED_DOT_DISP_INT) {
@@ -178,7 +348,7 @@ void timer_func_1sec(void)
  ******************************************************************************/
 void serialReceiver_callback(int s)
 {
-    SerialReceive::EVENT event = (SerialReceive::EVENT)s;
+    SerialReceiveBase::EVENT event = (SerialReceiveBase::EVENT)s;
     // 何も行わない
 }
 
@@ -218,19 +388,86 @@ void ldm_callback(int s)
 /******************************************************************************
  * @fn      getTelemetryData
  * @brief   テレメトリデータ収集
- * @param   void
+ * @param   uint8_t mask : 出力時刻に達したチャネルマスク
  * @return  void 
  * @sa
  * @detail  テレメトリ出力する項目を収集し、変数に格納する
+ *          姿勢区間統計チャネルを含む場合は区間統計を取得してリセットする（出力の有無によらず区間を区切る）
+ *          経過時間・姿勢情報・内部温度のいずれかを含む場合だけテレメトリ番号を進めて記録する
+ *          （カウンタ・姿勢区間統計だけの出力時刻では、直前のテレメトリ番号のまま記録しない）
  ******************************************************************************/
-void getTelemetryData(void)
+void getTelemetryData(uint8_t mask)
 {
-    // 姿勢情報取得
-    attitude.GetAttitude(&imu_pitch, &imu_roll, &imu_yaw, &imu_arc, &imu_val);
-    // 内部温度データ取得
-    attitude.GetTemperature(&imu_temp);
+    AttitudeSnapshot snapshot;  // 姿勢情報スナップショット
+
+    // 姿勢情報・内部温度を同じサンプルから取得（取得タスクの書き込み途中の値と混ざらない）
+    if (mask & TLM_CHANNEL_BIT(TLM_CHANNEL_ATT_STATS)) {
+        attitude.TakeSnapshot(&snapshot);
+        imu_stats = snapshot;
+    }
+    else {
+        attitude.GetSnapshot(&snapshot);
+    }
+    imu_pitch = snapshot.pitch;
+    imu_roll = snapshot.roll;
+    imu_yaw = snapshot.yaw;
+    imu_arc = snapshot.arc;
+    imu_val = snapshot.val;
+    imu_temp = snapshot.temp;
+    if ((mask & TLM_CHANNEL_MASK_FULL) == 0) {
+        // 記録する項目のチャネルなし
+        return;
+    }
     // テレメトリカウンタインクリメント
     tlm_counter++;          
+    // テレメトリ記録
+    TelemetrySample sample;     // テレメトリサンプル
+    getTelemetrySample(&sample);
+    tlmRecorder.Append(sample);
+}
+
+/******************************************************************************
+ * @fn      getTelemetrySample
+ * @brief   テレメトリサンプル生成
+ * @param   TelemetrySample *sample : テレメトリサンプルを格納する領域へのポインタ
+ * @return  void 
+ * @sa
+ * @detail  テレメトリ出力する項目を 1/100 単位の固定小数点に変換する
+ ******************************************************************************/
+void getTelemetrySample(TelemetrySample *sample)
+{
+    sample->counter = (uint32_t)tlm_counter;
+    sample->missionTime = run_time;
+    sample->pitch = TelemetryToCenti(imu_pitch);
+    sample->roll = TelemetryToCenti(imu_roll);
+    sample->yaw = TelemetryToCenti(imu_yaw);
+    sample->temp = TelemetryToCenti(imu_temp);
+}
+
+/******************************************************************************
+ * @fn      getTelemetryCounters
+ * @brief   テレメトリカウンタ・姿勢区間統計収集
+ * @param   TelemetryCounters *counters : テレメトリカウンタを格納する領域へのポインタ
+ * @return  void 
+ * @sa      getTelemetryData
+ * @detail  記録しない項目（カウンタ、最後に取得した姿勢区間統計）を 1/100 単位の固定小数点に変換する
+ ******************************************************************************/
+void getTelemetryCounters(TelemetryCounters *counters)
+{
+    SerialTransmitBase::TxStats txStats;        // シリアル送信統計
+
+    serialTransmitter.GetTxStats(&txStats);
+    counters->commands = cmd_exec_count;
+    counters->txDrops = txStats.drops;
+    counters->attSamples = imu_stats.statsSamples;
+    counters->pitchMin = TelemetryToCenti(imu_stats.pitchStats.min);
+    counters->pitchMax = TelemetryToCenti(imu_stats.pitchStats.max);
+    counters->pitchMean = TelemetryToCenti(imu_stats.pitchStats.mean);
+    counters->pitchVar = TelemetryToCenti32(imu_stats.pitchStats.variance);
+    counters->rollMin = TelemetryToCenti(imu_stats.rollStats.min);
+    counters->rollMax = TelemetryToCenti(imu_stats.rollStats.max);
+    counters->rollMean = TelemetryToCenti(imu_stats.rollStats.mean);
+    counters->rollVar = TelemetryToCenti32(imu_stats.rollStats.variance);
 }
 
 /******************************************************************************
@@ -240,6 +477,8 @@ void getTelemetryData(void)
  * @return  void 
  * @sa
  * @detail  テレメトリ出力する項目をASCII文字列に変換する
+ *          実数の値を 1/100 単位の固定小数点に変換して sprintf を使わずに生成し、
+ *          sprintf("%6.2f") と同じ文字列（0 に丸めた負の値の "-0.00" を含む）を得る
  ******************************************************************************/
 void setTelemetryMsg(char *msg)
 {
@@ -248,12 +487,167 @@ void setTelemetryMsg(char *msg)
     // 2) 起動からの経過時間（時：分：秒）
     // 3) 姿勢情報 Pitch
     // 4) 姿勢情報 Roll
-    // 5) 姿勢情報 Yaw　（MPU6886からは取得不可）
+    // 5) 姿勢情報 Yaw　（起動時の向きからのジャイロ積分値）
     // 6) 内部温度
-    int hour = run_time / 3600;                     // 時
-    int min  = (run_time - (hour * 3600)) / 60;     // 分
-    int sec  = run_time % 60;                       // 秒
-    sprintf(msg, "TLM, %d, %02d:%02d:%02d, %6.2f, %6.2f, %6.2f, %6.2f", tlm_counter, hour, min, sec, imu_pitch, imu_roll, imu_yaw, imu_temp);
+    TelemetryFormatTextValues(tlm_counter, run_time, imu_pitch, imu_roll, imu_yaw, imu_temp, msg, TLM_OUTPUT_MSG_SIZE);
+}
+
+/******************************************************************************
+ * @fn      setTelemetryFrame
+ * @brief   テレメトリ出力フレーム生成
+ * @param   uint8_t *frame : テレメトリ出力フレームを格納するバッファへのポインタ
+ * @param   size_t size : バッファサイズ
+ * @return  size_t : フレームサイズ（バッファサイズ不足は 0）
+ * @sa      setTelemetryMsg
+ * @detail  テレメトリ出力する項目を固定小数点に変換し、同期ワード・CRC-16 付きのバイナリフレームに詰める
+ ******************************************************************************/
+size_t setTelemetryFrame(uint8_t *frame, size_t size)
+{
+    TelemetrySample sample;     // テレメトリサンプル
+
+    getTelemetrySample(&sample);
+    return TelemetryFramePack(sample, frame, size);
+}
+
+/******************************************************************************
+ * @fn      sendTelemetry
+ * @brief   テレメトリ出力
+ * @param   uint8_t mask : 出力するチャネルマスク
+ * @return  void 
+ * @sa      setTelemetryMsg, setTelemetryFrame
+ * @detail  出力するチャネルが従来形式の組（TLM_CHANNEL_MASK_FULL）なら従来形式で、
+ *          それ以外は指定チャネルだけをチャネル別形式で、現在のテレメトリ出力形式により出力する
+ *          差分圧縮フレームは出力するチャネルの組によらず同じ形式で出力する
+ ******************************************************************************/
+void sendTelemetry(uint8_t mask)
+{
+    TelemetrySample     sample;                 // テレメトリサンプル
+    TelemetryCounters   counters;               // テレメトリカウンタ
+
+    if (tlm_format == TLM_FORMAT_DELTA) {
+        // 差分圧縮フレーム（チャネルの組によらず同じ形式）
+        getTelemetrySample(&sample);
+        getTelemetryCounters(&counters);
+        uint32_t start = ESP.getCycleCount();
+        size_t size = tlmDeltaEncoder.Encode(sample, counters, mask, tlm_output_frame, sizeof (tlm_output_frame));
+        tlm_delta_cycles += (uint32_t)(ESP.getCycleCount() - start);
+        serialTransmitter.write(tlm_output_frame, size);
+        return;
+    }
+
+    if (mask == TLM_CHANNEL_MASK_FULL) {
+        // 従来形式
+        if (tlm_format == TLM_FORMAT_BIN) {
+            // テレメトリ出力フレーム生成・送信
+            size_t size = setTelemetryFrame(tlm_output_frame, sizeof (tlm_output_frame));
+            serialTransmitter.write(tlm_output_frame, size);
+        }
+        else {
+            // テレメトリ出力メッセージ生成
+            setTelemetryMsg(tlm_output_msg);
+            // テレメトリ出力メッセージ送信
+            serialTransmitter.WriteLine(tlm_output_msg);
+        }
+        return;
+    }
+
+    // チャネル別形式
+    getTelemetrySample(&sample);
+    getTelemetryCounters(&counters);
+    if (tlm_format == TLM_FORMAT_BIN) {
+        size_t size = TelemetryFramePackChannels(sample, counters, mask, tlm_output_frame, sizeof (tlm_output_frame));
+        serialTransmitter.write(tlm_output_frame, size);
+    }
+    else {
+        TelemetryFormatChannels(sample, counters, mask, tlm_output_msg, sizeof (tlm_output_msg));
+        serialTransmitter.WriteLine(tlm_output_msg);
+    }
+}
+
+/******************************************************************************
+ * @fn      getTelemetryFormatSize
+ * @brief   テレメトリ出力形式のサイズ取得
+ * @param   TLM_FORMAT format : テレメトリ出力形式
+ * @param   uint32_t *overhead : フレーム固定部サイズ[byte]を格納する領域へのポインタ
+ * @param   const uint8_t **channelBytes : チャネル毎のデータサイズ[byte]の表へのポインタを格納する領域へのポインタ
+ * @return  void 
+ * @sa      cmd_tlmfmt
+ * @detail  テレメトリスケジューラで回線使用量を見積もるための、出力形式の最大サイズを取得する
+ *          差分圧縮フレームはキーフレームの分（１フレームあたりに均した値）を固定部に加える
+ ******************************************************************************/
+void getTelemetryFormatSize(TLM_FORMAT format, uint32_t *overhead, const uint8_t **channelBytes)
+{
+    if (format == TLM_FORMAT_BIN) {
+        *overhead = TLM_CH_FRAME_OVERHEAD;
+        *channelBytes = TelemetryChannelFrameBytes;
+    }
+    else if (format == TLM_FORMAT_DELTA) {
+        *overhead = TLM_DELTA_OVERHEAD + ((TLM_DELTA_KEY_SIZE + TLM_DELTA_KEY_INTERVAL - 1) / TLM_DELTA_KEY_INTERVAL);
+        *channelBytes = TelemetryDeltaChannelBytes;
+    }
+    else {
+        *overhead = TLM_CH_TEXT_OVERHEAD;
+        *channelBytes = TelemetryChannelTextBytes;
+    }
+}
+
+/******************************************************************************
+ * @fn      dumpTelemetry
+ * @brief   記録テレメトリ出力
+ * @param   void
+ * @return  void 
+ * @sa      cmd_tlmdump
+ * @detail  "tlmdump"コマンドで指定された範囲の記録テレメトリを、送信レコードに空きがある分だけ出力する
+ *          空きが TLM_DUMP_TX_RESERVE 以下になったら戻り、次のループで続きを出力する
+ ******************************************************************************/
+void dumpTelemetry(void)
+{
+    while (tlm_dump_active == true) {
+        if (tlm_dump_buff_index >= tlm_dump_buff_num) {
+            // 読み出しバッファが空 記録から読み出す
+            if ((int32_t)(tlm_dump_next - tlm_dump_end) > 0) {
+                // 出力範囲の末尾まで出力した
+                serialTransmitter.printf("TLMDUMP, end, count=%u, skipped=%u\n", tlm_dump_count, tlm_dump_skipped);
+                tlm_dump_active = false;
+                break;
+            }
+            uint32_t num = tlm_dump_end - tlm_dump_next + 1;
+            tlm_dump_buff_num = tlmRecorder.Read(tlm_dump_next, tlm_dump_buff, (num < TLM_DUMP_BATCH) ? num : TLM_DUMP_BATCH);
+            tlm_dump_buff_index = 0;
+            if (tlm_dump_buff_num == 0) {
+                // 出力前に上書きされた 記録の先頭から続ける
+                uint32_t oldest = tlmRecorder.Oldest();
+                if ((int32_t)(oldest - tlm_dump_next) > 0) {
+                    tlm_dump_skipped += oldest - tlm_dump_next;
+                    tlm_dump_next = oldest;
+                }
+                else {
+                    // 読み出しエラー 残りを出力せずに終了する
+                    tlm_dump_skipped += tlm_dump_end - tlm_dump_next + 1;
+                    tlm_dump_next = tlm_dump_end + 1;
+                }
+                continue;
+            }
+        }
+
+        // 送信レコードに空きがなければ次のループで続ける（テレメトリ・コマンド応答の分を残す）
+        if (serialTransmitter.FreeCount() <= TLM_DUMP_TX_RESERVE) {
+            break;
+        }
+
+        const TelemetrySample &sample = tlm_dump_buff[tlm_dump_buff_index++];
+        if (tlm_format != TLM_FORMAT_TEXT) {
+            // バイナリフレーム（差分圧縮フレームの場合も出力中のフレームの差分と混ざらないように従来のフレームで出力する）
+            size_t size = TelemetryFramePack(sample, tlm_output_frame, sizeof (tlm_output_frame));
+            serialTransmitter.write(tlm_output_frame, size);
+        }
+        else {
+            TelemetryFormatText(sample, tlm_output_msg, sizeof (tlm_output_msg));
+            serialTransmitter.WriteLine(tlm_output_msg);
+        }
+        tlm_dump_next++;
+        tlm_dump_count++;
+    }
 }
 
 /******************************************************************************
@@ -341,6 +735,499 @@ void dispTemp(void)
     led_msg_busy = true;
 }
 
+/******************************************************************************
+ * @fn      compareLatency
+ * @brief   コマンド実行遅延比較関数
+ * @param   const void *a : 比較する遅延１へのポインタ
+ * @param   const void *b : 比較する遅延２へのポインタ
+ * @return  int : a < b なら負、a == b なら0、a > b なら正
+ * @sa
+ * @detail  qsort でコマンド実行遅延サンプルを昇順に並べるための比較関数
+ ******************************************************************************/
+int compareLatency(const void *a, const void *b)
+{
+    uint32_t    la = *(const uint32_t *)a;
+    uint32_t    lb = *(const uint32_t *)b;
+    return (la > lb) - (la < lb);
+}
+
+/******************************************************************************
+ * @fn      cmd_at
+ * @brief   "at"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（実行時刻[秒]、コマンド）
+ * @return  void 
+ * @sa
+ * @detail  実行時刻を指定してコマンドをコマンドタイムラインに登録する
+ *          登録時にコマンド名を検査し、引数は実行時に解析する
+ ******************************************************************************/
+void cmd_at(const CommandDispatcher::CommandArgs &args)
+{
+    long        at_time = args.arg[0].i;        // 実行時刻[秒]
+    const char  *command = args.arg[1].s;       // 予約するコマンド
+    char        name[16];                       // コマンド名
+
+    if (at_time < 0) {
+        // 実行時刻不正
+        serialTransmitter.printf("Invalid argument : \"%ld\"\n", at_time);
+        return;
+    }
+
+    // コマンド名を検査する
+    size_t len = strcspn(command, " \t");
+    if (len >= sizeof (name)) {
+        len = sizeof (name) - 1;
+    }
+    memcpy(name, command, len);
+    name[len] = '\0';
+    if (cmdDispatcher.Find(name) == NULL) {
+        // 認識できないコマンド
+        serialTransmitter.printf("Invalid command : \"%s\"\n", command);
+        return;
+    }
+
+    // コマンドタイムラインに登録する
+    CommandTimelineBase::RESULT result = cmdTimeline.Add((uint32_t)at_time, command);
+    if (result == CommandTimelineBase::RESULT_ERR_FULL) {
+        // 予約コマンド数が上限に達している
+        serialTransmitter.printf("Timeline is full : \"%s\"\n", command);
+    }
+    else if (result == CommandTimelineBase::RESULT_ERR_TOO_LONG) {
+        // 予約コマンドが長すぎる
+        serialTransmitter.printf("Command too long : \"%s\"\n", command);
+    }
+    else {
+        serialTransmitter.printf("TIMELINE, add, time=%ld, count=%u : %s\n", at_time, cmdTimeline.Count(), command);
+    }
+}
+
+/******************************************************************************
+ * @fn      cmd_cmdstat
+ * @brief   "cmdstat"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  コマンド受信から実行開始までの遅延（直近CMD_LAT_SAMPLE_NUM件）のパーセンタイルを出力する
+ ******************************************************************************/
+void cmd_cmdstat(const CommandDispatcher::CommandArgs &args)
+{
+    uint32_t    sorted[CMD_LAT_SAMPLE_NUM];     // 昇順に並べた遅延サンプル
+    int         num;                            // 有効サンプル数
+
+    // 有効サンプルを昇順に並べる
+    num = (cmd_exec_count < CMD_LAT_SAMPLE_NUM) ? (int)cmd_exec_count : CMD_LAT_SAMPLE_NUM;
+    memcpy(sorted, cmd_latency, num * sizeof (uint32_t));
+    qsort(sorted, num, sizeof (uint32_t), compareLatency);
+
+    // パーセンタイル出力（最近傍順位）
+    if (num > 0) {
+        serialTransmitter.printf("CMDSTAT, count=%u, samples=%d, p50=%uus, p90=%uus, p99=%uus, max=%uus\n", cmd_exec_count, num,
+            sorted[(num * 50 - 1) / 100], sorted[(num * 90 - 1) / 100], sorted[(num * 99 - 1) / 100], sorted[num - 1]);
+    }
+    else {
+        serialTransmitter.printf("CMDSTAT, count=%u, samples=%d\n", cmd_exec_count, num);
+    }
+}
+
+/******************************************************************************
+ * @fn      cmd_deltastat
+ * @brief   "deltastat"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa      sendTelemetry
+ * @detail  差分圧縮テレメトリの統計（符号化フレーム数、キーフレーム数、圧縮しない場合のサイズ・符号化したサイズと
+ *          その比、１フレームあたりの平均符号化時間）を出力する
+ ******************************************************************************/
+void cmd_deltastat(const CommandDispatcher::CommandArgs &args)
+{
+    TelemetryDeltaEncoder::Stats    stats;      // 符号化統計情報
+
+    tlmDeltaEncoder.GetStats(&stats);
+    if (stats.frames == 0) {
+        serialTransmitter.printf("DELTASTAT, frames=0\n");
+        return;
+    }
+    serialTransmitter.printf("DELTASTAT, frames=%u, keyframes=%u, raw=%uB, encoded=%uB, ratio=%.2f, encode=%uns/frame\n",
+        stats.frames, stats.keyframes, stats.rawBytes, stats.encodedBytes, (float)stats.rawBytes / stats.encodedBytes,
+        (uint32_t)((tlm_delta_cycles * 1000) / ((uint64_t)ESP.getCpuFreqMHz() * stats.frames)));
+}
+
+/******************************************************************************
+ * @fn      cmd_imustat
+ * @brief   "imustat"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  IMU 取得統計を出力する
+ ******************************************************************************/
+void cmd_imustat(const CommandDispatcher::CommandArgs &args)
+{
+    attitude.DispImuStats();
+}
+
+/******************************************************************************
+ * @fn      cmd_rxstat
+ * @brief   "rxstat"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  シリアル受信統計を出力する
+ ******************************************************************************/
+void cmd_rxstat(const CommandDispatcher::CommandArgs &args)
+{
+    serialReceiver.DispRecvStats();
+#if PAYLOAD_LINK_ENABLE
+    payloadReceiver.DispRecvStats();
+#endif
+}
+
+/******************************************************************************
+ * @fn      cmd_taskstat
+ * @brief   "taskstat"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  周期実行するタスク毎の周期実行統計を出力する（シリアル受信はイベント駆動なら周期 0）
+ ******************************************************************************/
+void cmd_taskstat(const CommandDispatcher::CommandArgs &args)
+{
+    TaskPeriod::Stats   stats;              // 周期実行統計情報
+
+    attitude.GetPeriodStats(&stats);
+    TaskPeriod::DispStats(&serialTransmitter, "attitude", stats);
+    ldm.GetPeriodStats(&stats);
+    TaskPeriod::DispStats(&serialTransmitter, "led", stats);
+    serialReceiveMux.GetPeriodStats(&stats);
+    TaskPeriod::DispStats(&serialTransmitter, "rx", stats);
+}
+
+/******************************************************************************
+ * @fn      cmd_temp
+ * @brief   "temp"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  内部温度をLEDに表示する
+ ******************************************************************************/
+void cmd_temp(const CommandDispatcher::CommandArgs &args)
+{
+    dispTemp();
+}
+
+/******************************************************************************
+ * @fn      cmd_timeline
+ * @brief   "timeline"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（出力件数、省略可）
+ * @return  void 
+ * @sa
+ * @detail  予約コマンドを実行時刻の早い順に出力する
+ ******************************************************************************/
+void cmd_timeline(const CommandDispatcher::CommandArgs &args)
+{
+    long                        num = (args.count > 0) ? args.arg[0].i : TIMELINE_LIST_DEFAULT;    // 出力件数
+    CommandTimelineBase::Entry  entry;          // 予約コマンド
+    const CommandTimelineBase::Entry    *prev = NULL;   // 直前に出力した予約コマンド
+
+    serialTransmitter.printf("TIMELINE, count=%u/%u, now=%u\n", cmdTimeline.Count(), cmdTimeline.Capacity(), run_time);
+    for (long index = 0; (index < num) && cmdTimeline.GetNext(prev, &entry); index++) {
+        serialTransmitter.printf("TIMELINE, time=%u : %s\n", entry.runTime, entry.command);
+        prev = &entry;
+    }
+}
+
+/******************************************************************************
+ * @fn      cmd_tlmdict
+ * @brief   "tlmdict"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa      TelemetryFields
+ * @detail  テレメトリチャネル定義表からチャネル・項目の一覧を出力する（地上局がテレメトリを解釈するための自己記述）
+ *          項目はフレームに格納する順に出力し、bytes はフレームでのサイズ、scale は 1LSB の大きさ
+ ******************************************************************************/
+void cmd_tlmdict(const CommandDispatcher::CommandArgs &args)
+{
+    serialTransmitter.printf("TLMDICT, fields=%u, channels=%u\n", TLM_FIELD_NUM, TLM_CHANNEL_NUM);
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        serialTransmitter.printf("TLMDICT, channel=%d, name=%s, bit=0x%02X\n", ch, TelemetryChannelNames[ch], TLM_CHANNEL_BIT(ch));
+    }
+    for (int field = 0; field < TLM_FIELD_NUM; field++) {
+        const TelemetryFieldDef &def = TelemetryFields[field];
+        serialTransmitter.printf("TLMDICT, field=%d, name=%s, channel=%s, type=%s, bytes=%u, scale=%g, unit=%s, label=%s\n",
+            field, def.name, (def.channel == TLM_CHANNEL_HEADER) ? "header" : TelemetryChannelNames[def.channel],
+            TelemetryTypeNames[def.type], TelemetryTypeBytes(def.type), def.scale, def.unit, (def.label != NULL) ? def.label : "");
+    }
+}
+
+/******************************************************************************
+ * @fn      cmd_tlmdump
+ * @brief   "tlmdump"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（開始・終了テレメトリ番号、省略可）
+ * @return  void 
+ * @sa      dumpTelemetry
+ * @detail  記録テレメトリの出力を開始する（出力はループ毎に dumpTelemetry で行う）
+ *          出力中に実行した場合は、出力中の範囲を打ち切って新しい範囲を出力する
+ ******************************************************************************/
+void cmd_tlmdump(const CommandDispatcher::CommandArgs &args)
+{
+    uint32_t    oldest = tlmRecorder.Oldest();  // 最も古い記録
+    uint32_t    newest = tlmRecorder.Newest();  // 最も新しい記録
+    uint32_t    from = (args.count > 0) ? (uint32_t)args.arg[0].i : oldest;    // 開始テレメトリ番号
+    uint32_t    to = (args.count > 1) ? (uint32_t)args.arg[1].i : newest;      // 終了テレメトリ番号
+
+    if (tlmRecorder.Count() == 0) {
+        // 記録なし
+        serialTransmitter.printf("TLMDUMP, no record\n");
+        return;
+    }
+    if ((args.count > 0) && (args.arg[0].i < 0)) {
+        // テレメトリ番号不正
+        serialTransmitter.printf("Invalid argument : \"%ld\"\n", args.arg[0].i);
+        return;
+    }
+    // 記録の範囲に制限する
+    if ((int32_t)(from - oldest) < 0) {
+        from = oldest;
+    }
+    if ((args.count > 1) && ((args.arg[1].i < 0) || ((int32_t)(to - newest) > 0))) {
+        to = newest;
+    }
+    if ((int32_t)(to - from) < 0) {
+        // 範囲内の記録なし
+        serialTransmitter.printf("TLMDUMP, no record in range, stored=%u-%u\n", oldest, newest);
+        return;
+    }
+
+    serialTransmitter.printf("TLMDUMP, start, from=%u, to=%u, stored=%u-%u\n", from, to, oldest, newest);
+    tlm_dump_next = from;
+    tlm_dump_end = to;
+    tlm_dump_count = 0;
+    tlm_dump_skipped = 0;
+    tlm_dump_buff_num = 0;
+    tlm_dump_buff_index = 0;
+    tlm_dump_active = true;
+}
+
+/******************************************************************************
+ * @fn      cmd_tlmfmt
+ * @brief   "tlmfmt"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（出力形式 bin|text|delta）
+ * @return  void 
+ * @sa
+ * @detail  テレメトリ出力形式を切り替える
+ *          切り替え後の回線使用量の見積もりが予算を超える場合は切り替えない
+ ******************************************************************************/
+void cmd_tlmfmt(const CommandDispatcher::CommandArgs &args)
+{
+    TLM_FORMAT  format = (TLM_FORMAT)args.arg[0].e;     // 出力形式
+    uint32_t    overhead;                               // フレーム固定部サイズ[byte]
+    const uint8_t   *channelBytes;                      // チャネル毎のデータサイズ[byte]
+    uint32_t    load;                                   // 切り替え後の回線使用量[byte/s]
+
+    // 切り替え後の回線使用量を検査する
+    getTelemetryFormatSize(format, &overhead, &channelBytes);
+    load = tlmScheduler.LoadFor(overhead, channelBytes);
+    if (load > tlmScheduler.Budget()) {
+        // 回線使用量が予算を超える
+        serialTransmitter.printf("Over budget : \"%s\", load=%uB/s, budget=%uB/s\n", tlm_format_names[format], load, tlmScheduler.Budget());
+        return;
+    }
+
+    if ((format == TLM_FORMAT_DELTA) && (tlm_format != TLM_FORMAT_DELTA)) {
+        // 差分圧縮フレームはキーフレームから出力する
+        tlmDeltaEncoder.Reset();
+    }
+    tlm_format = format;
+    tlmScheduler.SetFrameSize(overhead, channelBytes);
+    serialTransmitter.printf("TLMFMT, %s\n", tlm_format_names[tlm_format]);
+}
+
+/******************************************************************************
+ * @fn      cmd_tlmoff
+ * @brief   "tlmoff"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  テレメトリ出力を禁止する
+ ******************************************************************************/
+void cmd_tlmoff(const CommandDispatcher::CommandArgs &args)
+{
+    // テレメトリ出力許可フラグクリア
+    tlm_output_enable = false;
+}
+
+/******************************************************************************
+ * @fn      cmd_tlmon
+ * @brief   "tlmon"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  テレメトリ出力を許可する
+ ******************************************************************************/
+void cmd_tlmon(const CommandDispatcher::CommandArgs &args)
+{
+    // テレメトリ出力許可フラグセット
+    tlm_output_enable = true;
+}
+
+/******************************************************************************
+ * @fn      cmd_tlmrate
+ * @brief   "tlmrate"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（チャネル、出力周波数[Hz]、省略可）
+ * @return  void 
+ * @sa      TelemetryScheduler
+ * @detail  テレメトリチャネルの出力周波数を設定する（0 は出力しない）
+ *          回線使用量の見積もりが予算を超える設定は拒否する
+ *          出力周波数を省略した場合は指定チャネルの設定を、チャネルも省略した場合は全チャネルの設定を出力する
+ ******************************************************************************/
+void cmd_tlmrate(const CommandDispatcher::CommandArgs &args)
+{
+    if (args.count >= 2) {
+        int     channel = (int)args.arg[0].e;   // チャネル
+        float   hz = args.arg[1].f;             // 出力周波数[Hz]
+        long    period = 0;                     // 出力周期[ms]
+
+        if (hz < 0.0f) {
+            // 出力周波数不正
+            serialTransmitter.printf("Invalid argument : \"%g\"\n", hz);
+            return;
+        }
+        if (hz > 0.0f) {
+            float ms = 1000.0f / hz;
+            period = (ms > (float)TLM_SCHED_PERIOD_MAX) ? (long)TLM_SCHED_PERIOD_MAX + 1 : lroundf(ms);
+        }
+        TelemetryScheduler::RESULT result = tlmScheduler.SetPeriod(channel, (uint32_t)period);
+        if (result == TelemetryScheduler::RESULT_ERR_RANGE) {
+            // 出力周期が範囲外
+            serialTransmitter.printf("Out of range : \"%g\", period=%u-%ums\n", hz, TLM_SCHED_PERIOD_MIN, TLM_SCHED_PERIOD_MAX);
+            return;
+        }
+        if (result == TelemetryScheduler::RESULT_ERR_BUDGET) {
+            // 回線使用量が予算を超える
+            serialTransmitter.printf("Over budget : \"%s %g\", budget=%uB/s\n", TelemetryChannelNames[channel], hz, tlmScheduler.Budget());
+            return;
+        }
+    }
+
+    // 設定出力
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if ((args.count >= 1) && (ch != args.arg[0].e)) {
+            continue;
+        }
+        uint32_t period = tlmScheduler.GetPeriod(ch);
+        if (period == 0) {
+            serialTransmitter.printf("TLMRATE, %s, off\n", TelemetryChannelNames[ch]);
+        }
+        else {
+            serialTransmitter.printf("TLMRATE, %s, %.3fHz, period=%ums\n", TelemetryChannelNames[ch], 1000.0f / period, period);
+        }
+    }
+    serialTransmitter.printf("TLMRATE, load=%uB/s, budget=%uB/s\n", tlmScheduler.Load(), tlmScheduler.Budget());
+}
+
+/******************************************************************************
+ * @fn      cmd_txstat
+ * @brief   "txstat"コマンド処理
+ * @param   const CommandDispatcher::CommandArgs &args : コマンド引数（なし）
+ * @return  void 
+ * @sa
+ * @detail  シリアル送信統計を出力する
+ ******************************************************************************/
+void cmd_txstat(const CommandDispatcher::CommandArgs &args)
+{
+    serialTransmitter.DispTxStats();
+}
+
+// コマンド定義表（コマンド名の昇順に並べること）
+constexpr CommandDispatcher::CommandDef cmd_table[] = {
+    //  コマンド名  処理関数        引数仕様    列挙名表
+    {   "at",       cmd_at,         "is",       NULL    },      // 実行時刻指定コマンド予約
+    {   "cmdstat",  cmd_cmdstat,    "",         NULL    },      // コマンド実行遅延統計出力
+    {   "deltastat", cmd_deltastat, "",         NULL    },      // 差分圧縮テレメトリ統計出力
+    {   "imustat",  cmd_imustat,    "",         NULL    },      // IMU 取得統計出力
+    {   "rxstat",   cmd_rxstat,     "",         NULL    },      // シリアル受信統計出力
+    {   "taskstat", cmd_taskstat,   "",         NULL    },      // 周期実行統計出力
+    {   "temp",     cmd_temp,       "",         NULL    },      // 内部温度をLEDに表示する
+    {   "timeline", cmd_timeline,   "I",        NULL    },      // 予約コマンド一覧出力
+    {   "tlmdict",  cmd_tlmdict,    "",         NULL    },      // テレメトリ項目一覧出力
+    {   "tlmdump",  cmd_tlmdump,    "II",       NULL    },      // 記録テレメトリ出力
+    {   "tlmfmt",   cmd_tlmfmt,     "e",        tlm_format_names    },  // テレメトリ出力形式切替
+    {   "tlmoff",   cmd_tlmoff,     "",         NULL    },      // テレメトリ出力禁止
+    {   "tlmon",    cmd_tlmon,      "",         NULL    },      // テレメトリ出力許可
+    {   "tlmrate",  cmd_tlmrate,    "EF",       TelemetryChannelNames   },  // テレメトリチャネル出力周波数設定
+    {   "txstat",   cmd_txstat,     "",         NULL    },      // シリアル送信統計出力
+};
+static_assert(CommandDispatcher::IsSorted(cmd_table), "cmd_table must be sorted by command name");
+CommandDispatcher   cmdDispatcher(cmd_table);   // コマンドディスパッチャ
+
+/******************************************************************************
+ * @fn      execCommand
+ * @brief   コマンド実行
+ * @param   const char *line : 受信したコマンド行
+ * @param   uint32_t recvTime : コマンド受信時刻[us]
+ * @param   uint8_t port : コマンド受信ポート番号
+ * @return  void 
+ * @sa
+ * @detail  受信時刻と実行開始時刻を記録し、その差をコマンド実行遅延サンプルに格納してからコマンドを振り分ける
+ ******************************************************************************/
+void execCommand(const char *line, uint32_t recvTime, uint8_t port)
+{
+    // 受信時刻・実行開始時刻を記録する
+    cmd_recv_time = recvTime;
+    cmd_exec_time = micros();
+    // コマンド実行遅延サンプル格納
+    cmd_latency[cmd_latency_index] = cmd_exec_time - cmd_recv_time;
+    cmd_latency_index = (cmd_latency_index + 1) % CMD_LAT_SAMPLE_NUM;
+    cmd_exec_count++;
+
+    dispatchCommand(line, port);
+}
+
+/******************************************************************************
+ * @fn      dispatchCommand
+ * @brief   コマンド振り分け
+ * @param   const char *line : コマンド行
+ * @param   uint8_t port : コマンド受信ポート番号
+ * @return  void 
+ * @sa
+ * @detail  コマンド定義表からコマンドを検索し、引数を解析して処理関数を呼び出す
+ *          Dispatch は引数の区切りを '\0' に書き換えるため、写しを解析し、エラー表示には元のコマンド行を使う
+ ******************************************************************************/
+void dispatchCommand(const char *line, uint8_t port)
+{
+    char    command[SatSerialReceive::SLOT_SIZE];   // 解析用のコマンド行の写し
+
+    strncpy(command, line, sizeof (command) - 1);
+    command[sizeof (command) - 1] = '\0';
+    CommandDispatcher::RESULT   result = cmdDispatcher.Dispatch(command, port);
+    if (result == CommandDispatcher::RESULT_ERR_UNKNOWN_CMD) {
+        // 認識できないコマンド
+        serialTransmitter.printf("Invalid command : \"%s\"\n", line);
+    }
+    else if ((result == CommandDispatcher::RESULT_ERR_ARGS) || (result == CommandDispatcher::RESULT_ERR_ARG_TYPE)) {
+        // 引数が不正
+        serialTransmitter.printf("Invalid argument : \"%s\"\n", line);
+    }
+}
+
+/******************************************************************************
+ * @fn      recvCommands
+ * @brief   受信コマンド実行
+ * @param   SerialReceiveBase &receiver : シリアル受信（ポート）
+ * @return  void 
+ * @sa
+ * @detail  指定ポートの受信済コマンドを待ちなしですべて実行する
+ ******************************************************************************/
+void recvCommands(SerialReceiveBase &receiver)
+{
+    SerialReceiveBase::RecvMsg  serialRecvMsg;  // 受信メッセージ（スロット参照）
+
+    while (receiver.TryReceiveMsg(&serialRecvMsg) == SerialReceiveBase::RESULT_SUCCESS) {
+        // コマンド実行
+        execCommand(serialRecvMsg.data, serialRecvMsg.time, serialRecvMsg.port);
+        // 受信メッセージ解放
+        receiver.ReleaseMsg(&serialRecvMsg);
+    }
+}
+
 /******************************************************************************
  * @fn      setup
  * @brief   起動時処理
@@ -359,11 +1246,43 @@ void setup()
     M5.begin(true, true, true);
     delay(50);      // 50msウェイト
 
+    // シリアル送信開始（以降のシリアル出力は送信タスクが行う）
+    serialTransmitter.Start();
+    attitude.SetOutput(&serialTransmitter);
+    ldm.SetOutput(&serialTransmitter);
+    serialReceiver.SetOutput(&serialTransmitter);
+#if PAYLOAD_LINK_ENABLE
+    payloadReceiver.SetOutput(&serialTransmitter);
+#endif
+    serialReceiveMux.SetOutput(&serialTransmitter);
+
+#if TLM_RECORD_SPILL_ENABLE
+    // テレメトリ記録のフラッシュ退避設定
+    if (!LittleFS.begin(true) || (tlmRecorder.SetSpill(&LittleFS, TLM_RECORD_FILE, TLM_RECORD_FLASH_NUM) != TelemetryRecorderBase::RESULT_SUCCESS)) {
+        serialTransmitter.print("Telemetry record spill disabled.\n");
+    }
+#endif
+
+    // テレメトリ出力周期設定（時刻・姿勢・温度を TLM_INTERVAL 秒毎に出力し、従来と同じ出力とする）
+    uint32_t        tlm_overhead;               // フレーム固定部サイズ[byte]
+    const uint8_t   *tlm_channel_bytes;         // チャネル毎のデータサイズ[byte]
+    getTelemetryFormatSize(tlm_format, &tlm_overhead, &tlm_channel_bytes);
+    tlmScheduler.SetFrameSize(tlm_overhead, tlm_channel_bytes);
+    tlmScheduler.SetPeriod(TLM_CHANNEL_TIME, TLM_INTERVAL * 1000);
+    tlmScheduler.SetPeriod(TLM_CHANNEL_ATTITUDE, TLM_INTERVAL * 1000);
+    tlmScheduler.SetPeriod(TLM_CHANNEL_TEMP, TLM_INTERVAL * 1000);
+
     // 1秒周期タイマ割り込みスタート
     timer.setInterval(TIMER_1SEC, timer_func_1sec);
 
     // 姿勢情報取得初期化
+#if IMU_FIFO_ENABLE
+    // 取得周期毎に FIFO からまとめて読み出す（平均温度は従来と同じ 1 秒分の取得周期で求める）
+    attitude.Init(attitude_callback, 1000 / IMU_FIFO_PERIOD, IMU_FIFO_PERIOD);
+    attitude.SetAcquireMode(Attitude::ACQUIRE_FIFO, IMU_FIFO_RATE);
+#else
     attitude.Init(attitude_callback);
+#endif
     // 姿勢情報取得開始
     attitude.Start();
 
@@ -396,21 +1315,46 @@ void loop()
     // M5Timer処理
     timer.run();
 
-    if (tlm_output_flag == true) {
-        // テレメトリ出力フラグセット
+    if ((cmd_recv_enable == true) && (ulTaskNotifyTake(pdTRUE, 0) > 0)) {
+        // コマンド受信可能 かつ 受信メッセージ通知あり
+        // 受信済コマンドを待ちなしですべて実行する
+        recvCommands(serialReceiver);
+#if PAYLOAD_LINK_ENABLE
+        recvCommands(payloadReceiver);
+#endif
+    }
+
+    if (cmd_recv_enable == true) {
+        // 実行時刻に達した予約コマンドを実行する（先頭の実行時刻のみ比較し、未到達なら何もしない）
+        uint32_t    at_time;                    // 予約コマンドの実行時刻[秒]
+        while (cmdTimeline.PopDue(run_time, timeline_cmd, sizeof (timeline_cmd), &at_time) == CommandTimelineBase::RESULT_SUCCESS) {
+            serialTransmitter.printf("TIMELINE, exec, time=%u : %s\n", at_time, timeline_cmd);
+            dispatchCommand(timeline_cmd, SERIAL_PORT_GROUND);
+        }
+    }
+
+    uint8_t tlm_mask = tlmScheduler.Poll(millis());     // 出力時刻に達したテレメトリチャネル
+    if (tlm_mask != 0) {
+        // テレメトリ出力時刻に達したチャネルあり
         // テレメトリデータ収集
-        getTelemetryData();
+        getTelemetryData(tlm_mask);
         if (tlm_output_enable == true) {
             // テレメトリ出力許可フラグセット
-            // テレメトリ出力メッセージ生成
-            setTelemetryMsg(tlm_output_msg);
-            // テレメトリ出力メッセージ送信
-            Serial.println(tlm_output_msg);
+            // 同時期に出力時刻に達したチャネルをまとめて出力する
+            sendTelemetry(tlm_mask);
         }
-        // テレメトリ出力フラグクリア
-        tlm_output_flag = false;
     }
 
+    if (tlm_dump_active == true) {
+        // 記録テレメトリ出力中 送信バッファの空きの分だけ出力する
+        dumpTelemetry();
+    }
+
+#if TLM_RECORD_SPILL_ENABLE
+    // テレメトリ記録のフラッシュ退避（１回のループで最大１ブロック）
+    tlmRecorder.Spill();
+#endif
+
     if (timer_1sec_flag == true) {
         // 1秒周期処理
         timer_1sec_flag = false;         // 1秒タイマーフラグクリア
@@ -419,10 +1363,22 @@ void loop()
             // コマンド受信不可
             if (run_time >= TIMER_CMD_RECV_EN) {
                 // コマンド受信許可タイマー時間に達した
-                // シリアル受信初期化
+                // シリアル受信初期化（地上局リンク）
+                serialReceiver.SetPort(&Serial, SERIAL_PORT_GROUND);
                 serialReceiver.Init(false);
-                // シリアル受信開始
-                serialReceiver.Start();
+                // 受信メッセージ通知先をこのタスク（loop）に設定
+                serialReceiver.SetNotifyTask(xTaskGetCurrentTaskHandle());
+                serialReceiveMux.AddPort(&serialReceiver);
+#if PAYLOAD_LINK_ENABLE
+                // シリアル受信初期化（ペイロードリンク）
+                Serial2.begin(PAYLOAD_LINK_BAUD, SERIAL_8N1, PAYLOAD_LINK_RX_PIN, PAYLOAD_LINK_TX_PIN);
+                payloadReceiver.SetPort(&Serial2, SERIAL_PORT_PAYLOAD);
+                payloadReceiver.Init(false);
+                payloadReceiver.SetNotifyTask(xTaskGetCurrentTaskHandle());
+                serialReceiveMux.AddPort(&payloadReceiver);
+#endif
+                // シリアル受信開始（全ポートを１つのタスクで受信する）
+                serialReceiveMux.Start();
                 // コマンド受信許可フラグセット
                 cmd_recv_enable = true;
                 // テレメトリ出力許可フラグセット
@@ -439,31 +1395,6 @@ void loop()
                 // LED秒数ドット表示更新
                 ldm.SetLedMatrix((bool *)led_matrix, 0, 0, 255);
             }
-
-            // シリアル受信メッセージチェック
-            SerialReceive::RESULT   serialRecvResult = serialReceiver.GetReceiveData(seralReceiveBuff);
-            if (serialRecvResult == serialReceiver.RESULT_SUCCESS) {
-                // 受信メッセージ取得成功
-                //Serial.printf("Received : %s\n", seralReceiveBuff);
-                if (strcmp(seralReceiveBuff, "tlmon") == 0) {
-                    // "tlmon"コマンド　テレメトリ出力許可
-                    // テレメトリ出力許可フラグセット
-                    tlm_output_enable = true;
-                }
-                else if (strcmp(seralReceiveBuff, "tlmoff") == 0) {
-                    // "tlmoff"コマンド　テレメトリ出力 禁止
-                    // テレメトリ出力許可フラグクリア
-                    tlm_output_enable = false;
-                }
-                else if (strcmp(seralReceiveBuff, "temp") == 0) {
-                    // "temp"コマンド 内部温度をLEDに表示する
-                    dispTemp();
-                }
-                else {
-                    // 認識できないコマンド
-                    Serial.printf("Invalid command : \"%s\"\n", seralReceiveBuff);
-                }
-            }
         }
     }
 
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * @file       Mpu6886Fifo.cpp
+ * @brief      MPU6886 FIFO 一括取得
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    サンプル毎に加速度・角速度・温度を別々に読み出すと、１サンプルに I2C トランザクションが３回必要で、
+ *             取得周期も起床周期に縛られる。FIFO に一定周期でサンプルを溜め、起床毎に FIFO 件数の読み出し１回と
+ *             連続読み出し数回でまとめて読み出すことで、起床回数とトランザクション数を減らしてサンプリング周波数を上げる
+ *             FIFO は満杯になったら格納を止める設定とし、満杯を検出したら読み出した後に FIFO をリセットする
+ *             （満杯の FIFO の末尾にはサンプルの途中までが格納されることがあり、以降のサンプルの区切りがずれるため）
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <string.h>
+#include "Mpu6886Fifo.h"
+
+#define MPU6886_FIFO_CHUNK_MAX      18          // １回の連続読み出しの最大サンプル数（読み出し用バッファの大きさ）
+
+// コンストラクタ
+Mpu6886Fifo::Mpu6886Fifo(ImuRegisterBus *bus)
+{
+    _bus = bus;                             // レジスタ読み書き
+    _rate = MPU6886_INTERNAL_RATE;          // サンプリング周波数
+    ClearStats();
+}
+
+// 初期化
+Mpu6886Fifo::RESULT Mpu6886Fifo::Init(uint32_t rateHz)
+{
+    uint8_t     id;                         // デバイス ID
+
+    if ((_bus == NULL) || (rateHz == 0) || (rateHz > MPU6886_INTERNAL_RATE) || ((MPU6886_INTERNAL_RATE % rateHz) != 0)) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+    if (!read(MPU6886_REG_WHO_AM_I, &id, 1)) {
+        return RESULT_ERR_BUS;
+    }
+    if (id != MPU6886_WHO_AM_I_VALUE) {
+        return RESULT_ERR_DEVICE;
+    }
+
+    // フルスケール・ローパスフィルタ・サンプリング周波数を設定し、角速度・加速度（温度を含む）を FIFO に格納する
+    const uint8_t config[][2] = {
+        { MPU6886_REG_PWR_MGMT_1,    MPU6886_PWR_MGMT_1_CLKSEL },
+        { MPU6886_REG_GYRO_CONFIG,   MPU6886_GYRO_FS_2000DPS },
+        { MPU6886_REG_ACCEL_CONFIG,  MPU6886_ACCEL_FS_8G },
+        { MPU6886_REG_ACCEL_CONFIG2, MPU6886_ACCEL_DLPF_218HZ },
+        { MPU6886_REG_CONFIG,        MPU6886_CONFIG_FIFO_MODE | MPU6886_CONFIG_DLPF_176HZ },
+        { MPU6886_REG_SMPLRT_DIV,    (uint8_t)((MPU6886_INTERNAL_RATE / rateHz) - 1) },
+        { MPU6886_REG_FIFO_EN,       MPU6886_FIFO_EN_GYRO_ACCEL },
+    };
+    for (size_t index = 0; index < sizeof (config) / sizeof (config[0]); index++) {
+        if (!_bus->Write(config[index][0], config[index][1])) {
+            return RESULT_ERR_BUS;
+        }
+    }
+    _rate = rateHz;
+
+    return Reset();
+}
+
+// FIFO リセット
+Mpu6886Fifo::RESULT Mpu6886Fifo::Reset()
+{
+    if (!_bus->Write(MPU6886_REG_USER_CTRL, MPU6886_USER_CTRL_FIFO_RST) ||
+        !_bus->Write(MPU6886_REG_USER_CTRL, MPU6886_USER_CTRL_FIFO_EN)) {
+        return RESULT_ERR_BUS;
+    }
+    return RESULT_SUCCESS;
+}
+
+// 読み出し
+size_t Mpu6886Fifo::Drain(ImuSample *samples, size_t maxSamples)
+{
+    uint8_t     buffer[MPU6886_FIFO_CHUNK_MAX * MPU6886_FIFO_PACKET_SIZE];  // 読み出し用バッファ
+    uint8_t     countBytes[2];              // FIFO 格納バイト数
+    size_t      chunk;                      // １回の連続読み出しのサンプル数
+    size_t      count;                      // 読み出したサンプル数
+
+    _stats.drains++;
+    if (!read(MPU6886_REG_FIFO_COUNTH, countBytes, sizeof (countBytes))) {
+        return 0;
+    }
+    size_t bytes = ((size_t)(countBytes[0] & 0x1F) << 8) | countBytes[1];
+    // 次のサンプルが入らなければ溢れている（末尾にサンプルの途中までが格納されている可能性がある）
+    bool overflow = (bytes + MPU6886_FIFO_PACKET_SIZE > MPU6886_FIFO_SIZE);
+    size_t available = bytes / MPU6886_FIFO_PACKET_SIZE;
+    if (available > maxSamples) {
+        available = maxSamples;
+    }
+
+    chunk = _bus->MaxRead() / MPU6886_FIFO_PACKET_SIZE;
+    if (chunk > MPU6886_FIFO_CHUNK_MAX) {
+        chunk = MPU6886_FIFO_CHUNK_MAX;
+    }
+    if (chunk == 0) {
+        chunk = 1;
+    }
+    for (count = 0; count < available; ) {
+        size_t num = ((available - count) < chunk) ? (available - count) : chunk;
+        if (!read(MPU6886_REG_FIFO_R_W, buffer, num * MPU6886_FIFO_PACKET_SIZE)) {
+            // 読み出し途中で失敗 区切りがずれた可能性があるため捨てる
+            overflow = true;
+            break;
+        }
+        for (size_t index = 0; index < num; index++) {
+            decode(&buffer[index * MPU6886_FIFO_PACKET_SIZE], &samples[count + index]);
+        }
+        count += num;
+    }
+
+    if (overflow || ((bytes % MPU6886_FIFO_PACKET_SIZE) != 0)) {
+        // 溢れ・区切りのずれ FIFO をリセットして次のサンプルから格納し直す
+        _stats.overflows++;
+        Reset();
+    }
+    _stats.samples += count;
+    if (count > _stats.maxBatch) {
+        _stats.maxBatch = count;
+    }
+    return count;
+}
+
+// 統計情報クリア
+void Mpu6886Fifo::ClearStats()
+{
+    memset(&_stats, 0, sizeof (_stats));
+}
+
+// 読み出し
+bool Mpu6886Fifo::read(uint8_t reg, uint8_t *dst, size_t length)
+{
+    _stats.transactions++;
+    return _bus->Read(reg, dst, length);
+}
+
+// FIFO の１サンプルの変換
+void Mpu6886Fifo::decode(const uint8_t *src, ImuSample *sample)
+{
+    int16_t raw[7];                         // 加速度 X, Y, Z、温度、角速度 X, Y, Z
+
+    for (int index = 0; index < 7; index++) {
+        raw[index] = (int16_t)(((uint16_t)src[index * 2] << 8) | src[index * 2 + 1]);
+    }
+    sample->ax = (float)raw[0] / MPU6886_ACCEL_LSB;
+    sample->ay = (float)raw[1] / MPU6886_ACCEL_LSB;
+    sample->az = (float)raw[2] / MPU6886_ACCEL_LSB;
+    sample->temp = (float)raw[3] / MPU6886_TEMP_LSB + MPU6886_TEMP_OFFSET;
+    sample->gx = (float)raw[4] / MPU6886_GYRO_LSB;
+    sample->gy = (float)raw[5] / MPU6886_GYRO_LSB;
+    sample->gz = (float)raw[6] / MPU6886_GYRO_LSB;
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * @file       Mpu6886Fifo.h
+ * @brief      MPU6886 FIFO 一括取得 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    加速度・ジャイロセンサ MPU6886 の FIFO に一定周期で角速度・加速度・温度を溜め、
+ *             起床毎にまとめて読み出すクラス定義
+ *             レジスタの読み書きは ImuRegisterBus を通して行うため Arduino に依存せず、
+ *             ホスト上ではレジスタを模擬したセンサで動作を確認できる
+ *             FIFO の１サンプル（14 バイト、ビッグエンディアン）
+ *               加速度 X, Y, Z (2×3) | 温度 (2) | 角速度 X, Y, Z (2×3)
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _MPU6886_FIFO_H_
+#define _MPU6886_FIFO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MPU6886_ADDRESS             0x68        // I2C アドレス
+
+// レジスタ
+#define MPU6886_REG_SMPLRT_DIV      0x19        // サンプリング周波数分周比
+#define MPU6886_REG_CONFIG          0x1A        // 設定（FIFO モード、ジャイロ・温度のローパスフィルタ）
+#define MPU6886_REG_GYRO_CONFIG     0x1B        // ジャイロ設定（フルスケール）
+#define MPU6886_REG_ACCEL_CONFIG    0x1C        // 加速度設定（フルスケール）
+#define MPU6886_REG_ACCEL_CONFIG2   0x1D        // 加速度設定２（ローパスフィルタ）
+#define MPU6886_REG_FIFO_EN         0x23        // FIFO に格納するデータ
+#define MPU6886_REG_INT_STATUS      0x3A        // 割り込み状態（読み出しでクリア）
+#define MPU6886_REG_ACCEL_XOUT_H    0x3B        // 加速度 X 上位（ここから 加速度・温度・角速度の順）
+#define MPU6886_REG_TEMP_OUT_H      0x41        // 温度 上位
+#define MPU6886_REG_GYRO_XOUT_H     0x43        // 角速度 X 上位
+#define MPU6886_REG_USER_CTRL       0x6A        // ユーザ制御（FIFO 有効・リセット）
+#define MPU6886_REG_PWR_MGMT_1      0x6B        // 電源管理１
+#define MPU6886_REG_FIFO_COUNTH     0x72        // FIFO 格納バイト数 上位
+#define MPU6886_REG_FIFO_R_W        0x74        // FIFO 読み出し
+#define MPU6886_REG_WHO_AM_I        0x75        // デバイス ID
+
+// レジスタの値
+#define MPU6886_WHO_AM_I_VALUE      0x19        // デバイス ID
+#define MPU6886_CONFIG_FIFO_MODE    0x40        // FIFO が満杯になったら格納しない（古いデータを上書きしない）
+#define MPU6886_CONFIG_DLPF_176HZ   0x01        // ジャイロ帯域 176Hz（内部サンプリング 1kHz）
+#define MPU6886_GYRO_FS_2000DPS     0x18        // ジャイロ フルスケール ±2000度/秒
+#define MPU6886_ACCEL_FS_8G         0x10        // 加速度 フルスケール ±8G
+#define MPU6886_ACCEL_DLPF_218HZ    0x01        // 加速度帯域 218Hz
+#define MPU6886_FIFO_EN_GYRO_ACCEL  0x18        // 角速度・加速度（温度を含む）を FIFO に格納
+#define MPU6886_INT_FIFO_OFLOW      0x10        // FIFO 溢れ
+#define MPU6886_USER_CTRL_FIFO_EN   0x40        // FIFO 有効
+#define MPU6886_USER_CTRL_FIFO_RST  0x04        // FIFO リセット
+#define MPU6886_PWR_MGMT_1_CLKSEL   0x01        // クロック自動選択
+
+#define MPU6886_INTERNAL_RATE       1000        // 内部サンプリング周波数[Hz]
+#define MPU6886_FIFO_SIZE           1024        // FIFO の大きさ[byte]
+#define MPU6886_FIFO_PACKET_SIZE    14          // FIFO の１サンプルの大きさ[byte]
+#define MPU6886_GYRO_LSB            16.4f       // ジャイロ 1度/秒あたりの値（±2000度/秒）
+#define MPU6886_ACCEL_LSB           4096.0f     // 加速度 1G あたりの値（±8G）
+#define MPU6886_TEMP_LSB            326.8f      // 温度 1℃あたりの値
+#define MPU6886_TEMP_OFFSET         25.0f       // 温度 0 の値の温度[℃]
+
+// センサのレジスタ読み書き（I2C、またはホスト上の模擬センサ）
+class ImuRegisterBus
+{
+public:
+    virtual ~ImuRegisterBus() {}
+    // 書き込み（１レジスタ）
+    virtual bool Write(uint8_t reg, uint8_t value) = 0;
+    // 連続読み出し（reg から length バイト。FIFO_R_W は同じレジスタから続けて読み出す）
+    virtual bool Read(uint8_t reg, uint8_t *dst, size_t length) = 0;
+    // １回の連続読み出しの最大バイト数
+    virtual size_t MaxRead() const = 0;
+};
+
+struct ImuSample {                          // センサの１サンプル
+    float                   ax, ay, az;     // 加速度[G]
+    float                   gx, gy, gz;     // 角速度[度/秒]
+    float                   temp;           // 内部温度[℃]
+};
+
+class Mpu6886Fifo
+{
+public:
+
+    enum RESULT {                           // FIFO 一括取得処理結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_ERR_DEVICE,                  // デバイス ID 不一致
+        RESULT_ERR_BUS,                     // レジスタ読み書き失敗
+        RESULT_ERR_ARGS,                    // 引数エラー
+        RESULT_NUM                          // FIFO 一括取得処理結果数
+    };
+
+    struct Stats {                          // FIFO 一括取得統計情報
+        uint32_t    drains;                 // 読み出し回数（起床回数）
+        uint32_t    samples;                // 読み出したサンプル数
+        uint32_t    transactions;           // レジスタ読み出し回数（I2C トランザクション数）
+        uint32_t    overflows;              // FIFO 溢れ回数（溢れた間のサンプルは失われる）
+        uint32_t    maxBatch;               // １回に読み出した最大サンプル数
+    };
+
+    // コンストラクタ
+    Mpu6886Fifo(ImuRegisterBus *bus);
+
+    // 初期化（サンプリング周波数[Hz]（1000 を割り切れる値）を設定して FIFO を開始する）
+    RESULT Init(uint32_t rateHz);
+    // 読み出し（FIFO に溜まったサンプルを最大 maxSamples 個まとめて読み出し、読み出した数を返す。
+    //           FIFO 件数の読み出し１回と、MaxRead バイト毎の連続読み出しで読む）
+    size_t Drain(ImuSample *samples, size_t maxSamples);
+    // FIFO リセット（溜まっているサンプルを捨てる）
+    RESULT Reset();
+    // サンプリング周期[秒]
+    float Period() const { return 1.0f / (float)_rate; }
+    // 統計情報取得
+    void GetStats(Stats *stats) const { *stats = _stats; }
+    // 統計情報クリア
+    void ClearStats();
+
+private:
+    ImuRegisterBus          *_bus;          // レジスタ読み書き
+    uint32_t                _rate;          // サンプリング周波数[Hz]
+    Stats                   _stats;         // 統計情報
+
+    // 読み出し（統計のトランザクション数を数える）
+    bool read(uint8_t reg, uint8_t *dst, size_t length);
+    // FIFO の１サンプルの変換
+    static void decode(const uint8_t *src, ImuSample *sample);
+};
+
+#endif /* _MPU6886_FIFO_H_ */
@@ -5,6 +5,21 @@
  * @author     SONODA Takehiko (OzoraKobo)
  * @details    標準シリアルポートで受信した文字列をバッファに格納し、通知する
  * @date       2021/09/09 v1.00 新規作成
+ * @date       2026/10/16 v1.01 イベント駆動受信モード、受信統計情報（起床回数・受信遅延）追加
+ * @date       2026/10/16 v1.02 受信メッセージスロットプール追加（キューはスロット番号と長さのみ送受信）
+ * @date       2026/10/16 v1.03 非ブロッキング／タイムアウト指定受信、受信通知タスク登録追加
+ * @date       2026/10/16 v1.04 受信メッセージに受信時刻を付加
+ * @date       2026/10/16 v1.05 COBS＋CRC-16 バイナリフレーム受信追加（メッセージ毎にテキスト／フレームを自動判別）
+ * @date       2026/10/16 v1.06 受信データの一括読み出し、ワード単位の区切りコード検索、エコーバックの一括送信
+ * @date       2026/10/16 v1.07 受信統計情報（受信バイト数・行数・破棄数・キュー最大使用数・キュー滞留時間分布）追加
+ * @date       2026/10/16 v1.08 フロー制御（XON/XOFF・RTS）追加、キューフル時の送信待ちを廃止
+ * @date       2026/10/16 v1.09 最大メッセージ長・キュー段数をテンプレート引数で指定し、バッファ・キューを静的確保
+ * @date       2026/10/16 v1.10 受信ポート指定（HardwareSerial・Stream）、複数ポートを１タスクで受信する SerialReceiveMux 追加
+ * @date       2026/10/16 v1.11 ログ・統計出力先設定追加、RXHIST 行を１回で出力
+ * @date       2026/10/16 v1.12 ポーリングの待ちを固定位相の周期実行（TaskPeriod）とし、周期実行統計取得を追加
+ * @date       2026/10/16 v1.13 フロー制御ありのキューフル時に受信タスクを止めず、受信メッセージを保留して次の起床で再送信
+ * @date       2026/10/16 v1.14 受信遅延を受信中メッセージの先頭バイトを読み出した起床の受信通知時刻から計測
+ * @date       2026/10/16 v1.15 受信メッセージの受信時刻を先頭バイトを読み出した起床の受信通知時刻とする（受信遅延と同じ起点）
  * @par     
  * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
  ******************************************************************************/
@@ -12,54 +27,173 @@
 #include <freertos/FreeRTOS.h>
 #include "SerialReceive.h"
 
-#define RECV_MSG_MAX_SIZE           (SERIAL_RECEIVE_BUFF_SIZE - 1)  // 受信メッセージ最大サイズ
-#define RECV_BUFF_SIZE              SERIAL_RECEIVE_BUFF_SIZE        // シリアル受信バッファサイズ
-#define RECV_MSG_QUEUE_NUM          4                               // シリアル受信メッセージキュー数
-#define RECV_MSG_QUEUE_SIZE         RECV_BUFF_SIZE                  // シリアル受信メッセージキューサイズ
+#define RECV_EVENT_WAIT_TIMEOUT     1000                            // UART受信通知待ちタイムアウト[ms]
+#define RECV_RATE_PERIOD            1000000                         // タスク起床回数計測周期[us]
+#define RECV_CHUNK_SIZE             64                              // フレーム受信時の一括読み出しサイズ
+#define FLOW_XON                    0x11                            // 送信再開要求コード（DC1）
+#define FLOW_XOFF                   0x13                            // 送信停止要求コード（DC3）
 
-SerialReceive::SerialReceive(SerialReceive::LOG_LEVEL logLevel)
+// UART受信通知（HardwareSerial::onReceive）は arduino-esp32 v2.0.3 以降で使用可能
+#if defined(ESP_ARDUINO_VERSION_VAL)
+#if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(2, 0, 3)
+#define RECV_EVENT_SUPPORTED
+#endif
+#endif
+
+// 区切りコード（'\r', '\n', '\0'）検索
+// 4バイトのワード単位で判定し（SWAR）、見つかったワード内だけバイト単位で位置を求める
+static int findDelimiter(const char *data, int length)
+{
+    const uint32_t  ones  = 0x01010101UL;   // 各バイト 0x01
+    const uint32_t  highs = 0x80808080UL;   // 各バイト 0x80
+    const uint32_t  crs   = ones * '\r';    // 各バイト '\r'
+    const uint32_t  lfs   = ones * '\n';    // 各バイト '\n'
+    int             pos = 0;                // 検索位置
+
+    // ワード境界までバイト単位で検索する
+    while ((pos < length) && (((uintptr_t)(data + pos) & (sizeof (uint32_t) - 1)) != 0)) {
+        char c = data[pos];
+        if ((c == '\r') || (c == '\n') || (c == '\0')) {
+            return pos;
+        }
+        pos++;
+    }
+    // ワード単位で検索する（いずれかのバイトが 0 になるワードを検出）
+    while ((pos + (int)sizeof (uint32_t)) <= length) {
+        uint32_t    word;
+        memcpy(&word, data + pos, sizeof (word));
+        uint32_t    xcr = word ^ crs;
+        uint32_t    xlf = word ^ lfs;
+        if ((((word - ones) & ~word) | ((xcr - ones) & ~xcr) | ((xlf - ones) & ~xlf)) & highs) {
+            // このワード内に区切りコードあり
+            break;
+        }
+        pos += sizeof (uint32_t);
+    }
+    // 残りをバイト単位で検索する
+    while (pos < length) {
+        char c = data[pos];
+        if ((c == '\r') || (c == '\n') || (c == '\0')) {
+            return pos;
+        }
+        pos++;
+    }
+
+    // 区切りコードなし
+    return length;
+}
+
+SerialReceiveBase::SerialReceiveBase(SerialReceiveBase::LOG_LEVEL logLevel)
 {
     // シリアル受信プロパティ初期化
     _logLevel = logLevel;                   // ログ出力レベル
+    _out = &Serial;                         // ログ出力先
     init = false;                           // 初期化済フラグ
     _echoback = false;                      // エコーバック
+    _mode = RECV_MODE_POLLING;              // シリアル受信モード
     _task_period = 1;                       // タスク駆動周期[ms]
     _callback = 0;                          // コールバック関数へのポインタ
-    // シリアル受信バッファメモリ割り当て
-    recvBuff = (char *)pvPortMalloc(RECV_BUFF_SIZE);
-    if (recvBuff == NULL) {
-        // メモリ確保失敗
+    _port = &Serial;                        // 受信ポート
+    _hwPort = &Serial;                      // 受信ポート（HardwareSerial）
+    _portId = 0;                            // 受信ポート番号
+    taskHandle = NULL;                      // シリアル受信タスクハンドル
+    notifyTask = NULL;                      // 受信メッセージ通知先タスクハンドル
+    rxEventTime = 0;                        // UART受信通知時刻[us]
+    rxStartTime = 0;                        // 受信中メッセージ先頭バイト受信時刻[us]
+    wakeups = 0;                            // タスク起床回数（累計）
+    wakeupsPerSec = 0;                      // タスク起床回数[回/s]
+    rateWakeups = 0;                        // 起床回数計測開始時のタスク起床回数
+    rateStartTime = 0;                      // 起床回数計測開始時刻[us]
+    latencyCount = 0;                       // 受信→キュー送信遅延 計測数
+    latencySum = 0;                         // 受信→キュー送信遅延 積算[us]
+    latencyMax = 0;                         // 受信→キュー送信遅延 最大[us]
+    frameMode = false;                      // フレーム受信中
+    framesOk = 0;                           // フレーム受信数
+    frameCrcErrors = 0;                     // フレームCRCエラー数
+    frameFormatErrors = 0;                  // フレーム形式・長さエラー数
+    bytesReceived = 0;                      // 受信バイト数
+    linesPosted = 0;                        // テキスト行キュー送信数
+    linesTruncated = 0;                     // 最大サイズで分割したテキスト行数
+    emptyLines = 0;                         // 空行数
+    queueFullDrops = 0;                     // キューフルによる破棄数
+    queueHighWater = 0;                     // キュー最大使用数
+    memset(residenceHist, 0, sizeof (residenceHist));  // キュー滞留時間分布
+    _flow = FLOW_CONTROL_NONE;              // フロー制御方式
+    _flowHigh = SERIAL_RECEIVE_FLOW_HIGH_DEFAULT;   // 送信停止要求キュー使用数
+    _flowLow = SERIAL_RECEIVE_FLOW_LOW_DEFAULT;     // 送信再開要求キュー使用数
+    _rtsPin = -1;                           // RTS 端子番号
+    flowPaused = false;                     // 送信停止要求中
+    flowPauses = 0;                         // 送信停止要求回数
+    flowStalls = 0;                         // キューフルによる受信処理保留回数
+    recvBytes = 0;                          // 受信メッセージバイト数
+    slotBuff = NULL;                        // 受信メッセージスロットメモリへのポインタ
+    recvBuff = NULL;                        // シリアル受信バッファへのポインタ
+    recvSlot = 0;                           // 受信中メッセージスロット番号
+    _slotSize = 0;                          // 受信メッセージスロットサイズ
+    _depth = 0;                             // 受信メッセージキュー数
+    _slotNum = 0;                           // 受信メッセージスロット数
+    _restBuff = NULL;                       // 未処理データ退避バッファへのポインタ
+    restBytes = 0;                          // 退避中の未処理バイト数
+    msgPending = false;                     // 受信メッセージのキュー送信保留中
+    pendingType = MSG_TYPE_TEXT;            // キュー送信保留中の受信メッセージ種別
+    queRecvMsg = NULL;                      // 受信メッセージキューハンドル
+    queFreeSlot = NULL;                     // 空き受信メッセージスロットキューハンドル
+    running = false;                        // タスク駆動中
+    status = STATUS_CREATED;                // シリアル受信状態（生成済）
+
+    // ログ出力
+    logOutput(LOG_INFO, "SerialReceive object created.\n");
+}
+
+// 受信バッファ・キュー領域設定
+void SerialReceiveBase::attachStorage(char *slots, uint16_t slotSize, uint8_t depth, uint8_t *restBuff,
+                                      uint8_t *queueStorage, StaticQueue_t *queueStatic, uint8_t *freeStorage, StaticQueue_t *freeStatic)
+{
+    slotBuff = slots;                       // 受信メッセージスロットメモリへのポインタ
+    _slotSize = slotSize;                   // 受信メッセージスロットサイズ
+    _depth = depth;                         // 受信メッセージキュー数
+    _slotNum = depth + 2;                   // 受信メッセージスロット数（キュー数＋受信中＋取得中）
+    _restBuff = restBuff;                   // 未処理データ退避バッファへのポインタ
+    memset(slotBuff, 0, _slotNum * _slotSize);  // 受信メッセージスロットメモリクリア
+
+    // 受信メッセージキュー生成（領域は派生クラスが静的に確保済）
+    queRecvMsg = xQueueCreateStatic(_depth, sizeof (RecvQueueItem), queueStorage, queueStatic);
+    if (queRecvMsg == NULL) {
+        // キュー生成失敗
         status = STATUS_FAILED;
         return;
     }
-    memset(recvBuff, 0, RECV_BUFF_SIZE + 1);  // シリアル受信バッファメモリクリア
-    // 受信メッセージキュー生成
-    queRecvMsg = xQueueCreate(RECV_MSG_QUEUE_NUM, RECV_MSG_QUEUE_SIZE);
-    if (queRecvMsg == NULL) {
+    // 空き受信メッセージスロットキュー生成
+    queFreeSlot = xQueueCreateStatic(_slotNum, sizeof (uint8_t), freeStorage, freeStatic);
+    if (queFreeSlot == NULL) {
         // キュー生成失敗
         status = STATUS_FAILED;
         return;
     }
-
-    running = false;                        // タスク駆動中
-    status = STATUS_CREATED;                // シリアル受信状態（生成済）
-
-    // ログ出力
-    logOutput(LOG_INFO, "SerialReceive object created.\n");
+    // スロット0を受信中とし、残りを空きスロットとする
+    recvSlot = 0;
+    recvBuff = slotBuff;
+    for (uint8_t slot = 1; slot < _slotNum; slot++) {
+        xQueueSend(queFreeSlot, (void *)&slot, (TickType_t)0);
+    }
 }
 
-SerialReceive::~SerialReceive()
+SerialReceiveBase::~SerialReceiveBase()
 {
     if (queRecvMsg) {
-        // シリアル受信バッファメモリ解放
+        // 受信メッセージキュー解放
         vQueueDelete(queRecvMsg);
     }
+    if (queFreeSlot) {
+        // 空き受信メッセージスロットキュー解放
+        vQueueDelete(queFreeSlot);
+    }
 
     logOutput(LOG_INFO, "SerialReceive object deleted.\n");
 }
 
 // シリアル受信バッファオブジェクト設定値表示
-void SerialReceive::DispProperties()
+void SerialReceiveBase::DispProperties()
 {
     if (_logLevel < LOG_DEBUG) {
         // ログ出力レベルがDEBUG未満
@@ -67,30 +201,46 @@ void SerialReceive::DispProperties()
         return;
     }
 
-    Serial.print("Serial Receiver values of object.\n");
+    _out->print("Serial Receiver values of object.\n");
 
     // 初期化済フラグ
-    Serial.printf("init : %d\n", init);
+    _out->printf("init : %d\n", init);
     // エコーバック
-    Serial.printf("echoback : %d\n", _echoback);
+    _out->printf("echoback : %d\n", _echoback);
+    // シリアル受信モード
+    _out->printf("receive mode : %d\n", _mode);
+    // 受信ポート番号
+    _out->printf("port : %d (hardware serial %d)\n", _portId, (_hwPort != NULL));
     // タスク駆動周期[ms]
-    Serial.printf("task_period : %d\n", _task_period);
+    _out->printf("task_period : %d\n", _task_period);
     // コールバック関数へポインタ
-    Serial.printf("callback function: %08X\n", _callback);
+    _out->printf("callback function: %08X\n", _callback);
     // シリアル受信バッファへのポインタ
-    Serial.printf("receive buffer : %08X\n", recvBuff);
+    _out->printf("receive buffer : %08X\n", recvBuff);
+    // 受信メッセージスロットサイズ・スロット数・キュー数
+    _out->printf("slot size : %d, slots : %d, queue depth : %d\n", _slotSize, _slotNum, _depth);
+    // 受信中メッセージスロット番号
+    _out->printf("receive slot : %d\n", recvSlot);
     // 受信メッセージキューハンドル
-    Serial.printf("receive message quiue handle : %08X\n", queRecvMsg);
+    _out->printf("receive message quiue handle : %08X\n", queRecvMsg);
     // 受信メッセージバイト数
-    Serial.printf("received bytes : %d\n", recvBytes);
+    _out->printf("received bytes : %d\n", recvBytes);
     // タスク駆動中
-    Serial.printf("running : %d\n", running);
+    _out->printf("running : %d\n", running);
     // シリアル受信状態
-    Serial.printf("status : %d\n", status);
+    _out->printf("status : %d\n", status);
+    // タスク起床回数
+    _out->printf("wakeups : %u (%u/s)\n", wakeups, wakeupsPerSec);
+    // 受信→キュー送信遅延
+    _out->printf("latency max : %u us\n", latencyMax);
+    // フレーム受信数・エラー数
+    _out->printf("frames : %u (crc error %u, format error %u)\n", framesOk, frameCrcErrors, frameFormatErrors);
+    // フロー制御
+    _out->printf("flow control : %d (high %d, low %d, rts pin %d, paused %d)\n", _flow, _flowHigh, _flowLow, _rtsPin, flowPaused);
 }
 
 // シリアル受信バッファオブジェクト初期化
-SerialReceive::RESULT SerialReceive::Init(bool echoback, SerialReceiveCallback callback)
+SerialReceiveBase::RESULT SerialReceiveBase::Init(bool echoback, SerialReceiveCallback callback, RECV_MODE mode)
 {
     logOutput(LOG_INFO, "SerialReceive Initialize\n");
 
@@ -100,9 +250,29 @@ SerialReceive::RESULT SerialReceive::Init(bool echoback, SerialReceiveCallback c
         return RESULT_ALREADY_INIT;
     }
 
+    if ((mode < RECV_MODE_POLLING) || (mode >= RECV_MODE_NUM)) {
+        // シリアル受信モード不正
+        return RESULT_ERR_PARAM;
+    }
+
     // エコーバック
     _echoback = echoback;
 
+    // シリアル受信モード
+    _mode = mode;
+#ifndef RECV_EVENT_SUPPORTED
+    if (_mode == RECV_MODE_EVENT) {
+        // UART受信通知非対応 → ポーリングで動作する
+        logOutput(LOG_WARNING, "SerialReceive event mode is not supported, using polling mode.\n");
+        _mode = RECV_MODE_POLLING;
+    }
+#endif
+    if ((_mode == RECV_MODE_EVENT) && (_hwPort == NULL)) {
+        // HardwareSerial 以外のポートはUART受信通知なし → ポーリングで動作する
+        logOutput(LOG_WARNING, "SerialReceive port has no receive event, using polling mode.\n");
+        _mode = RECV_MODE_POLLING;
+    }
+
     // コールバック関数へのポインタ
     _callback = callback;
 
@@ -124,7 +294,7 @@ SerialReceive::RESULT SerialReceive::Init(bool echoback, SerialReceiveCallback c
     return RESULT_SUCCESS;
 }
 
-SerialReceive::RESULT SerialReceive::Start()
+SerialReceiveBase::RESULT SerialReceiveBase::Start()
 {
     logOutput(LOG_INFO, "SerialReceive task starting...\n");
     // タスクスタート
@@ -133,100 +303,645 @@ SerialReceive::RESULT SerialReceive::Start()
     return RESULT_SUCCESS;
 }
 
-// シリアル受信データ取得
-SerialReceive::RESULT SerialReceive::GetReceiveData(char *data)
+// シリアル受信データ取得（待ち時間[ms]指定）
+SerialReceiveBase::RESULT SerialReceiveBase::GetReceiveData(char *data, uint32_t timeout)
 {
-    RESULT      result = RESULT_SUCCESS;    // 処理結果
-    BaseType_t  queurResult;                // キュー送信の結果
+    RESULT      result;                     // 処理結果
+    RecvMsg     msg;                        // 受信メッセージ
+
+    if (data == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    // 受信メッセージを取得し、終端文字を含めて呼び出し元バッファにコピーする
+    result = ReceiveMsg(&msg, timeout);
+    if (result != RESULT_SUCCESS) {
+        return result;
+    }
+    memcpy(data, msg.data, msg.length + 1);
+
+    // 受信メッセージスロット解放
+    return ReleaseMsg(&msg);
+}
+
+// シリアル受信データ取得（待ちなし）
+SerialReceiveBase::RESULT SerialReceiveBase::TryGetReceiveData(char *data)
+{
+    return GetReceiveData(data, 0);
+}
+
+// 受信メッセージ取得（スロット参照、待ち時間[ms]指定）
+SerialReceiveBase::RESULT SerialReceiveBase::ReceiveMsg(RecvMsg *msg, uint32_t timeout)
+{
+    BaseType_t      queurResult;            // キュー受信の結果
+    RecvQueueItem   item;                   // 受信メッセージキュー要素
+    TickType_t      ticks;                  // キュー受信待ちティック数
+
+    if (msg == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    // 待ち時間[ms]をティック数に変換する
+    ticks = (timeout == SERIAL_RECEIVE_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout);
 
     // 受信メッセージを受信メッセージキューから取得する
-    queurResult = xQueueReceive(queRecvMsg, (void *)data, (TickType_t)10);
+    queurResult = xQueueReceive(queRecvMsg, (void *)&item, ticks);
     if (queurResult != pdPASS) {
         // キュー受信失敗
         // 受信メッセージなし
         return RESULT_NO_RECV_DATA;
     }
 
+    // キュー滞留時間を log2 区間で集計する
+    uint32_t residence = micros() - item.queued;
+    int bin = (residence == 0) ? 0 : (31 - __builtin_clz(residence));
+    residenceHist[(bin < SERIAL_RECEIVE_HIST_NUM) ? bin : (SERIAL_RECEIVE_HIST_NUM - 1)]++;
+
+    if (flowPaused && taskHandle) {
+        // 送信停止要求中 キューが空いたのでシリアル受信タスクに再開判定させる
+        xTaskNotifyGive(taskHandle);
+    }
+
+    // 受信メッセージスロットを参照として渡す（コピーしない）
+    msg->data = slotBuff + (item.slot * _slotSize);
+    msg->length = item.length;
+    msg->slot = item.slot;
+    msg->type = item.type;
+    msg->port = _portId;
+    msg->time = item.time;
+
     // 受信メッセージ取得成功
-    return result;
+    return RESULT_SUCCESS;
+}
+
+// 受信メッセージ取得（スロット参照、待ちなし）
+SerialReceiveBase::RESULT SerialReceiveBase::TryReceiveMsg(RecvMsg *msg)
+{
+    return ReceiveMsg(msg, 0);
+}
+
+// 受信メッセージ解放
+SerialReceiveBase::RESULT SerialReceiveBase::ReleaseMsg(RecvMsg *msg)
+{
+    if ((msg == NULL) || (msg->slot >= _slotNum)) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    // 受信メッセージスロットを空きスロットに戻す
+    if (xQueueSend(queFreeSlot, (void *)&msg->slot, (TickType_t)0) != pdPASS) {
+        // 解放済スロットの二重解放
+        return RESULT_ERR_STATE;
+    }
+    if (msgPending && taskHandle) {
+        // キュー送信保留中 空きスロットができたのでシリアル受信タスクに再送信させる
+        xTaskNotifyGive(taskHandle);
+    }
+    msg->data = NULL;
+    msg->length = 0;
+
+    return RESULT_SUCCESS;
 }
 
 // シリアル受信状態取得
-SerialReceive::STATUS SerialReceive::GetStatus()
+SerialReceiveBase::STATUS SerialReceiveBase::GetStatus()
 {
     // シリアル受信状態を返す
     return status;
 }
 
 // シリアル受信最大サイズ取得
-int SerialReceive::GetRecvMaxSize()
+int SerialReceiveBase::GetRecvMaxSize()
+{
+    // 受信メッセージスロットサイズを返す
+    return _slotSize;
+}
+
+// 受信通知先タスク登録
+SerialReceiveBase::RESULT SerialReceiveBase::SetNotifyTask(TaskHandle_t task)
+{
+    // 受信メッセージをキューに送信する毎に登録タスクへ通知する（ulTaskNotifyTake で待つ）
+    notifyTask = task;
+
+    return RESULT_SUCCESS;
+}
+
+// 受信ポート設定（HardwareSerial）
+SerialReceiveBase::RESULT SerialReceiveBase::SetPort(HardwareSerial *port, uint8_t portId)
+{
+    if (port == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+    if (running) {
+        // 受信開始後は変更できない
+        return RESULT_ERR_STATE;
+    }
+
+    _port = port;
+    _hwPort = port;
+    _portId = portId;
+
+    return RESULT_SUCCESS;
+}
+
+// 受信ポート設定（Stream）
+SerialReceiveBase::RESULT SerialReceiveBase::SetPort(Stream *port, uint8_t portId)
+{
+    if (port == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+    if (running) {
+        // 受信開始後は変更できない
+        return RESULT_ERR_STATE;
+    }
+
+    _port = port;
+    _hwPort = NULL;
+    _portId = portId;
+
+    return RESULT_SUCCESS;
+}
+
+// 受信ポート番号取得
+uint8_t SerialReceiveBase::GetPortId()
 {
-    // シリアル受信バッファサイズを返す
-    return RECV_BUFF_SIZE;
+    return _portId;
 }
 
-void SerialReceive::run(void *data)
+// ログ・統計出力先設定
+void SerialReceiveBase::SetOutput(Print *out)
+{
+    _out = (out != NULL) ? out : &Serial;
+}
+
+// フロー制御設定
+SerialReceiveBase::RESULT SerialReceiveBase::SetFlowControl(FLOW_CONTROL flow, int highWater, int lowWater, int rtsPin)
+{
+    if ((flow < FLOW_CONTROL_NONE) || (flow >= FLOW_CONTROL_NUM)) {
+        // フロー制御方式不正
+        return RESULT_ERR_PARAM;
+    }
+    if ((lowWater < 0) || (lowWater >= highWater) || (highWater > _depth)) {
+        // キュー使用数の指定不正
+        return RESULT_ERR_PARAM;
+    }
+    if ((flow == FLOW_CONTROL_RTS) && (rtsPin < 0)) {
+        // RTS 端子の指定なし
+        return RESULT_ERR_PARAM;
+    }
+
+    _flow = flow;
+    _flowHigh = highWater;
+    _flowLow = lowWater;
+    _rtsPin = rtsPin;
+    flowPaused = false;
+    if (_flow == FLOW_CONTROL_RTS) {
+        // RTS 端子を出力に設定し、受信可（LOW）とする
+        pinMode(_rtsPin, OUTPUT);
+        digitalWrite(_rtsPin, LOW);
+    }
+
+    return RESULT_SUCCESS;
+}
+
+// シリアル受信統計情報取得
+SerialReceiveBase::RESULT SerialReceiveBase::GetRecvStats(RecvStats *stats)
+{
+    if (stats == NULL) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+
+    // 受信タスクを止めずに読み出す（各値は32bitで個別に一貫している）
+    uint32_t count = latencyCount;
+    stats->mode = _mode;                    // シリアル受信モード
+    stats->wakeups = wakeups;               // タスク起床回数（累計）
+    stats->wakeupsPerSec = wakeupsPerSec;   // タスク起床回数[回/s]
+    stats->latencyCount = count;            // 受信→キュー送信遅延 計測数
+    stats->latencyAvg = (count > 0) ? (latencySum / count) : 0;    // 受信→キュー送信遅延 平均[us]
+    stats->latencyMax = latencyMax;         // 受信→キュー送信遅延 最大[us]
+    stats->framesOk = framesOk;             // フレーム受信数（CRC正常）
+    stats->frameCrcErrors = frameCrcErrors; // フレームCRCエラー数
+    stats->frameFormatErrors = frameFormatErrors;   // フレーム形式・長さエラー数
+    stats->bytesReceived = bytesReceived;   // 受信バイト数
+    stats->linesPosted = linesPosted;       // テキスト行キュー送信数
+    stats->linesTruncated = linesTruncated; // 最大サイズで分割したテキスト行数
+    stats->emptyLines = emptyLines;         // 空行数
+    stats->queueFullDrops = queueFullDrops; // キューフルによる破棄数
+    stats->queueHighWater = queueHighWater; // キュー最大使用数
+    stats->queueDepth = _depth;             // キュー段数
+    for (int i = 0; i < SERIAL_RECEIVE_HIST_NUM; i++) {
+        stats->residenceHist[i] = residenceHist[i];     // キュー滞留時間分布
+    }
+    stats->port = _portId;                  // 受信ポート番号
+    stats->flowControl = _flow;             // フロー制御方式
+    stats->flowPaused = flowPaused;         // 送信停止要求中
+    stats->flowPauses = flowPauses;         // 送信停止要求回数
+    stats->flowStalls = flowStalls;         // キューフルによる受信処理待ち回数
+
+    return RESULT_SUCCESS;
+}
+
+// シリアル受信統計情報表示
+void SerialReceiveBase::DispRecvStats()
+{
+    RecvStats   stats;      // シリアル受信統計情報
+
+    GetRecvStats(&stats);
+
+    _out->printf("RXSTAT, port=%d, mode=%d, wakeups=%u, wakeups/s=%u, bytes=%u, lines=%u, truncated=%u, empty=%u\n",
+        stats.port, stats.mode, stats.wakeups, stats.wakeupsPerSec, stats.bytesReceived, stats.linesPosted, stats.linesTruncated, stats.emptyLines);
+    _out->printf("RXSTAT, frames=%u, crcerr=%u, fmterr=%u, drops=%u, queue=%u/%u, latency avg=%uus max=%uus\n",
+        stats.framesOk, stats.frameCrcErrors, stats.frameFormatErrors, stats.queueFullDrops, stats.queueHighWater, stats.queueDepth,
+        stats.latencyAvg, stats.latencyMax);
+    _out->printf("RXSTAT, flow=%d, paused=%d, pauses=%u, stalls=%u\n",
+        stats.flowControl, stats.flowPaused, stats.flowPauses, stats.flowStalls);
+    // キュー滞留時間分布（区間下限[us]:件数） 出力先が非同期送信でも行が分断されないよう１回で出力する
+    char    hist[8 + (SERIAL_RECEIVE_HIST_NUM * 24)];   // RXHIST 行
+    int     length = snprintf(hist, sizeof (hist), "RXHIST");
+    for (int i = 0; i < SERIAL_RECEIVE_HIST_NUM; i++) {
+        length += snprintf(hist + length, sizeof (hist) - length, ", %u:%u", (i == 0) ? 0 : (1U << i), stats.residenceHist[i]);
+    }
+    snprintf(hist + length, sizeof (hist) - length, "\n");
+    _out->print(hist);
+}
+
+// 周期実行統計情報取得
+void SerialReceiveBase::GetPeriodStats(TaskPeriod::Stats *stats) const
+{
+    _taskPeriod.GetStats(stats);
+}
+
+void SerialReceiveBase::run(void *data)
 {
     data = nullptr;
 
     logOutput(LOG_INFO, "SerialReceive task started.\n");
 
+    // 受信開始（UART受信通知先はこのタスク）
+    beginReceive(xTaskGetCurrentTaskHandle());
+    if (_mode != RECV_MODE_EVENT) {
+        // ポーリング タスク駆動周期の起点
+        _taskPeriod.Start(_task_period);
+    }
+
+    while (1)
+    {
+        // 受信済データを１回の起床ですべて処理する
+        recvAvailable();
+        // キューが空いていれば送信再開を要求する
+        updateFlowControl();
+
+        if (_mode == RECV_MODE_EVENT) {
+            // イベント駆動 UART受信通知待ち
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RECV_EVENT_WAIT_TIMEOUT));
+        }
+        else {
+            // ポーリング 受信データはこの時刻以降に到着したものとする（到着時刻は分からないため受信遅延は上限値となる）
+            rxEventTime = micros();
+            _taskPeriod.Wait();
+        }
+
+        // タスク起床回数計測
+        countWakeup();
+    }
+}
+
+// 受信開始処理
+void SerialReceiveBase::beginReceive(TaskHandle_t task)
+{
     // ゴミデータを読み捨てる
-    while (Serial.available() > 0) {
-        char _c = Serial.read();
+    while (_port->available() > 0) {
+        char _c = _port->read();
+    }
+
+    // UART受信通知先・キュー再開通知先を設定する
+    taskHandle = task;
+#ifdef RECV_EVENT_SUPPORTED
+    if ((_mode == RECV_MODE_EVENT) && (_hwPort != NULL)) {
+        // イベント駆動 UART受信通知ハンドラ登録
+        _hwPort->onReceive([this]() { onReceiveEvent(); });
     }
+#endif
+
+    // 起床回数計測開始
+    rateStartTime = micros();
+    rxEventTime = rateStartTime;
 
     // タスク駆動中セット
     running = true;
     // シリアル受信受信待ち
     status = STATUS_RECV_WAIT;
+}
 
-    while (1)
-    {
-        while (Serial.available() > 0) {
-            char _c = Serial.read();
-            if (_echoback) {
-                // エコーバック有効
-                Serial.printf("%c", _c);
+// 受信タスク起床回数計測
+void SerialReceiveBase::countWakeup()
+{
+    wakeups++;
+    uint32_t now = micros();
+    uint32_t elapsed = now - rateStartTime;
+    if (elapsed >= RECV_RATE_PERIOD) {
+        // 起床回数計測周期経過
+        wakeupsPerSec = (uint32_t)((uint64_t)(wakeups - rateWakeups) * RECV_RATE_PERIOD / elapsed);
+        rateWakeups = wakeups;
+        rateStartTime = now;
+    }
+}
+
+// 受信済データ一括処理
+void SerialReceiveBase::recvAvailable()
+{
+    int     avail;      // 受信済バイト数
+    int     count;      // 読み出したバイト数
+
+    if (!resumePending()) {
+        // キュー送信保留中 未処理データはUART受信バッファに残し、このポートは次の起床まで処理しない
+        return;
+    }
+
+    while ((avail = _port->available()) > 0) {
+        if ((recvBytes == 0) && !frameMode) {
+            // 受信メッセージの先頭 この起床の受信通知時刻を先頭バイトの受信時刻とする
+            rxStartTime = rxEventTime;
+        }
+        if (frameMode) {
+            // フレーム受信中 まとめて読み出し１バイトずつデコードする
+            // （キュー送信保留で中断した残りを退避できるよう、退避バッファに収まる長さだけ読み出す）
+            uint8_t chunk[RECV_CHUNK_SIZE];
+            int     size = ((_slotSize - 1) < RECV_CHUNK_SIZE) ? (_slotSize - 1) : RECV_CHUNK_SIZE;
+            count = _port->readBytes(chunk, (avail < size) ? avail : size);
+            int i;
+            for (i = 0; (i < count) && !msgPending; i++) {
+                if (!recvByte(chunk[i])) {
+                    break;
+                }
             }
-            if ((_c == '\r') || (_c == '\n')) {
-                // 終端コードを受信
-                // 受信メッセージを受信メッセージキューに移す
-                postRecvMsgQueue();
+            if (i < count) {
+                // キュー送信保留 未処理の残りを退避する
+                restBytes = count - i;
+                memcpy(_restBuff, chunk + i, restBytes);
             }
-            else {
-              // シリアル受信バッファに格納する
-              recvBuff[recvBytes++] = _c;
+        }
+        else {
+            // テキスト受信中 受信用スロットに直接まとめて読み出す
+            int space = (_slotSize - 1) - recvBytes;
+            count = _port->readBytes(recvBuff + recvBytes, (avail < space) ? avail : space);
+            recvText(count);
+        }
+        if (count <= 0) {
+            // 読み出し失敗
+            break;
+        }
+        bytesReceived += count;
+        if (msgPending) {
+            // キュー送信保留 残りはUART受信バッファに残す
+            break;
+        }
+    }
+}
+
+// キュー送信保留の再開
+bool SerialReceiveBase::resumePending()
+{
+    if (msgPending) {
+        // 保留中の受信メッセージを再送信する（キューに空きがなければ保留を続ける）
+        if (!postRecvMsgQueue((MSG_TYPE)pendingType)) {
+            return false;
+        }
+    }
+    if (restBytes > 0) {
+        // 保留で処理を中断した退避データを処理する
+        recvRest();
+    }
+
+    return !msgPending;
+}
+
+// 退避データ処理
+void SerialReceiveBase::recvRest()
+{
+    int     used;       // 処理したバイト数
+
+    for (used = 0; (used < restBytes) && !msgPending; used++) {
+        if (!recvByte(_restBuff[used])) {
+            break;
+        }
+    }
+    // 未処理の残りを退避バッファの先頭に移す
+    restBytes -= used;
+    memmove(_restBuff, _restBuff + used, restBytes);
+}
+
+// 受信１バイト処理
+bool SerialReceiveBase::recvByte(uint8_t data)
+{
+    CobsFrameParser::RESULT     frameResult;    // フレーム解析結果
+
+    if (frameMode) {
+        // フレーム受信中 COBSデコード（１バイトあたり一定時間）
+        frameResult = frameParser.Feed(data);
+        if ((frameResult == CobsFrameParser::RESULT_CONTINUE) || (frameResult == CobsFrameParser::RESULT_EMPTY)) {
+            // フレーム受信継続（連続した区切りコードは読み捨てる）
+            return true;
+        }
+        // フレーム終了 テキスト受信に戻る
+        frameMode = false;
+        if (frameResult == CobsFrameParser::RESULT_FRAME_OK) {
+            // フレーム受信完了 ペイロードを受信メッセージキューに移す
+            framesOk++;
+            recvBytes = (int)frameParser.GetLength();
+            postRecvMsgQueue(MSG_TYPE_FRAME);
+            return true;
+        }
+        // フレームエラー 受信データを破棄する
+        if (frameResult == CobsFrameParser::RESULT_ERR_CRC) {
+            frameCrcErrors++;
+        }
+        else {
+            frameFormatErrors++;
+        }
+        recvBytes = 0;
+        rxStartTime = rxEventTime;
+        logOutput(LOG_WARNING, "SerialReceive frame error.\n");
+        if (_callback) {
+            // コールバック関数登録あり
+            // シリアル受信フレームエラー
+            _callback(EVENT_FRAME_ERROR);
+        }
+        return true;
+    }
+
+    if (data == COBS_FRAME_DELIMITER) {
+        // フレーム開始（テキスト行に 0x00 は含まれない）
+        if (recvBytes > 0) {
+            // 受信中のテキストを受信メッセージキューに移す
+            postRecvMsgQueue(MSG_TYPE_TEXT);
+            if (msgPending) {
+                // キュー送信保留 保留が解けるまでフレーム開始を処理しない
+                return false;
             }
-            if (recvBytes >= RECV_MSG_MAX_SIZE) {
-                // 受信メッセージバイト数が受信メッセージ最大サイズに達した
-                // 受信メッセージを受信メッセージキューに移す
-                postRecvMsgQueue();
-            }    
         }
+        // フレームを受信用スロットにデコードする（'\0'終端の領域を残す）
+        frameMode = true;
+        frameParser.Reset((uint8_t *)recvBuff, _slotSize - 1);
+        return true;
+    }
 
-        delay(_task_period);
+    if (_echoback) {
+        // エコーバック有効
+        _port->write(data);
+    }
+    if ((data == '\r') || (data == '\n')) {
+        // 終端コードを受信
+        // 受信メッセージを受信メッセージキューに移す
+        endTextLine();
+    }
+    else {
+      // シリアル受信バッファに格納する
+      recvBuff[recvBytes++] = (char)data;
+    }
+    if (!msgPending && (recvBytes >= (_slotSize - 1))) {
+        // 受信メッセージバイト数が受信メッセージ最大サイズに達した
+        // 受信メッセージを受信メッセージキューに移す
+        linesTruncated++;
+        postRecvMsgQueue(MSG_TYPE_TEXT);
+    }
+    return true;
+}
+
+// テキスト行終了処理
+void SerialReceiveBase::endTextLine()
+{
+    if (recvBytes == 0) {
+        // 空行（CR/LF の連続）はキューに送信しない
+        emptyLines++;
+        return;
+    }
+    // 受信メッセージを受信メッセージキューに移す
+    postRecvMsgQueue(MSG_TYPE_TEXT);
+}
+
+// 受信テキスト一括処理
+void SerialReceiveBase::recvText(int count)
+{
+    char    *scan = recvBuff + recvBytes;   // 走査位置（受信用スロット内の未処理データ先頭）
+    int     remain = count;                 // 未処理バイト数
+
+    while (remain > 0) {
+        // 区切りコードを検索する
+        int     length = findDelimiter(scan, remain);
+        char    delimiter = (length < remain) ? scan[length] : 0;
+        if (_echoback) {
+            // エコーバック有効 行末コードまでまとめて送信する
+            _port->write((const uint8_t *)scan, length + (((delimiter == '\r') || (delimiter == '\n')) ? 1 : 0));
+        }
+        recvBytes += length;
+        if (length == remain) {
+            // 区切りコードなし 受信継続
+            break;
+        }
+        remain -= length + 1;
+        char    *rest = scan + length + 1;  // 区切りコードの次の未処理データ
+
+        if (delimiter == COBS_FRAME_DELIMITER) {
+            // フレーム開始 区切りコードからの残りのデータは退避して１バイトずつ処理する（受信中テキストの送信でスロットが切り替わるため）
+            restBytes = remain + 1;
+            memcpy(_restBuff, rest - 1, restBytes);
+            recvRest();
+            return;
+        }
+
+        // 終端コードを受信
+        // 受信メッセージを受信メッセージキューに移す
+        endTextLine();
+        if (msgPending) {
+            // キュー送信保留 残りのデータは退避して次の起床で処理する（保留中の受信メッセージはスロットに残す）
+            restBytes = remain;
+            memcpy(_restBuff, rest, restBytes);
+            return;
+        }
+        // 残りのデータを受信用スロットの先頭に移して処理を続ける
+        memmove(recvBuff, rest, remain);
+        scan = recvBuff;
+    }
+
+    if (recvBytes >= (_slotSize - 1)) {
+        // 受信メッセージバイト数が受信メッセージ最大サイズに達した
+        // 受信メッセージを受信メッセージキューに移す
+        linesTruncated++;
+        postRecvMsgQueue(MSG_TYPE_TEXT);
+    }
+}
+
+// UART受信通知ハンドラ
+void SerialReceiveBase::onReceiveEvent()
+{
+    // 受信時刻を記録し、シリアル受信タスクを起床させる
+    rxEventTime = micros();
+    if (taskHandle) {
+        xTaskNotifyGive(taskHandle);
     }
 }
 
 // ログ出力
-void SerialReceive::logOutput(SerialReceive::LOG_LEVEL logLevel, char *logMsg)
+void SerialReceiveBase::logOutput(SerialReceiveBase::LOG_LEVEL logLevel, char *logMsg)
 {
     if (logLevel <= _logLevel) {
         // ログ出力レベルが規定値以下
-        Serial.print(logMsg);
+        _out->print(logMsg);
     }
 }
 
 // 受信メッセージキュー送信
-void SerialReceive::postRecvMsgQueue()
+bool SerialReceiveBase::postRecvMsgQueue(MSG_TYPE type)
 {
-    BaseType_t  queurResult;    // キュー送信の結果
+    BaseType_t      queurResult;    // キュー送信の結果
+    RecvQueueItem   item;           // 受信メッセージキュー要素
+    uint8_t         nextSlot;       // 次の受信用スロット番号
 
-    // 受信メッセージを受信メッセージキューに移す
-    queurResult = xQueueSend(queRecvMsg, (void *)recvBuff, (TickType_t)10);
+    // 受信メッセージを終端する
+    recvBuff[recvBytes] = '\0';
+
+    // キューを待たない（SerialReceiveMux では１つのポートのキューフルで全ポートの受信が止まるため）
+    // フロー制御なしはキューフルで直ちに破棄する
+    // フロー制御ありは送信停止を要求し、受信メッセージをスロットに残して保留する（未処理データはUART受信バッファに残る）
+    if ((_flow != FLOW_CONTROL_NONE) && ((uxQueueSpacesAvailable(queRecvMsg) == 0) || (uxQueueMessagesWaiting(queFreeSlot) == 0))) {
+        if (!msgPending) {
+            flowStalls++;
+        }
+        msgPending = true;
+        pendingType = (uint8_t)type;
+        setFlowPaused(true);
+        return false;
+    }
+    msgPending = false;
+
+    // 次の受信用スロットを確保し、受信メッセージのスロット番号と長さをキューに送信する
+    queurResult = xQueueReceive(queFreeSlot, (void *)&nextSlot, (TickType_t)0);
+    if (queurResult == pdPASS) {
+        item.slot = recvSlot;
+        item.length = (uint16_t)recvBytes;
+        item.type = (uint8_t)type;
+        item.time = rxStartTime;
+        item.queued = micros();
+        queurResult = xQueueSend(queRecvMsg, (void *)&item, (TickType_t)0);
+        if (queurResult == pdPASS) {
+            // 受信用スロットを切り替える
+            recvSlot = nextSlot;
+            recvBuff = slotBuff + (recvSlot * _slotSize);
+        }
+        else {
+            // 確保したスロットを空きスロットに戻す
+            xQueueSend(queFreeSlot, (void *)&nextSlot, (TickType_t)0);
+        }
+    }
     if (queurResult != pdPASS) {
         // 空きキューなし
+        queueFullDrops++;
         logOutput(LOG_WARNING, "SerialReceive queue is full.\n");
         if (_callback) {
             // コールバック関数登録あり
@@ -236,14 +951,202 @@ void SerialReceive::postRecvMsgQueue()
     }
     else {
         // キュー送信成功
+        if (type == MSG_TYPE_TEXT) {
+            linesPosted++;
+        }
+        // キュー最大使用数更新
+        UBaseType_t waiting = uxQueueMessagesWaiting(queRecvMsg);
+        if (waiting > queueHighWater) {
+            queueHighWater = waiting;
+        }
+        // キュー使用数が停止要求数に達したら送信停止を要求する
+        updateFlowControl();
+        // 受信→キュー送信遅延計測（受信中メッセージの先頭バイトから）
+        uint32_t latency = micros() - rxStartTime;
+        latencySum += latency;
+        latencyCount++;
+        if (latency > latencyMax) {
+            latencyMax = latency;
+        }
+        if (notifyTask) {
+            // 受信通知先タスク登録あり
+            xTaskNotifyGive(notifyTask);
+        }
         if (_callback) {
             // コールバック関数登録あり
             // シリアル受信受信完了
             _callback(EVENT_RECV_COMP);
         }
     }
-    // シリアル受信バッファクリア
-    memset(recvBuff, 0, RECV_BUFF_SIZE);
     // 受信メッセージバイト数クリア
+    // 次の受信メッセージの先頭は早くともこの起床で読み出したデータ（後の起床で読み出せば recvAvailable で更新する）
     recvBytes = 0;
+    rxStartTime = rxEventTime;
+
+    return (queurResult == pdPASS);
+}
+
+// フロー制御更新
+void SerialReceiveBase::updateFlowControl()
+{
+    if (_flow == FLOW_CONTROL_NONE) {
+        // フロー制御なし
+        return;
+    }
+
+    int waiting = (int)uxQueueMessagesWaiting(queRecvMsg);
+    if (!flowPaused && (waiting >= _flowHigh)) {
+        // キュー使用数が停止要求数に達した
+        setFlowPaused(true);
+    }
+    else if (flowPaused && !msgPending && (waiting <= _flowLow)) {
+        // キュー使用数が再開要求数まで減った（キュー送信保留中は再開しない）
+        setFlowPaused(false);
+    }
+}
+
+// 送信停止／再開要求
+void SerialReceiveBase::setFlowPaused(bool paused)
+{
+    if (paused == flowPaused) {
+        // 要求状態の変化なし
+        return;
+    }
+    flowPaused = paused;
+    if (paused) {
+        flowPauses++;
+    }
+
+    if (_flow == FLOW_CONTROL_XONXOFF) {
+        // XOFF で停止要求、XON で再開要求
+        _port->write((uint8_t)(paused ? FLOW_XOFF : FLOW_XON));
+    }
+    else if (_flow == FLOW_CONTROL_RTS) {
+        // RTS 端子 HIGH（ネゲート）で停止要求、LOW（アサート）で再開要求
+        digitalWrite(_rtsPin, paused ? HIGH : LOW);
+    }
+}
+
+// シリアル受信マルチプレクサ コンストラクタ
+SerialReceiveMux::SerialReceiveMux(SerialReceiveBase::LOG_LEVEL logLevel)
+{
+    _logLevel = logLevel;                   // ログ出力レベル
+    _out = &Serial;                         // ログ出力先
+    _portNum = 0;                           // 受信ポート数
+    running = false;                        // タスク駆動中
+    for (int index = 0; index < SERIAL_RECEIVE_PORT_MAX; index++) {
+        _ports[index] = NULL;               // 受信ポート
+    }
+}
+
+// 受信ポート追加
+SerialReceiveBase::RESULT SerialReceiveMux::AddPort(SerialReceiveBase *receiver)
+{
+    if (receiver == NULL) {
+        // 引数エラー
+        return SerialReceiveBase::RESULT_ERR_ARGS;
+    }
+    if (running || receiver->running) {
+        // 受信開始後は追加できない
+        return SerialReceiveBase::RESULT_ERR_STATE;
+    }
+    if (_portNum >= SERIAL_RECEIVE_PORT_MAX) {
+        // 受信ポート数が上限に達している
+        return SerialReceiveBase::RESULT_ERR_PARAM;
+    }
+
+    _ports[_portNum++] = receiver;
+
+    return SerialReceiveBase::RESULT_SUCCESS;
+}
+
+// 受信開始
+SerialReceiveBase::RESULT SerialReceiveMux::Start()
+{
+    if (_portNum == 0) {
+        // 受信ポートなし
+        return SerialReceiveBase::RESULT_ERR_STATE;
+    }
+    if (_logLevel >= SerialReceiveBase::LOG_INFO) {
+        _out->print("SerialReceiveMux task starting...\n");
+    }
+    // タスクスタート
+    start();
+
+    return SerialReceiveBase::RESULT_SUCCESS;
+}
+
+// 受信ポート数取得
+int SerialReceiveMux::GetPortCount()
+{
+    return _portNum;
+}
+
+// ログ出力先設定
+void SerialReceiveMux::SetOutput(Print *out)
+{
+    _out = (out != NULL) ? out : &Serial;
+}
+
+// 周期実行統計情報取得
+void SerialReceiveMux::GetPeriodStats(TaskPeriod::Stats *stats) const
+{
+    _taskPeriod.GetStats(stats);
+}
+
+// 受信タスク関数
+void SerialReceiveMux::run(void *data)
+{
+    bool    eventMode = true;       // 全ポートがUART受信通知で起床できる
+    int     period = 1;             // ポーリング周期[ms]（ポートの最短周期）
+
+    data = nullptr;
+
+    // 全ポートの受信を開始する（UART受信通知先はこのタスク）
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    for (int index = 0; index < _portNum; index++) {
+        SerialReceiveBase *port = _ports[index];
+        port->beginReceive(task);
+        if (port->_mode != SerialReceiveBase::RECV_MODE_EVENT) {
+            // ポーリングのポートがある
+            eventMode = false;
+        }
+        if ((index == 0) || (port->_task_period < period)) {
+            period = port->_task_period;
+        }
+    }
+    running = true;
+    if (!eventMode) {
+        // ポーリング 受信タスク駆動周期の起点
+        _taskPeriod.Start(period);
+    }
+
+    while (1)
+    {
+        // 全ポートの受信済データを処理する
+        for (int index = 0; index < _portNum; index++) {
+            _ports[index]->recvAvailable();
+            _ports[index]->updateFlowControl();
+        }
+
+        if (eventMode) {
+            // 全ポートがイベント駆動 いずれかのポートのUART受信通知を待つ
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RECV_EVENT_WAIT_TIMEOUT));
+        }
+        else {
+            // ポーリング 受信データはこの時刻以降に到着したものとする
+            uint32_t now = micros();
+            for (int index = 0; index < _portNum; index++) {
+                if (_ports[index]->_mode != SerialReceiveBase::RECV_MODE_EVENT) {
+                    _ports[index]->rxEventTime = now;
+                }
+            }
+            _taskPeriod.Wait();
+        }
+
+        // タスク起床回数計測
+        for (int index = 0; index < _portNum; index++) {
+            _ports[index]->countWakeup();
+        }
+    }
 }
@@ -0,0 +1,256 @@
+/******************************************************************************
+ * @file       SerialTransmit.cpp
+ * @brief      シリアル送信
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    レコード毎の順序番号で空き／出力可能を判定する有界リング（複数投入・単一出力）に
+ *             書式変換済みのデータを投入し、送信タスクが順に送信ポートへ出力する
+ *             投入側は位置の確保に compare-and-swap を１回使うだけで、ミューテックスやキュー待ちを行わない
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <string.h>
+#include "SerialTransmit.h"
+
+SerialTransmitBase::SerialTransmitBase()
+{
+    _seq = NULL;                            // レコード順序番号
+    _lengths = NULL;                        // レコード長
+    _records = NULL;                        // レコード領域
+    _depth = 0;                             // 送信レコード数
+    _recordSize = 0;                        // 送信レコードサイズ
+    _port = &Serial;                        // 送信ポート
+    enqueuePos.store(0);                    // 次に投入する位置
+    dequeuePos.store(0);                    // 次に出力する位置
+    records.store(0);                       // 送信レコード投入数
+    bytes.store(0);                         // 送信バイト数
+    drops.store(0);                         // 破棄レコード数
+    highWater.store(0);                     // 送信待ちレコード最大数
+    taskHandle = NULL;                      // 送信タスクハンドル
+    running = false;                        // タスク駆動中
+}
+
+// 送信レコード領域設定
+void SerialTransmitBase::attachStorage(std::atomic<uint32_t> *seq, uint16_t *lengths, uint8_t *records, uint32_t depth, uint16_t recordSize)
+{
+    _seq = seq;                             // レコード順序番号
+    _lengths = lengths;                     // レコード長
+    _records = records;                     // レコード領域
+    _depth = depth;                         // 送信レコード数
+    _recordSize = recordSize;               // 送信レコードサイズ
+    // 位置 i のレコードは順序番号 i のとき投入可能
+    for (uint32_t index = 0; index < _depth; index++) {
+        _seq[index].store(index, std::memory_order_relaxed);
+    }
+}
+
+// 送信ポート設定
+SerialTransmitBase::RESULT SerialTransmitBase::SetPort(Print *port)
+{
+    if (port == NULL) {
+        return RESULT_ERR_ARGS;
+    }
+    if (running) {
+        // 送信開始後は変更できない
+        return RESULT_ERR_STATE;
+    }
+    _port = port;
+    return RESULT_SUCCESS;
+}
+
+// 送信開始
+SerialTransmitBase::RESULT SerialTransmitBase::Start()
+{
+    if (running || (_seq == NULL)) {
+        return RESULT_ERR_STATE;
+    }
+    running = true;
+    // タスクスタート
+    start();
+
+    return RESULT_SUCCESS;
+}
+
+// 連続レコード投入
+bool SerialTransmitBase::enqueue(const uint8_t *data, size_t size, const char *tail)
+{
+    size_t      tailSize = (tail != NULL) ? strlen(tail) : 0;     // 付加文字列長
+    size_t      total = size + tailSize;                        // 投入バイト数
+    uint32_t    count = (uint32_t)((total + _recordSize - 1) / _recordSize);    // 使用レコード数
+    uint32_t    pos;        // 確保した先頭位置
+    uint32_t    mask = _depth - 1;
+
+    if (total == 0) {
+        return true;
+    }
+    if ((_seq == NULL) || (count > _depth)) {
+        // 領域未設定、または全レコードを使っても入らない
+        drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // count 個の連続した位置を確保する
+    // 出力側は位置順に解放するので、末尾の位置が投入可能なら途中の位置もすべて投入可能
+    pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t last = pos + count - 1;
+        int32_t diff = (int32_t)(_seq[last & mask].load(std::memory_order_acquire) - last);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // 空きなし 待たずに破棄する
+            drops.fetch_add(count, std::memory_order_relaxed);
+            return false;
+        }
+        else {
+            // 他の投入側が先に確保した
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // 送信待ちレコード最大数更新
+    uint32_t queued = pos + count - dequeuePos.load(std::memory_order_relaxed);
+    uint32_t peak = highWater.load(std::memory_order_relaxed);
+    while ((queued > peak) && !highWater.compare_exchange_weak(peak, queued, std::memory_order_relaxed)) {
+    }
+
+    // レコードに分割して格納し、位置順に出力可能にする
+    size_t offset = 0;
+    for (uint32_t index = 0; index < count; index++) {
+        uint32_t slot = (pos + index) & mask;
+        uint8_t *record = _records + ((size_t)slot * _recordSize);
+        size_t length = 0;
+        while ((length < _recordSize) && (offset < total)) {
+            size_t chunk;
+            if (offset < size) {
+                chunk = size - offset;
+                if (chunk > (size_t)(_recordSize - length)) {
+                    chunk = _recordSize - length;
+                }
+                memcpy(record + length, data + offset, chunk);
+            }
+            else {
+                chunk = total - offset;
+                if (chunk > (size_t)(_recordSize - length)) {
+                    chunk = _recordSize - length;
+                }
+                memcpy(record + length, tail + (offset - size), chunk);
+            }
+            length += chunk;
+            offset += chunk;
+        }
+        _lengths[slot] = (uint16_t)length;
+        _seq[slot].store(pos + index + 1, std::memory_order_release);
+    }
+    records.fetch_add(count, std::memory_order_relaxed);
+
+    // 送信タスクに通知する
+    TaskHandle_t task = taskHandle;
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+// Print 出力（１バイト）
+size_t SerialTransmitBase::write(uint8_t data)
+{
+    return enqueue(&data, 1) ? 1 : 0;
+}
+
+// Print 出力
+size_t SerialTransmitBase::write(const uint8_t *buffer, size_t size)
+{
+    if (buffer == NULL) {
+        return 0;
+    }
+    return enqueue(buffer, size) ? size : 0;
+}
+
+// 行送信
+bool SerialTransmitBase::WriteLine(const char *line)
+{
+    if (line == NULL) {
+        return false;
+    }
+    return enqueue((const uint8_t *)line, strlen(line), "\r\n");
+}
+
+// 空きレコード数取得
+uint32_t SerialTransmitBase::FreeCount() const
+{
+    uint32_t queued = enqueuePos.load(std::memory_order_relaxed) - dequeuePos.load(std::memory_order_relaxed);
+    return (queued < _depth) ? (_depth - queued) : 0;
+}
+
+// 投入可能バイト数
+int SerialTransmitBase::availableForWrite()
+{
+    return (int)(FreeCount() * _recordSize);
+}
+
+// シリアル送信統計情報取得
+SerialTransmitBase::RESULT SerialTransmitBase::GetTxStats(TxStats *stats) const
+{
+    if (stats == NULL) {
+        return RESULT_ERR_ARGS;
+    }
+    stats->records = records.load(std::memory_order_relaxed);       // 送信レコード投入数
+    stats->bytes = bytes.load(std::memory_order_relaxed);           // 送信バイト数
+    stats->drops = drops.load(std::memory_order_relaxed);           // 破棄レコード数
+    stats->queued = _depth - FreeCount();                           // 送信待ちレコード数
+    stats->highWater = highWater.load(std::memory_order_relaxed);   // 送信待ちレコード最大数
+    stats->depth = _depth;                                          // 送信レコード数
+    stats->recordSize = _recordSize;                                // 送信レコードサイズ
+    return RESULT_SUCCESS;
+}
+
+// シリアル送信統計情報表示
+void SerialTransmitBase::DispTxStats()
+{
+    TxStats     stats;      // シリアル送信統計情報
+
+    GetTxStats(&stats);
+    printf("TXSTAT, records=%u, bytes=%u, drops=%u, queue=%u/%u, max=%u, record=%ubyte\n",
+        stats.records, stats.bytes, stats.drops, stats.queued, stats.depth, stats.highWater, stats.recordSize);
+}
+
+// 送信タスク関数
+void SerialTransmitBase::run(void *data)
+{
+    uint32_t    mask = _depth - 1;
+
+    data = nullptr;
+
+    // 投入通知先をこのタスクに設定する
+    taskHandle = xTaskGetCurrentTaskHandle();
+
+    while (1)
+    {
+        // 出力可能なレコードを位置順にすべて出力する
+        uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t slot = pos & mask;
+            if (_seq[slot].load(std::memory_order_acquire) != (pos + 1)) {
+                // 出力可能なレコードなし（未投入、または投入側が格納中）
+                break;
+            }
+            // 送信ポートへ出力する（送信FIFOが一杯なら、このタスクだけが待つ）
+            uint16_t length = _lengths[slot];
+            _port->write(_records + ((size_t)slot * _recordSize), length);
+            bytes.fetch_add(length, std::memory_order_relaxed);
+            // レコードを解放する（１周後の位置で投入可能）
+            _seq[slot].store(pos + _depth, std::memory_order_release);
+            pos++;
+            dequeuePos.store(pos, std::memory_order_relaxed);
+        }
+
+        // 投入通知待ち（起動前に投入されたレコードがあれば通知なしで出力済）
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * @file       SerialTransmit.h
+ * @brief      シリアル送信 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    複数タスクから書式変換済みのレコードをロックなしで投入し、１つの送信タスクがシリアルポートへ出力するクラス定義
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _SERIAL_TRANSMIT_H_
+#define _SERIAL_TRANSMIT_H_
+
+#include <atomic>
+#include <M5Atom.h>
+
+#define SERIAL_TRANSMIT_RECORD_SIZE         128         // 送信レコードサイズ[byte]（既定値）
+#define SERIAL_TRANSMIT_QUEUE_NUM           32          // 送信レコード数（既定値、2のべき乗）
+
+// シリアル送信 共通部（送信レコードの領域は派生クラス SerialTransmit<RecordSize, Depth> が持つ）
+// Print として使用でき、print / printf / write の１回の呼び出しを連続したレコードとして投入する
+// 投入側は待たない（空きがなければ破棄して破棄数を数える）。割り込みハンドラからは呼ばないこと
+class SerialTransmitBase : public Task, public Print
+{
+public:
+
+    enum RESULT {                           // シリアル送信結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_ERR_ARGS,                    // 引数エラー
+        RESULT_ERR_STATE,                   // 状態エラー
+        RESULT_NUM                          // シリアル送信結果数
+    };
+
+    struct TxStats {                        // シリアル送信統計情報
+        uint32_t    records;                // 送信レコード投入数
+        uint32_t    bytes;                  // 送信バイト数（送信タスクが出力した数）
+        uint32_t    drops;                  // 空きなしによる破棄レコード数
+        uint32_t    queued;                 // 送信待ちレコード数
+        uint32_t    highWater;              // 送信待ちレコード最大数
+        uint32_t    depth;                  // 送信レコード数
+        uint32_t    recordSize;             // 送信レコードサイズ[byte]
+    };
+
+    // 送信ポート設定（既定は Serial、Start 前に呼ぶこと）
+    RESULT SetPort(Print *port);
+    // 送信開始（送信タスク起動、起動前に投入したレコードも出力する）
+    RESULT Start();
+    // 行送信（line + "\r\n" を連続したレコードとして投入する）
+    bool WriteLine(const char *line);
+    // 空きレコード数取得
+    uint32_t FreeCount() const;
+    // シリアル送信統計情報取得
+    RESULT GetTxStats(TxStats *stats) const;
+    // シリアル送信統計情報表示
+    void DispTxStats();
+
+    // Print 出力（１回の呼び出しを連続したレコードとして投入し、投入できなければ 0 を返す）
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    // 投入可能バイト数
+    int availableForWrite() override;
+
+protected:
+    // コンストラクタ（派生クラスから呼ぶ）
+    SerialTransmitBase();
+    // 送信レコード領域設定（派生クラスのコンストラクタから呼ぶ、depth は 2のべき乗）
+    void attachStorage(std::atomic<uint32_t> *seq, uint16_t *lengths, uint8_t *records, uint32_t depth, uint16_t recordSize);
+
+private:
+    std::atomic<uint32_t>       *_seq;          // レコード順序番号（投入可能な位置 / 出力可能な位置 + 1 を示す）
+    uint16_t                    *_lengths;      // レコード長
+    uint8_t                     *_records;      // レコード領域
+    uint32_t                    _depth;         // 送信レコード数
+    uint16_t                    _recordSize;    // 送信レコードサイズ
+    Print                       *_port;         // 送信ポート
+    std::atomic<uint32_t>       enqueuePos;     // 次に投入する位置
+    std::atomic<uint32_t>       dequeuePos;     // 次に出力する位置
+    std::atomic<uint32_t>       records;        // 送信レコード投入数
+    std::atomic<uint32_t>       bytes;          // 送信バイト数
+    std::atomic<uint32_t>       drops;          // 破棄レコード数
+    std::atomic<uint32_t>       highWater;      // 送信待ちレコード最大数
+    TaskHandle_t volatile       taskHandle;     // 送信タスクハンドル（投入通知先）
+    bool                        running;        // タスク駆動中
+
+    // 連続レコード投入（data と tail を連結し、レコードサイズ毎に分割して連続した位置に投入する）
+    bool enqueue(const uint8_t *data, size_t size, const char *tail = NULL);
+    // 送信タスク関数
+    void run(void *data);
+};
+
+// シリアル送信（RecordSize : 送信レコードサイズ[byte]、Depth : 送信レコード数（2のべき乗））
+// 送信レコードの領域をインスタンス内に静的に確保する
+template <size_t RecordSize = SERIAL_TRANSMIT_RECORD_SIZE, size_t Depth = SERIAL_TRANSMIT_QUEUE_NUM>
+class SerialTransmit : public SerialTransmitBase
+{
+public:
+    static_assert((RecordSize >= 1) && (RecordSize <= 0xFFFF), "SerialTransmit RecordSize is out of range");
+    static_assert((Depth >= 2) && ((Depth & (Depth - 1)) == 0), "SerialTransmit Depth must be a power of two");
+
+    // 領域のバイト数（コンパイル時に確定、static_assert で RAM 予算を検査できる）
+    static constexpr size_t StorageSize()
+    {
+        return Depth * (sizeof (std::atomic<uint32_t>) + sizeof (uint16_t) + RecordSize);
+    }
+
+    // コンストラクタ
+    SerialTransmit() : SerialTransmitBase()
+    {
+        attachStorage(seqStorage, lengthStorage, recordStorage, Depth, RecordSize);
+    }
+
+private:
+    std::atomic<uint32_t>       seqStorage[Depth];              // レコード順序番号領域
+    uint16_t                    lengthStorage[Depth];           // レコード長領域
+    uint8_t                     recordStorage[Depth * RecordSize];  // レコード領域
+};
+#endif /* _SERIAL_TRANSMIT_H_ */
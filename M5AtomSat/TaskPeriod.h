@@ -0,0 +1,75 @@
+/******************************************************************************
+ * @file       TaskPeriod.h
+ * @brief      タスク周期実行 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    タスクのループを固定位相で周期実行するクラス定義
+ *             delay(周期) は処理の終了から周期だけ待つため、実際の周期は 周期＋処理時間 となり、起床時刻がずれていく
+ *             TaskPeriod は vTaskDelayUntil で前回の起床予定時刻から周期後まで待ち、起床予定時刻を Start の時刻に固定する
+ *             処理が周期を超えた（周期超過）場合は、過ぎた起床予定時刻を飛ばして次の起床予定時刻まで待つ（位相を保つ）
+ *             起床毎に実際の起床間隔と起床予定時刻の間隔との差（周期ジッタ）を計測し、分布・実測周波数とともに取得できる
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 処理がちょうど次の起床予定時刻に終わった場合を周期超過としない
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TASK_PERIOD_H_
+#define _TASK_PERIOD_H_
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define TASK_PERIOD_HIST_NUM        16          // 周期ジッタ分布の区間数（区間k : 2^k〜2^(k+1)-1[us]、区間0 は 0〜1[us]）
+#define TASK_PERIOD_RATE_WINDOW     1000000     // 実測周波数の計測周期[us]
+
+// 周期実行（１つのタスクのタスク関数だけが Start・Wait を呼ぶこと。統計情報は他のタスクから取得できる）
+class TaskPeriod
+{
+public:
+
+    struct Stats {                          // 周期実行統計情報
+        uint32_t    period;                 // 周期[ms]（0 は周期実行していない）
+        uint32_t    cycles;                 // 起床回数
+        uint32_t    overruns;               // 周期超過回数
+        uint32_t    skipped;                // 周期超過で飛ばした起床予定時刻の数
+        uint32_t    rate;                   // 実測周波数[mHz]（直近の計測周期）
+        uint32_t    jitterAvg;              // 周期ジッタ 平均[us]
+        uint32_t    jitterMax;              // 周期ジッタ 最大[us]
+        uint32_t    jitterHist[TASK_PERIOD_HIST_NUM];   // 周期ジッタ分布（log2 区間）
+    };
+
+    // コンストラクタ
+    TaskPeriod();
+
+    // 周期実行開始（タスク関数から呼び、現在時刻を起床予定時刻の起点とする。統計情報はクリアする）
+    void Start(uint32_t periodMs);
+    // 周期変更（Start した位相の前回の起床予定時刻から新しい周期で待つ。統計情報は引き継ぐ）
+    void SetPeriod(uint32_t periodMs);
+    // 周期待ち（次の起床予定時刻まで待ち、前回の起床予定時刻から進んだ周期数を返す。周期超過がなければ 1）
+    uint32_t Wait();
+    // 周期[ms]取得
+    uint32_t Period() const { return _period; }
+    // 統計情報取得
+    void GetStats(Stats *stats) const;
+    // 統計情報クリア
+    void ClearStats();
+    // 統計情報表示（TASKSTAT 行・TASKHIST 行をそれぞれ１回の print で出力する）
+    static void DispStats(Print *out, const char *name, const Stats &stats);
+
+private:
+    uint32_t                _period;        // 周期[ms]
+    TickType_t              _periodTicks;   // 周期[tick]
+    TickType_t              _lastWake;      // 前回の起床予定時刻[tick]
+    uint32_t                _lastWakeTime;  // 前回の起床時刻[us]
+    uint32_t                _rateStartTime; // 実測周波数の計測開始時刻[us]
+    uint32_t                _rateCycles;    // 実測周波数の計測開始時の起床回数
+    uint64_t                _jitterSum;     // 周期ジッタ 合計[us]
+    Stats                   _stats;         // 統計情報
+
+    // 起床毎の計測（periods : 前回の起床予定時刻から進んだ周期数）
+    void measure(uint32_t periods);
+};
+
+#endif /* _TASK_PERIOD_H_ */
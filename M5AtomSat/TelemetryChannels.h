@@ -0,0 +1,262 @@
+/******************************************************************************
+ * @file       TelemetryChannels.h
+ * @brief      テレメトリチャネル定義表 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリ項目（番号・名前・型・倍率・取得関数）をコンパイル時の定義表で宣言する
+ *             文字列生成・フレーム生成・差分圧縮・項目一覧の出力、および各形式の最大サイズはこの表から生成する
+ *             項目の追加は、格納先（TelemetrySample または TelemetryCounters）のメンバ、取得・設定関数、
+ *             定義表の行を追加し、収集処理（getTelemetrySample など）で値を設定する
+ *             定義表は添字をテンプレート引数とする展開（TelemetryFieldLoop）で参照し、
+ *             フレーム毎の処理は表を実行時に検索しない直線的なコピーになる
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 姿勢区間統計チャネル（Pitch, Roll の最小・最大・平均・分散）追加
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TELEMETRY_CHANNELS_H_
+#define _TELEMETRY_CHANNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum TLM_CHANNEL {                          // テレメトリチャネル
+    TLM_CHANNEL_TIME = 0,                   // 起動からの経過時間
+    TLM_CHANNEL_ATTITUDE,                   // 姿勢情報（Pitch, Roll, Yaw）
+    TLM_CHANNEL_TEMP,                       // 内部温度
+    TLM_CHANNEL_COUNTERS,                   // カウンタ（コマンド実行数、送信破棄数）
+    TLM_CHANNEL_ATT_STATS,                  // 姿勢区間統計（前回出力からの Pitch, Roll の最小・最大・平均・分散）
+    TLM_CHANNEL_NUM,                        // テレメトリチャネル数
+    TLM_CHANNEL_HEADER = 7                  // 全フレームに格納する項目（テレメトリ番号、チャネルマスクには含めない）
+};
+
+#define TLM_CHANNEL_BIT(ch)     (1U << (ch))    // チャネルマスクのビット
+// 全チャネル
+#define TLM_CHANNEL_MASK_ALL    (TLM_CHANNEL_BIT(TLM_CHANNEL_NUM) - 1)
+// 従来形式（TLM 行・0xEB90 フレーム）で出力するチャネルの組
+#define TLM_CHANNEL_MASK_FULL   (TLM_CHANNEL_BIT(TLM_CHANNEL_TIME) | TLM_CHANNEL_BIT(TLM_CHANNEL_ATTITUDE) | TLM_CHANNEL_BIT(TLM_CHANNEL_TEMP))
+
+struct TelemetryCounters {                  // テレメトリカウンタ・姿勢区間統計（記録しない）
+    uint32_t                commands;       // コマンド実行数
+    uint32_t                txDrops;        // 送信破棄数
+    uint32_t                attSamples;     // 姿勢区間統計 サンプル数
+    int16_t                 pitchMin;       // 姿勢区間統計 ピッチ最小[0.01度]
+    int16_t                 pitchMax;       // 姿勢区間統計 ピッチ最大[0.01度]
+    int16_t                 pitchMean;      // 姿勢区間統計 ピッチ平均[0.01度]
+    int32_t                 pitchVar;       // 姿勢区間統計 ピッチ分散[0.01度^2]
+    int16_t                 rollMin;        // 姿勢区間統計 ロール最小[0.01度]
+    int16_t                 rollMax;        // 姿勢区間統計 ロール最大[0.01度]
+    int16_t                 rollMean;       // 姿勢区間統計 ロール平均[0.01度]
+    int32_t                 rollVar;        // 姿勢区間統計 ロール分散[0.01度^2]
+};
+
+struct TelemetrySample {                    // テレメトリサンプル（固定小数点）
+    uint32_t                counter;        // テレメトリ番号
+    uint32_t                missionTime;    // 起動からの経過時間[秒]
+    int16_t                 pitch;          // 姿勢 ピッチ[0.01度]
+    int16_t                 roll;           // 姿勢 ロール[0.01度]
+    int16_t                 yaw;            // 姿勢 ヨー[0.01度]
+    int16_t                 temp;           // 内部温度[0.01℃]
+};
+
+enum TLM_FIELD {                            // テレメトリ項目（定義表の順序）
+    TLM_FIELD_COUNTER = 0,                  // テレメトリ番号
+    TLM_FIELD_MISSION_TIME,                 // 起動からの経過時間
+    TLM_FIELD_PITCH,                        // 姿勢 ピッチ
+    TLM_FIELD_ROLL,                         // 姿勢 ロール
+    TLM_FIELD_YAW,                          // 姿勢 ヨー
+    TLM_FIELD_TEMP,                         // 内部温度
+    TLM_FIELD_COMMANDS,                     // コマンド実行数
+    TLM_FIELD_TX_DROPS,                     // 送信破棄数
+    TLM_FIELD_ATT_SAMPLES,                  // 姿勢区間統計 サンプル数
+    TLM_FIELD_PITCH_MIN,                    // 姿勢区間統計 ピッチ最小
+    TLM_FIELD_PITCH_MAX,                    // 姿勢区間統計 ピッチ最大
+    TLM_FIELD_PITCH_MEAN,                   // 姿勢区間統計 ピッチ平均
+    TLM_FIELD_PITCH_VAR,                    // 姿勢区間統計 ピッチ分散
+    TLM_FIELD_ROLL_MIN,                     // 姿勢区間統計 ロール最小
+    TLM_FIELD_ROLL_MAX,                     // 姿勢区間統計 ロール最大
+    TLM_FIELD_ROLL_MEAN,                    // 姿勢区間統計 ロール平均
+    TLM_FIELD_ROLL_VAR,                     // 姿勢区間統計 ロール分散
+    TLM_FIELD_NUM                           // テレメトリ項目数
+};
+
+enum TLM_TYPE {                             // テレメトリ項目の型
+    TLM_TYPE_INT32 = 0,                     // 符号付き 32 ビット整数（フレームでは 4 バイト）
+    TLM_TYPE_UINT32,                        // 符号なし 32 ビット整数（フレームでは 4 バイト）
+    TLM_TYPE_TIME,                          // 経過時間[秒]（フレームでは 4 バイト、文字列は 時:分:秒）
+    TLM_TYPE_CENTI16,                       // 0.01 単位の符号付き 16 ビット整数（フレームでは 2 バイト、文字列は %6.2f 相当）
+    TLM_TYPE_CENTI32,                       // 0.01 単位の符号付き 32 ビット整数（フレームでは 4 バイト、文字列は %6.2f 相当）
+    TLM_TYPE_NUM                            // テレメトリ項目の型数
+};
+
+struct TelemetryFieldDef {                  // テレメトリ項目定義
+    TLM_FIELD               id;             // 項目番号（定義表の添字と同じ）
+    const char              *name;          // 項目名
+    const char              *label;         // チャネル別文字列の項目名（NULL は項目名なし）
+    TLM_CHANNEL             channel;        // チャネル
+    TLM_TYPE                type;           // 型
+    float                   scale;          // 1LSB の大きさ（単位 unit）
+    const char              *unit;          // 単位
+    // 値の取得（フレームの値は 32 ビットで扱い、16 ビットの項目は符号拡張する）
+    uint32_t                (*get)(const TelemetrySample &sample, const TelemetryCounters &counters);
+    // 値の設定（復号側で使う）
+    void                    (*set)(TelemetrySample &sample, TelemetryCounters &counters, uint32_t value);
+};
+
+// 項目の取得・設定関数
+static inline uint32_t telemetryGetCounter(const TelemetrySample &s, const TelemetryCounters &) { return s.counter; }
+static inline uint32_t telemetryGetMissionTime(const TelemetrySample &s, const TelemetryCounters &) { return s.missionTime; }
+static inline uint32_t telemetryGetPitch(const TelemetrySample &s, const TelemetryCounters &) { return (uint32_t)(int32_t)s.pitch; }
+static inline uint32_t telemetryGetRoll(const TelemetrySample &s, const TelemetryCounters &) { return (uint32_t)(int32_t)s.roll; }
+static inline uint32_t telemetryGetYaw(const TelemetrySample &s, const TelemetryCounters &) { return (uint32_t)(int32_t)s.yaw; }
+static inline uint32_t telemetryGetTemp(const TelemetrySample &s, const TelemetryCounters &) { return (uint32_t)(int32_t)s.temp; }
+static inline uint32_t telemetryGetCommands(const TelemetrySample &, const TelemetryCounters &c) { return c.commands; }
+static inline uint32_t telemetryGetTxDrops(const TelemetrySample &, const TelemetryCounters &c) { return c.txDrops; }
+static inline uint32_t telemetryGetAttSamples(const TelemetrySample &, const TelemetryCounters &c) { return c.attSamples; }
+static inline uint32_t telemetryGetPitchMin(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)(int32_t)c.pitchMin; }
+static inline uint32_t telemetryGetPitchMax(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)(int32_t)c.pitchMax; }
+static inline uint32_t telemetryGetPitchMean(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)(int32_t)c.pitchMean; }
+static inline uint32_t telemetryGetPitchVar(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)c.pitchVar; }
+static inline uint32_t telemetryGetRollMin(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)(int32_t)c.rollMin; }
+static inline uint32_t telemetryGetRollMax(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)(int32_t)c.rollMax; }
+static inline uint32_t telemetryGetRollMean(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)(int32_t)c.rollMean; }
+static inline uint32_t telemetryGetRollVar(const TelemetrySample &, const TelemetryCounters &c) { return (uint32_t)c.rollVar; }
+static inline void telemetrySetCounter(TelemetrySample &s, TelemetryCounters &, uint32_t v) { s.counter = v; }
+static inline void telemetrySetMissionTime(TelemetrySample &s, TelemetryCounters &, uint32_t v) { s.missionTime = v; }
+static inline void telemetrySetPitch(TelemetrySample &s, TelemetryCounters &, uint32_t v) { s.pitch = (int16_t)v; }
+static inline void telemetrySetRoll(TelemetrySample &s, TelemetryCounters &, uint32_t v) { s.roll = (int16_t)v; }
+static inline void telemetrySetYaw(TelemetrySample &s, TelemetryCounters &, uint32_t v) { s.yaw = (int16_t)v; }
+static inline void telemetrySetTemp(TelemetrySample &s, TelemetryCounters &, uint32_t v) { s.temp = (int16_t)v; }
+static inline void telemetrySetCommands(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.commands = v; }
+static inline void telemetrySetTxDrops(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.txDrops = v; }
+static inline void telemetrySetAttSamples(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.attSamples = v; }
+static inline void telemetrySetPitchMin(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.pitchMin = (int16_t)v; }
+static inline void telemetrySetPitchMax(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.pitchMax = (int16_t)v; }
+static inline void telemetrySetPitchMean(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.pitchMean = (int16_t)v; }
+static inline void telemetrySetPitchVar(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.pitchVar = (int32_t)v; }
+static inline void telemetrySetRollMin(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.rollMin = (int16_t)v; }
+static inline void telemetrySetRollMax(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.rollMax = (int16_t)v; }
+static inline void telemetrySetRollMean(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.rollMean = (int16_t)v; }
+static inline void telemetrySetRollVar(TelemetrySample &, TelemetryCounters &c, uint32_t v) { c.rollVar = (int32_t)v; }
+
+// テレメトリ項目定義表（全フレームに格納する項目を先頭に、以降はチャネル番号順に並べること。チャネル内はこの順に格納する）
+constexpr TelemetryFieldDef TelemetryFields[TLM_FIELD_NUM] = {
+    //  項目番号                名前            項目名  チャネル                型                  倍率    単位    取得関数                    設定関数
+    {   TLM_FIELD_COUNTER,      "counter",      NULL,   TLM_CHANNEL_HEADER,     TLM_TYPE_INT32,     1.0f,   "",     telemetryGetCounter,        telemetrySetCounter     },
+    {   TLM_FIELD_MISSION_TIME, "time",         "T",    TLM_CHANNEL_TIME,       TLM_TYPE_TIME,      1.0f,   "s",    telemetryGetMissionTime,    telemetrySetMissionTime },
+    {   TLM_FIELD_PITCH,        "pitch",        "P",    TLM_CHANNEL_ATTITUDE,   TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetPitch,          telemetrySetPitch       },
+    {   TLM_FIELD_ROLL,         "roll",         "R",    TLM_CHANNEL_ATTITUDE,   TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetRoll,           telemetrySetRoll        },
+    {   TLM_FIELD_YAW,          "yaw",          "Y",    TLM_CHANNEL_ATTITUDE,   TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetYaw,            telemetrySetYaw         },
+    {   TLM_FIELD_TEMP,         "temp",         "C",    TLM_CHANNEL_TEMP,       TLM_TYPE_CENTI16,   0.01f,  "degC", telemetryGetTemp,           telemetrySetTemp        },
+    {   TLM_FIELD_COMMANDS,     "commands",     "CMD",  TLM_CHANNEL_COUNTERS,   TLM_TYPE_UINT32,    1.0f,   "",     telemetryGetCommands,       telemetrySetCommands    },
+    {   TLM_FIELD_TX_DROPS,     "tx_drops",     "TXD",  TLM_CHANNEL_COUNTERS,   TLM_TYPE_UINT32,    1.0f,   "",     telemetryGetTxDrops,        telemetrySetTxDrops     },
+    {   TLM_FIELD_ATT_SAMPLES,  "att_samples",  "N",    TLM_CHANNEL_ATT_STATS,  TLM_TYPE_UINT32,    1.0f,   "",     telemetryGetAttSamples,     telemetrySetAttSamples  },
+    {   TLM_FIELD_PITCH_MIN,    "pitch_min",    "PMIN", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetPitchMin,       telemetrySetPitchMin    },
+    {   TLM_FIELD_PITCH_MAX,    "pitch_max",    "PMAX", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetPitchMax,       telemetrySetPitchMax    },
+    {   TLM_FIELD_PITCH_MEAN,   "pitch_mean",   "PAVG", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetPitchMean,      telemetrySetPitchMean   },
+    {   TLM_FIELD_PITCH_VAR,    "pitch_var",    "PVAR", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI32,   0.01f,  "deg2", telemetryGetPitchVar,       telemetrySetPitchVar    },
+    {   TLM_FIELD_ROLL_MIN,     "roll_min",     "RMIN", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetRollMin,        telemetrySetRollMin     },
+    {   TLM_FIELD_ROLL_MAX,     "roll_max",     "RMAX", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetRollMax,        telemetrySetRollMax     },
+    {   TLM_FIELD_ROLL_MEAN,    "roll_mean",    "RAVG", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI16,   0.01f,  "deg",  telemetryGetRollMean,       telemetrySetRollMean    },
+    {   TLM_FIELD_ROLL_VAR,     "roll_var",     "RVAR", TLM_CHANNEL_ATT_STATS,  TLM_TYPE_CENTI32,   0.01f,  "deg2", telemetryGetRollVar,        telemetrySetRollVar     },
+};
+
+// チャネル名（TLM_CHANNEL の順、コマンドの列挙名表として使うため NULL 終端）
+constexpr const char *TelemetryChannelNames[TLM_CHANNEL_NUM + 1] = { "time", "attitude", "temp", "counters", "attstats", NULL };
+// 型名（TLM_TYPE の順）
+constexpr const char *TelemetryTypeNames[TLM_TYPE_NUM] = { "i32", "u32", "time", "i16", "i32" };
+
+// 型のフレーム格納サイズ[byte]
+constexpr uint32_t TelemetryTypeBytes(TLM_TYPE type)
+{
+    return (type == TLM_TYPE_CENTI16) ? 2 : 4;
+}
+
+// 型の文字列の最大長[byte]
+constexpr uint32_t TelemetryTypeTextWidth(TLM_TYPE type)
+{
+    return (type == TLM_TYPE_INT32) ? 11 :          // "-2147483648"
+           (type == TLM_TYPE_UINT32) ? 10 :         // "4294967295"
+           (type == TLM_TYPE_TIME) ? 13 :           // "1193046:28:15"
+           (type == TLM_TYPE_CENTI32) ? 12 :        // "-21474836.48"
+           7;                                       // "-327.68"
+}
+
+// 型の差分（zigzag 変換した可変長整数）の最大サイズ[byte]
+constexpr uint32_t TelemetryTypeDeltaBytes(TLM_TYPE type)
+{
+    // 16 ビットの差は 17 ビット、32 ビットの差は 32 ビットで、７ビットずつ格納する
+    return (TelemetryTypeBytes(type) == 2) ? 3 : 5;
+}
+
+// 項目が出力対象か（mask はチャネルマスク、全フレームに格納する項目は TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) で指定する）
+constexpr bool TelemetryFieldSelected(size_t field, uint32_t mask)
+{
+    return (mask & TLM_CHANNEL_BIT(TelemetryFields[field].channel)) != 0;
+}
+
+// 文字列の長さ
+constexpr uint32_t TelemetryStrLen(const char *str)
+{
+    return (*str == '\0') ? 0 : (1 + TelemetryStrLen(str + 1));
+}
+
+// 項目のフレーム格納サイズの合計[byte]
+constexpr uint32_t TelemetryFieldsFrameBytes(uint32_t mask, size_t field = 0)
+{
+    return (field >= TLM_FIELD_NUM) ? 0 :
+        (TelemetryFieldSelected(field, mask) ? TelemetryTypeBytes(TelemetryFields[field].type) : 0) + TelemetryFieldsFrameBytes(mask, field + 1);
+}
+
+// 項目の文字列の最大長の合計[byte]（各項目の前に ", "、labels が true なら "項目名=" を付ける）
+constexpr uint32_t TelemetryFieldsTextBytes(uint32_t mask, bool labels, size_t field = 0)
+{
+    return (field >= TLM_FIELD_NUM) ? 0 :
+        (TelemetryFieldSelected(field, mask) ?
+            (2 + ((labels && (TelemetryFields[field].label != NULL)) ? (TelemetryStrLen(TelemetryFields[field].label) + 1) : 0)
+               + TelemetryTypeTextWidth(TelemetryFields[field].type)) : 0)
+        + TelemetryFieldsTextBytes(mask, labels, field + 1);
+}
+
+// 項目の差分の最大サイズの合計[byte]
+constexpr uint32_t TelemetryFieldsDeltaBytes(uint32_t mask, size_t field = 0)
+{
+    return (field >= TLM_FIELD_NUM) ? 0 :
+        (TelemetryFieldSelected(field, mask) ? TelemetryTypeDeltaBytes(TelemetryFields[field].type) : 0) + TelemetryFieldsDeltaBytes(mask, field + 1);
+}
+
+// 項目の格納順（全フレームに格納する項目が先頭、以降はチャネル番号順）
+constexpr int TelemetryFieldOrder(size_t field)
+{
+    return (TelemetryFields[field].channel == TLM_CHANNEL_HEADER) ? -1 : (int)TelemetryFields[field].channel;
+}
+
+// 定義表の並びの検査（項目番号が添字と同じ、かつ格納順に並んでいる）
+constexpr bool TelemetryFieldsOrdered(size_t field = 0)
+{
+    return (field >= TLM_FIELD_NUM) ? true :
+        ((TelemetryFields[field].id == (TLM_FIELD)field)
+         && ((field == 0) || (TelemetryFieldOrder(field - 1) <= TelemetryFieldOrder(field)))
+         && TelemetryFieldsOrdered(field + 1));
+}
+static_assert(TelemetryFieldsOrdered(), "TelemetryFields must start with header fields and be sorted by channel");
+
+// 定義表の展開（Visitor::Visit<項目番号>() を項目番号順に呼び出す。添字が定数になるので表の参照はコンパイル時に解決される）
+template <size_t Field = 0, size_t End = TLM_FIELD_NUM>
+struct TelemetryFieldLoop {
+    template <typename Visitor>
+    static inline void Run(Visitor &visitor)
+    {
+        visitor.template Visit<Field>();
+        TelemetryFieldLoop<Field + 1, End>::Run(visitor);
+    }
+};
+
+template <size_t End>
+struct TelemetryFieldLoop<End, End> {
+    template <typename Visitor>
+    static inline void Run(Visitor &) {}
+};
+
+#endif /* _TELEMETRY_CHANNELS_H_ */
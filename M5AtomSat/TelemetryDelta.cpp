@@ -0,0 +1,402 @@
+/******************************************************************************
+ * @file       TelemetryDelta.cpp
+ * @brief      差分圧縮テレメトリフレーム
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    直前のフレームとの差分を zigzag 変換した可変長整数で格納し、変化の小さい値を１バイトで送る
+ *             一定フレーム毎のキーフレームで復号側が途中から受信しても同期できるようにする
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 格納する項目をテレメトリチャネル定義表(TelemetryChannels.h)から生成
+ * @date       2026/10/16 v1.03 復号状態を使わないフレーム検査（Measure）追加
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <string.h>
+#include "TelemetryDelta.h"
+#include "Crc16.h"
+
+#define VARINT_SIZE_MAX     5               // 可変長整数の最大サイズ[byte]（32ビット）
+
+// 差分フレームのチャネルデータの最大サイズ[byte]（定義表から生成）
+const uint8_t   TelemetryDeltaChannelBytes[TLM_CHANNEL_NUM] = {
+    TelemetryFieldsDeltaBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_TIME)),
+    TelemetryFieldsDeltaBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_ATTITUDE)),
+    TelemetryFieldsDeltaBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_TEMP)),
+    TelemetryFieldsDeltaBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_COUNTERS)),
+    TelemetryFieldsDeltaBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_ATT_STATS)),
+};
+
+// zigzag 変換（絶対値の小さい負数を小さい正数にする 0,-1,1,-2,… → 0,1,2,3,…）
+static inline uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// 可変長整数格納
+static inline uint8_t *putVarint(uint8_t *dst, uint32_t value)
+{
+    while (value >= 0x80) {
+        *dst++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *dst++ = (uint8_t)value;
+    return dst;
+}
+
+// 差分格納
+static inline uint8_t *putDelta(uint8_t *dst, int32_t delta)
+{
+    return putVarint(dst, zigzag(delta));
+}
+
+// ビッグエンディアン格納・取得
+static inline uint8_t *putU16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)(value >> 8);
+    dst[1] = (uint8_t)value;
+    return dst + 2;
+}
+
+static inline uint8_t *putU32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value >> 24);
+    dst[1] = (uint8_t)(value >> 16);
+    dst[2] = (uint8_t)(value >> 8);
+    dst[3] = (uint8_t)value;
+    return dst + 4;
+}
+
+static inline uint16_t getU16(const uint8_t *src)
+{
+    return (uint16_t)((src[0] << 8) | src[1]);
+}
+
+static inline uint32_t getU32(const uint8_t *src)
+{
+    return ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+}
+
+// チャネル別フレーム（圧縮しない場合）のサイズ
+static size_t rawFrameSize(uint8_t mask)
+{
+    size_t  size = TLM_CH_FRAME_OVERHEAD;
+
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if (mask & TLM_CHANNEL_BIT(ch)) {
+            size += TelemetryChannelFrameBytes[ch];
+        }
+    }
+    return size;
+}
+
+// 項目の値の格納（キーフレーム、全項目を差分なしで格納する）
+struct KeyPacker {
+    uint8_t                     *pos;       // 格納位置
+    uint32_t                    *values;    // 格納した値（項目番号順）
+    const TelemetrySample       &sample;    // テレメトリサンプル
+    const TelemetryCounters     &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        uint32_t value = TelemetryFields[Field].get(sample, counters);
+        if (TelemetryTypeBytes(TelemetryFields[Field].type) == 2) {
+            pos = putU16(pos, (uint16_t)value);
+        }
+        else {
+            pos = putU32(pos, value);
+        }
+        values[Field] = value;
+    }
+};
+
+// 項目の差分の格納（差分フレーム、mask で選択した項目を直前に格納した値との差分で格納する）
+struct DeltaPacker {
+    uint8_t                     *pos;       // 格納位置
+    uint32_t                    mask;       // 格納するチャネル
+    uint32_t                    *values;    // 直前に格納した値（項目番号順）
+    const TelemetrySample       &sample;    // テレメトリサンプル
+    const TelemetryCounters     &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        if (TelemetryFieldSelected(Field, mask)) {
+            // 16 ビットの項目は符号拡張しているので、32 ビットの差がそのまま値の差になる
+            uint32_t value = TelemetryFields[Field].get(sample, counters);
+            pos = putDelta(pos, (int32_t)(value - values[Field]));
+            values[Field] = value;
+        }
+    }
+};
+
+/******************************************************************************
+ * 符号化
+ ******************************************************************************/
+
+// コンストラクタ
+TelemetryDeltaEncoder::TelemetryDeltaEncoder(uint32_t keyInterval)
+{
+    _keyInterval = (keyInterval > 0) ? keyInterval : 1;     // キーフレーム間隔
+    _sinceKey = _keyInterval;               // 最初のフレームはキーフレーム
+    _seq = 0;                               // フレーム順序番号
+    memset(_last, 0, sizeof (_last));
+    ClearStats();
+}
+
+// 符号化統計情報クリア
+void TelemetryDeltaEncoder::ClearStats()
+{
+    memset(&_stats, 0, sizeof (_stats));
+}
+
+// 符号化
+size_t TelemetryDeltaEncoder::Encode(const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask,
+                                     uint8_t *dst, size_t dstSize)
+{
+    uint8_t     *pos = dst;                 // 格納位置
+    size_t      size;                       // フレームサイズ
+
+    if ((dst == NULL) || (dstSize < TLM_DELTA_SIZE_MAX)) {
+        // 格納先サイズ不足
+        return 0;
+    }
+    mask &= (uint8_t)TLM_CHANNEL_MASK_ALL;
+
+    pos = putU16(pos, TLM_DELTA_SYNC);
+    if (_sinceKey >= _keyInterval) {
+        // キーフレーム 全チャネルを差分なしで格納する
+        *pos++ = (uint8_t)(TLM_DELTA_KEY_FLAG | mask);
+        *pos++ = _seq;
+        KeyPacker packer = { pos, _last, sample, counters };
+        TelemetryFieldLoop<>::Run(packer);
+        pos = packer.pos;
+        _sinceKey = 0;
+        _stats.keyframes++;
+    }
+    else {
+        // 差分フレーム 出力するチャネルだけを直前に格納した値との差分で格納する
+        *pos++ = mask;
+        *pos++ = _seq;
+        DeltaPacker packer = { pos, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | mask, _last, sample, counters };
+        TelemetryFieldLoop<>::Run(packer);
+        pos = packer.pos;
+    }
+    size = (size_t)(pos - dst);
+    putU16(pos, Crc16Calc(dst, size));
+    size += 2;
+
+    _seq++;
+    _sinceKey++;
+    _stats.frames++;
+    _stats.rawBytes += rawFrameSize(mask);
+    _stats.encodedBytes += size;
+    return size;
+}
+
+/******************************************************************************
+ * 復号
+ ******************************************************************************/
+
+// 可変長整数取得（取得できれば 1、途中までなら 0、VARINT_SIZE_MAX バイトを超えて続く場合は -1）
+static int getVarint(const uint8_t **pos, const uint8_t *end, uint32_t *value)
+{
+    const uint8_t   *src = *pos;
+    uint32_t        result = 0;
+
+    for (int index = 0; index < VARINT_SIZE_MAX; index++) {
+        if (src >= end) {
+            return 0;
+        }
+        uint8_t byte = *src++;
+        result |= (uint32_t)(byte & 0x7F) << (7 * index);
+        if ((byte & 0x80) == 0) {
+            *pos = src;
+            *value = result;
+            return 1;
+        }
+    }
+    return -1;
+}
+
+// 16 ビットの項目の値を符号拡張する
+template <size_t Field>
+static inline uint32_t fieldValue(uint32_t value)
+{
+    return (TelemetryTypeBytes(TelemetryFields[Field].type) == 2) ? (uint32_t)(int32_t)(int16_t)value : value;
+}
+
+// 項目の値の取得（キーフレーム、全項目）
+struct KeyUnpacker {
+    const uint8_t               *pos;       // 取得位置
+    uint32_t                    *values;    // 取得した値（項目番号順）
+
+    template <size_t Field>
+    void Visit()
+    {
+        if (TelemetryTypeBytes(TelemetryFields[Field].type) == 2) {
+            values[Field] = fieldValue<Field>(getU16(pos));
+            pos += 2;
+        }
+        else {
+            values[Field] = getU32(pos);
+            pos += 4;
+        }
+    }
+};
+
+// 項目の差分の取得（差分フレーム、mask で選択した項目の値に差分を加える）
+struct DeltaUnpacker {
+    const uint8_t               *pos;       // 取得位置
+    const uint8_t               *end;       // 受信データ末尾
+    uint32_t                    mask;       // 格納されているチャネル
+    uint32_t                    *values;    // 直前の値（項目番号順、差分を加える）
+    int                         result;     // 取得結果（1=取得、0=途中まで、-1=可変長整数が長すぎる）
+
+    template <size_t Field>
+    void Visit()
+    {
+        uint32_t    delta;                  // zigzag 変換した差分
+
+        if ((result <= 0) || !TelemetryFieldSelected(Field, mask)) {
+            return;
+        }
+        result = getVarint(&pos, end, &delta);
+        if (result > 0) {
+            values[Field] = fieldValue<Field>(values[Field] + (uint32_t)unzigzag(delta));
+        }
+    }
+};
+
+// 項目の値の設定
+struct FieldSetter {
+    const uint32_t              *values;    // 値（項目番号順）
+    TelemetrySample             &sample;    // テレメトリサンプル
+    TelemetryCounters           &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        TelemetryFields[Field].set(sample, counters, values[Field]);
+    }
+};
+
+// コンストラクタ
+TelemetryDeltaDecoder::TelemetryDeltaDecoder()
+{
+    _synced = false;                        // キーフレーム受信前
+    _seq = 0;
+    memset(_values, 0, sizeof (_values));
+}
+
+// フレーム解析（values には差分を加える直前の値を渡し、復号した値を受け取る。復号状態は更新しない）
+TelemetryDeltaDecoder::RESULT TelemetryDeltaDecoder::parse(const uint8_t *src, size_t size, size_t *frameSize, uint32_t *values)
+{
+    const uint8_t   *pos;                   // 取得位置
+    uint8_t         header;                 // 種別・チャネルマスク
+
+    *frameSize = 0;
+    if ((src == NULL) || (size < 4)) {
+        return RESULT_INCOMPLETE;
+    }
+    if (getU16(src) != TLM_DELTA_SYNC) {
+        // 同期ワード不一致
+        return RESULT_ERR_SYNC;
+    }
+    header = src[2];
+    if ((header & ~(TLM_DELTA_KEY_FLAG | TLM_CHANNEL_MASK_ALL)) != 0) {
+        // 未定義のビット
+        *frameSize = 4;
+        return RESULT_ERR_FORMAT;
+    }
+
+    // 値を取得する（CRC を検査するまで復号状態は更新しない）
+    if (header & TLM_DELTA_KEY_FLAG) {
+        // キーフレーム 全項目を取得する
+        if (size < TLM_DELTA_KEY_SIZE) {
+            return RESULT_INCOMPLETE;
+        }
+        KeyUnpacker unpacker = { src + 4, values };
+        TelemetryFieldLoop<>::Run(unpacker);
+        pos = unpacker.pos;
+    }
+    else {
+        // 差分フレーム 直前の値に差分を加える
+        DeltaUnpacker unpacker = { src + 4, src + size, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | header, values, 1 };
+        TelemetryFieldLoop<>::Run(unpacker);
+        if (unpacker.result < 0) {
+            // 可変長整数が長すぎる
+            *frameSize = 4;
+            return RESULT_ERR_FORMAT;
+        }
+        if (unpacker.result == 0) {
+            return RESULT_INCOMPLETE;
+        }
+        pos = unpacker.pos;
+    }
+    if (pos + 2 > src + size) {
+        return RESULT_INCOMPLETE;
+    }
+    *frameSize = (size_t)(pos - src) + 2;
+    if (Crc16Calc(src, (size_t)(pos - src)) != getU16(pos)) {
+        // CRC エラー
+        return RESULT_ERR_CRC;
+    }
+    return RESULT_SUCCESS;
+}
+
+// フレーム検査
+TelemetryDeltaDecoder::RESULT TelemetryDeltaDecoder::Measure(const uint8_t *src, size_t size, size_t *frameSize)
+{
+    uint32_t        values[TLM_FIELD_NUM] = {};     // 復号した値（使わない）
+
+    return parse(src, size, frameSize, values);
+}
+
+// 復号
+TelemetryDeltaDecoder::RESULT TelemetryDeltaDecoder::Decode(const uint8_t *src, size_t size, size_t *frameSize,
+                                                            TelemetrySample *sample, TelemetryCounters *counters, uint8_t *mask)
+{
+    uint32_t        values[TLM_FIELD_NUM];  // 復号した値（項目番号順）
+
+    // 差分フレームは直前の値に差分を加える（CRC を検査するまで復号状態は更新しない）
+    memcpy(values, _values, sizeof (values));
+    RESULT result = parse(src, size, frameSize, values);
+    if (result == RESULT_ERR_CRC) {
+        // CRC エラー 以降の差分は復号できない
+        _synced = false;
+    }
+    if (result != RESULT_SUCCESS) {
+        return result;
+    }
+    uint8_t header = src[2];                // 種別・チャネルマスク
+    if (((header & TLM_DELTA_KEY_FLAG) == 0) && ((_synced == false) || (src[3] != (uint8_t)(_seq + 1)))) {
+        // キーフレーム受信前、またはフレームが欠落した
+        _synced = false;
+        return RESULT_NEED_KEYFRAME;
+    }
+    memcpy(_values, values, sizeof (_values));
+    _synced = true;
+    _seq = src[3];
+
+    TelemetrySample     outSample = {};     // 復号したサンプル
+    TelemetryCounters   outCounters = {};   // 復号したカウンタ
+    FieldSetter setter = { _values, outSample, outCounters };
+    TelemetryFieldLoop<>::Run(setter);
+    if (sample != NULL) {
+        *sample = outSample;
+    }
+    if (counters != NULL) {
+        *counters = outCounters;
+    }
+    if (mask != NULL) {
+        *mask = header & (uint8_t)TLM_CHANNEL_MASK_ALL;
+    }
+    return RESULT_SUCCESS;
+}
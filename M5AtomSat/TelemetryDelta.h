@@ -0,0 +1,121 @@
+/******************************************************************************
+ * @file       TelemetryDelta.h
+ * @brief      差分圧縮テレメトリフレーム ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリの各チャネルを直前のフレームとの差分で符号化する圧縮フレームの符号化・復号クラス定義
+ *             （Arduino に依存しないため、地上局側のプログラムでもそのまま使える）
+ *             フレーム形式（ビッグエンディアン、可変長）
+ *               同期ワード 0xEB92 (2) | 種別・チャネルマスク (1) | フレーム順序番号 (1) | データ | CRC-16 (2)
+ *               種別・チャネルマスク : bit7=キーフレーム、bit0〜4=出力時刻に達したチャネル（TelemetryChannels.h の TLM_CHANNEL）
+ *               フレーム順序番号 : 符号化したフレーム毎に 1 ずつ増える（復号側でフレームの欠落を検出する）
+ *               キーフレームのデータ : テレメトリ番号 (4) | 経過時間 (4) | Pitch, Roll, Yaw (2×3) | 内部温度 (2) |
+ *                                      コマンド実行数 (4) | 送信破棄数 (4) | 姿勢区間統計 (24)
+ *                                      （全チャネルを差分なしで格納する。各項目は TelemetryFrame.h のチャネル別フレームと同じ）
+ *               差分フレームのデータ : テレメトリ番号の差分、続けてチャネルマスクのチャネルの各値の差分（チャネル番号順）
+ *                                      差分は直前にそのチャネルを格納したフレームの値との差を zigzag 変換した
+ *                                      可変長整数（下位から７ビットずつ、bit7=継続）で格納する
+ *               CRC-16/CCITT-FALSE は同期ワードから CRC の直前までについて計算する
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 格納する項目をテレメトリチャネル定義表(TelemetryChannels.h)から生成
+ * @date       2026/10/16 v1.02 姿勢区間統計チャネル追加
+ * @date       2026/10/16 v1.03 復号状態を使わないフレーム検査（Measure）追加
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TELEMETRY_DELTA_H_
+#define _TELEMETRY_DELTA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TelemetryFrame.h"
+
+#define TLM_DELTA_SYNC          0xEB92      // 同期ワード
+#define TLM_DELTA_KEY_FLAG      0x80        // キーフレーム
+#define TLM_DELTA_KEY_SIZE      54          // キーフレームサイズ[byte]
+#define TLM_DELTA_SIZE_MAX      71          // フレーム最大サイズ[byte]（全チャネルの差分が最大の差分フレーム）
+#define TLM_DELTA_OVERHEAD      11          // フレーム固定部の最大サイズ[byte]（同期ワード・種別・順序番号・番号の差分・CRC）
+
+// フレームサイズの検査（定義表から求めたサイズと一致すること）
+static_assert(TLM_DELTA_KEY_SIZE == 4 + TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | TLM_CHANNEL_MASK_ALL) + 2,
+              "TLM_DELTA_KEY_SIZE does not match TelemetryFields");
+static_assert(TLM_DELTA_OVERHEAD == 4 + TelemetryFieldsDeltaBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER)) + 2,
+              "TLM_DELTA_OVERHEAD does not match TelemetryFields");
+static_assert(TLM_DELTA_SIZE_MAX == TLM_DELTA_OVERHEAD + TelemetryFieldsDeltaBytes(TLM_CHANNEL_MASK_ALL),
+              "TLM_DELTA_SIZE_MAX does not match TelemetryFields");
+
+// 差分フレームのチャネルデータの最大サイズ[byte]
+extern const uint8_t    TelemetryDeltaChannelBytes[TLM_CHANNEL_NUM];
+
+// 差分圧縮テレメトリフレーム 符号化
+class TelemetryDeltaEncoder
+{
+public:
+
+    struct Stats {                          // 符号化統計情報
+        uint32_t    frames;                 // 符号化フレーム数
+        uint32_t    keyframes;              // キーフレーム数
+        uint32_t    rawBytes;               // 圧縮しない場合のサイズ（チャネル別フレーム）の合計[byte]
+        uint32_t    encodedBytes;           // 符号化したサイズの合計[byte]
+    };
+
+    // コンストラクタ（keyInterval フレーム毎にキーフレームを出力する）
+    TelemetryDeltaEncoder(uint32_t keyInterval);
+
+    // 符号化（dst に格納してフレームサイズを返す。格納先サイズが TLM_DELTA_SIZE_MAX 未満なら 0）
+    size_t Encode(const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask,
+                  uint8_t *dst, size_t dstSize);
+    // 次のフレームをキーフレームにする（出力形式の切り替え時など、復号側が途中から受信する場合に使う）
+    void Reset() { _sinceKey = _keyInterval; }
+    // 符号化統計情報取得
+    void GetStats(Stats *stats) const { *stats = _stats; }
+    // 符号化統計情報クリア
+    void ClearStats();
+
+private:
+    uint32_t                _keyInterval;   // キーフレーム間隔[フレーム]
+    uint32_t                _sinceKey;      // 直前のキーフレームからのフレーム数
+    uint8_t                 _seq;           // フレーム順序番号
+    uint32_t                _last[TLM_FIELD_NUM];   // 直前に格納した値（項目番号順）
+    Stats                   _stats;         // 符号化統計情報
+};
+
+// 差分圧縮テレメトリフレーム 復号
+class TelemetryDeltaDecoder
+{
+public:
+
+    enum RESULT {                           // 復号結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_INCOMPLETE,                  // フレームの途中まで（続きを受信してから再度復号する）
+        RESULT_NEED_KEYFRAME,               // キーフレーム待ち（キーフレーム受信前またはフレーム欠落後の差分フレーム）
+        RESULT_ERR_SYNC,                    // 同期ワード不一致
+        RESULT_ERR_CRC,                     // CRC エラー（以降キーフレームまで復号しない）
+        RESULT_ERR_FORMAT,                  // フレーム形式エラー
+        RESULT_NUM                          // 復号結果数
+    };
+
+    // コンストラクタ
+    TelemetryDeltaDecoder();
+
+    // 復号（src の先頭のフレームを復号し、フレームサイズを frameSize に格納する。
+    //       sample・counters には最新の値、mask には出力時刻に達したチャネルを格納する）
+    RESULT Decode(const uint8_t *src, size_t size, size_t *frameSize,
+                  TelemetrySample *sample, TelemetryCounters *counters, uint8_t *mask);
+    // 復号状態クリア（次のキーフレームまで復号しない）
+    void Reset() { _synced = false; }
+    // フレーム検査（復号状態を使わずに src の先頭のフレームのサイズと CRC だけを検査する。
+    //              受信データを並列に区切る場合に使い、値は Decode でフレーム順に復号する）
+    static RESULT Measure(const uint8_t *src, size_t size, size_t *frameSize);
+
+private:
+    bool                    _synced;        // キーフレーム受信済み
+    uint8_t                 _seq;           // 直前のフレーム順序番号
+    uint32_t                _values[TLM_FIELD_NUM]; // 直前の値（項目番号順）
+
+    // フレーム解析（復号状態は更新しない）
+    static RESULT parse(const uint8_t *src, size_t size, size_t *frameSize, uint32_t *values);
+};
+
+#endif /* _TELEMETRY_DELTA_H_ */
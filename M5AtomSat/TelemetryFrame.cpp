@@ -0,0 +1,250 @@
+/******************************************************************************
+ * @file       TelemetryFrame.cpp
+ * @brief      バイナリテレメトリフレーム
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリサンプルをビッグエンディアンで詰め、CRC-16 を付加する（浮動小数点の書式変換を行わない）
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 チャネル別フレーム追加
+ * @date       2026/10/16 v1.02 格納する項目をテレメトリチャネル定義表(TelemetryChannels.h)から生成
+ * @date       2026/10/16 v1.03 姿勢区間統計チャネル追加、32 ビット固定小数点変換追加
+ * @date       2026/10/16 v1.04 フレーム復号追加（地上局側で使う）
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include "TelemetryFrame.h"
+#include "Crc16.h"
+
+// チャネル別フレームのチャネルデータサイズ[byte]（定義表から生成）
+const uint8_t   TelemetryChannelFrameBytes[TLM_CHANNEL_NUM] = {
+    TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_TIME)),
+    TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_ATTITUDE)),
+    TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_TEMP)),
+    TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_COUNTERS)),
+    TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_ATT_STATS)),
+};
+
+// ビッグエンディアン格納
+static inline uint8_t *putU16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)(value >> 8);
+    dst[1] = (uint8_t)value;
+    return dst + 2;
+}
+
+static inline uint8_t *putU32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value >> 24);
+    dst[1] = (uint8_t)(value >> 16);
+    dst[2] = (uint8_t)(value >> 8);
+    dst[3] = (uint8_t)value;
+    return dst + 4;
+}
+
+// ビッグエンディアン取得
+static inline uint16_t getU16(const uint8_t *src)
+{
+    return (uint16_t)(((uint16_t)src[0] << 8) | src[1]);
+}
+
+static inline uint32_t getU32(const uint8_t *src)
+{
+    return ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 8) | src[3];
+}
+
+// 項目格納（mask で選択した項目を定義表の順に格納する）
+struct FramePacker {
+    uint8_t                     *pos;       // 格納位置
+    uint32_t                    mask;       // 格納するチャネル
+    const TelemetrySample       &sample;    // テレメトリサンプル
+    const TelemetryCounters     &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        if (TelemetryFieldSelected(Field, mask)) {
+            uint32_t value = TelemetryFields[Field].get(sample, counters);
+            if (TelemetryTypeBytes(TelemetryFields[Field].type) == 2) {
+                pos = putU16(pos, (uint16_t)value);
+            }
+            else {
+                pos = putU32(pos, value);
+            }
+        }
+    }
+};
+
+// 項目取得（mask で選択した項目を定義表の順に取得する）
+struct FrameUnpacker {
+    const uint8_t               *pos;       // 取得位置
+    uint32_t                    mask;       // 取得するチャネル
+    TelemetrySample             &sample;    // テレメトリサンプル
+    TelemetryCounters           &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        if (TelemetryFieldSelected(Field, mask)) {
+            if (TelemetryTypeBytes(TelemetryFields[Field].type) == 2) {
+                TelemetryFields[Field].set(sample, counters, getU16(pos));
+                pos += 2;
+            }
+            else {
+                TelemetryFields[Field].set(sample, counters, getU32(pos));
+                pos += 4;
+            }
+        }
+    }
+};
+
+// 実数を 1/100 単位の固定小数点に変換する
+int16_t TelemetryToCenti(float value)
+{
+    // float × 100 は double で誤差なく表せるので、丸めは１回だけ行われる
+    double  scaled = (double)value * 100.0;
+
+    if (isnan(scaled)) {
+        return 0;
+    }
+    if (scaled <= (double)INT16_MIN) {
+        return INT16_MIN;
+    }
+    if (scaled >= (double)INT16_MAX) {
+        return INT16_MAX;
+    }
+    return (int16_t)lrint(scaled);
+}
+
+// 実数を 1/100 単位の固定小数点に変換する（32 ビット）
+int32_t TelemetryToCenti32(float value)
+{
+    double  scaled = (double)value * 100.0;
+
+    if (isnan(scaled)) {
+        return 0;
+    }
+    if (scaled <= (double)INT32_MIN) {
+        return INT32_MIN;
+    }
+    if (scaled >= (double)INT32_MAX) {
+        return INT32_MAX;
+    }
+    return (int32_t)lrint(scaled);
+}
+
+// フレーム生成
+size_t TelemetryFramePack(const TelemetrySample &sample, uint8_t *dst, size_t dstSize)
+{
+    TelemetryCounters   counters = {};                  // テレメトリカウンタ（格納しない）
+
+    if ((dst == NULL) || (dstSize < TLM_FRAME_SIZE)) {
+        // 格納先サイズ不足
+        return 0;
+    }
+
+    FramePacker packer = { putU16(dst, TLM_FRAME_SYNC), TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | TLM_CHANNEL_MASK_FULL, sample, counters };
+    TelemetryFieldLoop<>::Run(packer);
+    putU16(packer.pos, Crc16Calc(dst, TLM_FRAME_CRC_OFFSET));
+
+    return TLM_FRAME_SIZE;
+}
+
+// チャネル別フレーム生成
+size_t TelemetryFramePackChannels(const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask,
+                                  uint8_t *dst, size_t dstSize)
+{
+    size_t      size = TLM_CH_FRAME_OVERHEAD;       // フレームサイズ
+
+    mask &= (uint8_t)TLM_CHANNEL_MASK_ALL;
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if (mask & TLM_CHANNEL_BIT(ch)) {
+            size += TelemetryChannelFrameBytes[ch];
+        }
+    }
+    if ((dst == NULL) || (dstSize < size)) {
+        // 格納先サイズ不足
+        return 0;
+    }
+
+    // 全フレームに格納する項目、チャネルマスク、チャネルの項目の順に格納する
+    FramePacker packer = { putU16(dst, TLM_CH_FRAME_SYNC), TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER), sample, counters };
+    TelemetryFieldLoop<>::Run(packer);
+    *packer.pos++ = mask;
+    packer.mask = mask;
+    TelemetryFieldLoop<>::Run(packer);
+    putU16(packer.pos, Crc16Calc(dst, size - 2));
+
+    return size;
+}
+
+// フレーム復号
+TLM_FRAME_RESULT TelemetryFrameUnpack(const uint8_t *src, size_t size, size_t *frameSize,
+                                      TelemetrySample *sample, TelemetryCounters *counters, uint8_t *mask)
+{
+    size_t              frame;              // フレームサイズ
+    uint8_t             channels;           // 格納されているチャネル
+    const uint8_t       *data;              // チャネルデータの位置
+    TelemetrySample     outSample = {};     // 復号したサンプル
+    TelemetryCounters   outCounters = {};   // 復号したカウンタ
+
+    *frameSize = 0;
+    if ((src == NULL) || (size < 2)) {
+        return TLM_FRAME_INCOMPLETE;
+    }
+    if (getU16(src) == TLM_FRAME_SYNC) {
+        // 従来形式
+        frame = TLM_FRAME_SIZE;
+        channels = (uint8_t)TLM_CHANNEL_MASK_FULL;
+        data = src + 2 + TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER));
+    }
+    else if (getU16(src) == TLM_CH_FRAME_SYNC) {
+        // チャネル別形式
+        if (size < TLM_CH_FRAME_OVERHEAD - 2) {
+            return TLM_FRAME_INCOMPLETE;
+        }
+        data = src + 2 + TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER));
+        channels = *data++;
+        if ((channels & ~TLM_CHANNEL_MASK_ALL) != 0) {
+            // 未定義のチャネル
+            *frameSize = 2;
+            return TLM_FRAME_ERR_FORMAT;
+        }
+        frame = TLM_CH_FRAME_OVERHEAD;
+        for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+            if (channels & TLM_CHANNEL_BIT(ch)) {
+                frame += TelemetryChannelFrameBytes[ch];
+            }
+        }
+    }
+    else {
+        // 同期ワード不一致
+        return TLM_FRAME_ERR_SYNC;
+    }
+    if (size < frame) {
+        return TLM_FRAME_INCOMPLETE;
+    }
+    *frameSize = frame;
+    if (Crc16Calc(src, frame - 2) != getU16(src + frame - 2)) {
+        // CRC エラー
+        return TLM_FRAME_ERR_CRC;
+    }
+
+    // 全フレームに格納する項目、チャネルの項目の順に取得する
+    FrameUnpacker unpacker = { src + 2, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER), outSample, outCounters };
+    TelemetryFieldLoop<>::Run(unpacker);
+    unpacker.pos = data;
+    unpacker.mask = channels;
+    TelemetryFieldLoop<>::Run(unpacker);
+    if (sample != NULL) {
+        *sample = outSample;
+    }
+    if (counters != NULL) {
+        *counters = outCounters;
+    }
+    if (mask != NULL) {
+        *mask = channels;
+    }
+    return TLM_FRAME_SUCCESS;
+}
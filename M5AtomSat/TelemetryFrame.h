@@ -0,0 +1,79 @@
+/******************************************************************************
+ * @file       TelemetryFrame.h
+ * @brief      バイナリテレメトリフレーム ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリを固定小数点で詰めたバイナリフレームに変換する
+ *             フレーム形式（ビッグエンディアン、20バイト）
+ *               0 : 同期ワード 0xEB90 (2)
+ *               2 : テレメトリ番号 (4)
+ *               6 : 起動からの経過時間[秒] (4)
+ *              10 : Pitch, Roll, Yaw [0.01度] 各符号付き (2)
+ *              16 : 内部温度 [0.01℃] 符号付き (2)
+ *              18 : CRC-16/CCITT-FALSE（同期ワードからの 18 バイト） (2)
+ *             チャネル別フレーム形式（ビッグエンディアン、可変長）
+ *               同期ワード 0xEB91 (2) | テレメトリ番号 (4) | チャネルマスク (1) | チャネルデータ（チャネル番号順） | CRC-16 (2)
+ *               時刻 : 経過時間[秒] (4)、姿勢 : Pitch, Roll, Yaw [0.01度] (2×3)、温度 : [0.01℃] (2)、
+ *               カウンタ : コマンド実行数 (4), 送信破棄数 (4)、
+ *               姿勢区間統計 : サンプル数 (4), Pitch 最小・最大・平均 [0.01度] (2×3), Pitch 分散 [0.01度^2] (4),
+ *                              Roll 最小・最大・平均 (2×3), Roll 分散 (4)
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 チャネル別フレーム追加
+ * @date       2026/10/16 v1.02 格納する項目をテレメトリチャネル定義表(TelemetryChannels.h)から生成
+ * @date       2026/10/16 v1.03 姿勢区間統計チャネル追加
+ * @date       2026/10/16 v1.04 フレーム復号追加（地上局側で使う）
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TELEMETRY_FRAME_H_
+#define _TELEMETRY_FRAME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TelemetryChannels.h"
+
+#define TLM_FRAME_SYNC          0xEB90      // 同期ワード
+#define TLM_FRAME_SIZE          20          // フレームサイズ[byte]（CRCを含む）
+#define TLM_FRAME_CRC_OFFSET    18          // CRC 格納位置
+
+#define TLM_CH_FRAME_SYNC       0xEB91      // チャネル別フレーム 同期ワード
+#define TLM_CH_FRAME_OVERHEAD   9           // チャネル別フレーム 固定部サイズ[byte]（同期ワード・番号・マスク・CRC）
+#define TLM_CH_FRAME_SIZE_MAX   53          // チャネル別フレーム 最大サイズ[byte]（全チャネル）
+
+// フレームサイズの検査（定義表から求めたサイズと一致すること）
+static_assert(TLM_FRAME_SIZE == 2 + TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | TLM_CHANNEL_MASK_FULL) + 2,
+              "TLM_FRAME_SIZE does not match TelemetryFields");
+static_assert(TLM_FRAME_CRC_OFFSET == TLM_FRAME_SIZE - 2, "TLM_FRAME_CRC_OFFSET does not match TLM_FRAME_SIZE");
+static_assert(TLM_CH_FRAME_OVERHEAD == 2 + TelemetryFieldsFrameBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER)) + 1 + 2,
+              "TLM_CH_FRAME_OVERHEAD does not match TelemetryFields");
+static_assert(TLM_CH_FRAME_SIZE_MAX == TLM_CH_FRAME_OVERHEAD + TelemetryFieldsFrameBytes(TLM_CHANNEL_MASK_ALL),
+              "TLM_CH_FRAME_SIZE_MAX does not match TelemetryFields");
+
+enum TLM_FRAME_RESULT {                      // フレーム復号結果
+    TLM_FRAME_SUCCESS = 0,                  // 正常終了
+    TLM_FRAME_INCOMPLETE,                   // フレームの途中まで（続きを受信してから再度復号する）
+    TLM_FRAME_ERR_SYNC,                     // 同期ワード不一致
+    TLM_FRAME_ERR_CRC,                      // CRC エラー
+    TLM_FRAME_ERR_FORMAT,                   // フレーム形式エラー（未定義のチャネル）
+    TLM_FRAME_RESULT_NUM                    // フレーム復号結果数
+};
+
+// チャネル別フレームのチャネルデータサイズ[byte]
+extern const uint8_t    TelemetryChannelFrameBytes[TLM_CHANNEL_NUM];
+
+// 実数を 1/100 単位の固定小数点に変換する（最近接丸め、int16 の範囲で飽和、NaN は 0）
+int16_t TelemetryToCenti(float value);
+// 実数を 1/100 単位の固定小数点に変換する（最近接丸め、int32 の範囲で飽和、NaN は 0）
+int32_t TelemetryToCenti32(float value);
+// フレーム生成（dst に TLM_FRAME_SIZE バイト格納し、そのサイズを返す。格納先サイズ不足は 0）
+size_t TelemetryFramePack(const TelemetrySample &sample, uint8_t *dst, size_t dstSize);
+// チャネル別フレーム生成（mask のチャネルだけを詰めて dst に格納し、そのサイズを返す。格納先サイズ不足は 0）
+size_t TelemetryFramePackChannels(const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask,
+                                  uint8_t *dst, size_t dstSize);
+// フレーム復号（src の先頭の 0xEB90 または 0xEB91 フレームを復号し、フレームサイズを frameSize に格納する。
+//              mask には格納されていたチャネルを格納し、格納されていない項目は 0 にする）
+TLM_FRAME_RESULT TelemetryFrameUnpack(const uint8_t *src, size_t size, size_t *frameSize,
+                                      TelemetrySample *sample, TelemetryCounters *counters, uint8_t *mask);
+
+#endif /* _TELEMETRY_FRAME_H_ */
@@ -0,0 +1,173 @@
+/******************************************************************************
+ * @file       TelemetryRecorder.cpp
+ * @brief      テレメトリ記録
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリ番号 % 容量 の位置にサンプルを格納するリングバッファで記録し、
+ *             TLM_RECORD_SPILL_BLOCK 件たまる毎にフラッシュのファイルの同じ規則の位置へまとめて書き込む
+ *             フラッシュのファイルは固定長レコードの循環領域とし、ファイル管理情報を持たない
+ *             フラッシュへの書き込みは Append では行わず、Spill で１回に１ブロック（seek・write・flush 各１回）だけ行う
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 Append ではフラッシュに書き込まず、Spill で１回に１ブロックだけ退避する
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <string.h>
+#include "TelemetryRecorder.h"
+
+// コンストラクタ
+TelemetryRecorderBase::TelemetryRecorderBase(TelemetrySample *ring, uint32_t capacity)
+{
+    _ring = ring;                           // リングバッファ
+    _capacity = capacity;                   // リングバッファ容量
+    _spill = false;                         // フラッシュ退避なし
+    _flashCapacity = 0;                     // フラッシュ退避ファイル容量
+    memset(&_stats, 0, sizeof (_stats));    // テレメトリ記録統計
+    Clear();
+}
+
+// 全記録削除
+void TelemetryRecorderBase::Clear()
+{
+    _started = false;                       // 記録開始前
+    _first = 0;                             // RAM 上の最も古いテレメトリ番号
+    _next = 0;                              // 次に記録するテレメトリ番号
+    _flashFirst = 0;                        // フラッシュ上の最も古いテレメトリ番号
+    _spillNext = 0;                         // 次にフラッシュに退避するテレメトリ番号
+}
+
+// フラッシュ退避設定
+TelemetryRecorderBase::RESULT TelemetryRecorderBase::SetSpill(fs::FS *fs, const char *path, uint32_t flashRecords)
+{
+    if ((fs == NULL) || (path == NULL) || (flashRecords < _capacity)) {
+        // 引数エラー（フラッシュ容量は RAM 容量以上とする）
+        return RESULT_ERR_ARGS;
+    }
+
+    // 前回起動時の記録はテレメトリ番号が重なるため、ファイルを作り直す
+    _file = fs->open(path, "w+");
+    if (!_file) {
+        _spill = false;
+        return RESULT_ERR_FILE;
+    }
+    _flashCapacity = flashRecords;
+    _spill = true;
+    // フラッシュには未記録とする（RAM 上の記録はこれから退避する）
+    _flashFirst = _first;
+    _spillNext = _first;
+
+    return RESULT_SUCCESS;
+}
+
+// サンプル記録
+TelemetryRecorderBase::RESULT TelemetryRecorderBase::Append(const TelemetrySample &sample)
+{
+    RESULT  result = RESULT_SUCCESS;    // 処理結果
+
+    if (_started && (sample.counter != _next)) {
+        // テレメトリ番号が連続しない
+        Clear();
+        result = RESULT_RESTARTED;
+    }
+    if (!_started) {
+        // 記録開始
+        _first = sample.counter;
+        _next = sample.counter;
+        _flashFirst = sample.counter;
+        _spillNext = sample.counter;
+        _started = true;
+    }
+
+    if ((_next - _first) >= _capacity) {
+        // リングバッファが一杯 最も古い記録を上書きする
+        if (_spill && (_spillNext == _first)) {
+            // 退避が追いつかなかった記録は失われる（ここではフラッシュに書き込まない）
+            // フラッシュの記録はこの記録の後から連続しなくなるので捨てる
+            _stats.lost++;
+            _spillNext = _first + 1;
+            _flashFirst = _first + 1;
+        }
+        _first++;
+    }
+
+    _ring[_next % _capacity] = sample;
+    _next++;
+    _stats.appended++;
+
+    return result;
+}
+
+// フラッシュ退避
+bool TelemetryRecorderBase::Spill()
+{
+    if (!_spill || ((_next - _spillNext) < TLM_RECORD_SPILL_BLOCK)) {
+        // 退避なし、または退避単位に達していない
+        return false;
+    }
+
+    // 最も古い未退避の記録から１ブロック（リングバッファ・ファイルそれぞれの折り返し位置まで）を書き込む
+    uint32_t ringIndex = _spillNext % _capacity;
+    uint32_t fileIndex = _spillNext % _flashCapacity;
+    uint32_t run = TLM_RECORD_SPILL_BLOCK;
+    if (run > (_capacity - ringIndex)) {
+        run = _capacity - ringIndex;
+    }
+    if (run > (_flashCapacity - fileIndex)) {
+        run = _flashCapacity - fileIndex;
+    }
+    size_t bytes = run * sizeof (TelemetrySample);
+    if (!_file.seek(fileIndex * sizeof (TelemetrySample)) ||
+        (_file.write((const uint8_t *)&_ring[ringIndex], bytes) != bytes)) {
+        // 書き込みエラー 退避済の範囲は進めず、次の呼び出しで書き直す
+        _stats.spillErrors++;
+        return false;
+    }
+    _file.flush();
+
+    // 書き込んだ分だけフラッシュ上の範囲を進める（容量を超えた古い記録は上書きされている）
+    _spillNext += run;
+    _stats.spilled += run;
+    if ((_spillNext - _flashFirst) > _flashCapacity) {
+        _flashFirst = _spillNext - _flashCapacity;
+    }
+
+    return true;
+}
+
+// 連続読み出し
+size_t TelemetryRecorderBase::Read(uint32_t from, TelemetrySample *out, size_t max)
+{
+    size_t  count = 0;      // 読み出し件数
+
+    if ((out == NULL) || (max == 0) || !_started) {
+        return 0;
+    }
+
+    if (((from - _first) < (_next - _first))) {
+        // RAM 上の記録
+        while ((count < max) && (from != _next)) {
+            out[count++] = _ring[from % _capacity];
+            from++;
+        }
+        return count;
+    }
+
+    if (_spill && ((from - _flashFirst) < (_spillNext - _flashFirst))) {
+        // フラッシュ上の記録（ファイルの折り返し位置まで）
+        uint32_t fileIndex = from % _flashCapacity;
+        uint32_t run = _spillNext - from;
+        if (run > (_flashCapacity - fileIndex)) {
+            run = _flashCapacity - fileIndex;
+        }
+        if (run > max) {
+            run = (uint32_t)max;
+        }
+        if (!_file.seek(fileIndex * sizeof (TelemetrySample))) {
+            return 0;
+        }
+        count = _file.read((uint8_t *)out, run * sizeof (TelemetrySample)) / sizeof (TelemetrySample);
+    }
+
+    return count;
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * @file       TelemetryRecorder.h
+ * @brief      テレメトリ記録 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリサンプルをテレメトリ番号順に RAM のリングバッファに記録し、
+ *             必要に応じてフラッシュ（LittleFS 等）のファイルに退避する蓄積型記録のクラス定義
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 Append ではフラッシュに書き込まず、Spill で１回に１ブロックだけ退避する
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TELEMETRY_RECORDER_H_
+#define _TELEMETRY_RECORDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <FS.h>
+#include "TelemetryFrame.h"
+
+#define TLM_RECORD_SPILL_BLOCK  32          // フラッシュ退避単位[件]（この件数たまる毎に Spill で１回書き込む）
+
+// テレメトリ記録 共通部（リングバッファの領域は派生クラス TelemetryRecorder<Capacity> が持つ）
+class TelemetryRecorderBase
+{
+public:
+
+    enum RESULT {                           // テレメトリ記録処理結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_RESTARTED,                   // テレメトリ番号が連続しないため記録をやり直した
+        RESULT_ERR_ARGS,                    // 引数エラー
+        RESULT_ERR_FILE,                    // ファイル操作エラー
+        RESULT_NUM                          // テレメトリ記録処理結果数
+    };
+
+    struct Stats {                          // テレメトリ記録統計
+        uint32_t            appended;       // 記録件数
+        uint32_t            spilled;        // フラッシュ退避件数
+        uint32_t            spillErrors;    // フラッシュ書き込みエラー回数
+        uint32_t            lost;           // 退避前に上書きされた件数
+    };
+
+    // フラッシュ退避設定（ファイルを作り直し、flashRecords 件を超えた古い記録から上書きする）
+    RESULT SetSpill(fs::FS *fs, const char *path, uint32_t flashRecords);
+    // サンプル記録（テレメトリ番号は直前の記録 + 1 であること。連続しない場合は記録をやり直す）
+    // フラッシュには書き込まない（未退避のまま上書きする記録は lost に数える）
+    RESULT Append(const TelemetrySample &sample);
+    // フラッシュ退避（未退避の記録が TLM_RECORD_SPILL_BLOCK 件以上あれば１ブロックだけ書き込み、書き込んだら true を返す）
+    // 呼び出し元を止める時間を１ブロックの書き込みに抑えるため、ループ毎に１回呼ぶ
+    bool Spill();
+    // 連続読み出し（from から最大 max 件を out に格納し、その件数を返す。from が記録範囲外なら 0）
+    size_t Read(uint32_t from, TelemetrySample *out, size_t max);
+    // 最も古い記録のテレメトリ番号（RAM・フラッシュを合わせた範囲）
+    uint32_t Oldest() const { return _spill ? _flashFirst : _first; }
+    // 最も新しい記録のテレメトリ番号（記録なしは Oldest() - 1）
+    uint32_t Newest() const { return _next - 1; }
+    // 記録件数（RAM・フラッシュを合わせた件数）
+    uint32_t Count() const { return _next - Oldest(); }
+    // 統計取得
+    void GetStats(Stats *stats) const { *stats = _stats; }
+    // 全記録削除（フラッシュのファイルは残し、以降の記録で上書きする）
+    void Clear();
+
+protected:
+    // コンストラクタ（派生クラスから領域を渡す）
+    TelemetryRecorderBase(TelemetrySample *ring, uint32_t capacity);
+
+private:
+    TelemetrySample         *_ring;         // リングバッファ（テレメトリ番号 % 容量 の位置に格納）
+    uint32_t                _capacity;      // リングバッファ容量[件]
+    bool                    _started;       // 記録開始済
+    uint32_t                _first;         // RAM 上の最も古いテレメトリ番号
+    uint32_t                _next;          // 次に記録するテレメトリ番号
+    bool                    _spill;         // フラッシュ退避あり
+    fs::File                _file;          // フラッシュ退避ファイル
+    uint32_t                _flashCapacity; // フラッシュ退避ファイル容量[件]
+    uint32_t                _flashFirst;    // フラッシュ上の最も古いテレメトリ番号
+    uint32_t                _spillNext;     // 次にフラッシュに退避するテレメトリ番号
+    Stats                   _stats;         // テレメトリ記録統計
+};
+
+// テレメトリ記録（Capacity : RAM に保持するサンプル数）
+// リングバッファの領域をインスタンス内に静的に確保する
+template <size_t Capacity>
+class TelemetryRecorder : public TelemetryRecorderBase
+{
+public:
+    static_assert(Capacity >= TLM_RECORD_SPILL_BLOCK, "TelemetryRecorder Capacity must be at least TLM_RECORD_SPILL_BLOCK");
+    static_assert(Capacity <= 0x7FFFFFFF, "TelemetryRecorder Capacity is out of range");
+
+    // 領域のバイト数（コンパイル時に確定、static_assert で RAM 予算を検査できる）
+    static constexpr size_t StorageSize()
+    {
+        return Capacity * sizeof (TelemetrySample);
+    }
+
+    // コンストラクタ
+    TelemetryRecorder() : TelemetryRecorderBase(ringStorage, Capacity) {}
+
+private:
+    TelemetrySample         ringStorage[Capacity];  // リングバッファ領域
+};
+#endif /* _TELEMETRY_RECORDER_H_ */
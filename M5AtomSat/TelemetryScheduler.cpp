@@ -0,0 +1,122 @@
+/******************************************************************************
+ * @file       TelemetryScheduler.cpp
+ * @brief      マルチレートテレメトリスケジューラ
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    チャネル毎に次の出力時刻を持ち、出力周期ずつ進めることで周期誤差を累積させない
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include "TelemetryScheduler.h"
+
+// コンストラクタ
+TelemetryScheduler::TelemetryScheduler(uint32_t linkBytesPerSec, uint32_t budgetPercent)
+{
+    _budget = (uint32_t)(((uint64_t)linkBytesPerSec * budgetPercent) / 100);    // 回線使用量の予算
+    _overhead = 0;                          // フレーム固定部サイズ
+    _channelBytes = NULL;                   // チャネル毎のデータサイズ
+    _now = 0;                               // 最後に Poll した時刻
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        _periods[ch] = 0;                   // 出力しない
+        _next[ch] = 0;
+    }
+}
+
+// 出力形式のサイズ設定
+void TelemetryScheduler::SetFrameSize(uint32_t overhead, const uint8_t *channelBytes)
+{
+    _overhead = overhead;
+    _channelBytes = channelBytes;
+}
+
+// 出力周期設定
+TelemetryScheduler::RESULT TelemetryScheduler::SetPeriod(int channel, uint32_t periodMs)
+{
+    uint32_t    periods[TLM_CHANNEL_NUM];   // 設定後の出力周期
+
+    if ((channel < 0) || (channel >= TLM_CHANNEL_NUM)) {
+        // 引数エラー
+        return RESULT_ERR_ARGS;
+    }
+    if ((periodMs != 0) && ((periodMs < TLM_SCHED_PERIOD_MIN) || (periodMs > TLM_SCHED_PERIOD_MAX))) {
+        // 出力周期が範囲外
+        return RESULT_ERR_RANGE;
+    }
+
+    // 設定後の回線使用量を見積もる
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        periods[ch] = _periods[ch];
+    }
+    periods[channel] = periodMs;
+    if (estimate(periods, _overhead, _channelBytes) > _budget) {
+        // 回線使用量が予算を超える
+        return RESULT_ERR_BUDGET;
+    }
+
+    // 最後に Poll した時刻から出力周期後に出力する（同時に設定した同じ周期のチャネルはまとまって出力される）
+    _periods[channel] = periodMs;
+    _next[channel] = _now + periodMs;
+    return RESULT_SUCCESS;
+}
+
+// 出力周期取得
+uint32_t TelemetryScheduler::GetPeriod(int channel) const
+{
+    if ((channel < 0) || (channel >= TLM_CHANNEL_NUM)) {
+        return 0;
+    }
+    return _periods[channel];
+}
+
+// 出力時刻に達したチャネルの取得
+uint8_t TelemetryScheduler::Poll(uint32_t nowMs)
+{
+    bool        due = false;                // 出力時刻に達したチャネルあり
+    uint8_t     mask = 0;                   // 出力するチャネルマスク
+
+    _now = nowMs;
+
+    // 出力時刻に達したチャネルがなければ何もしない
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if ((_periods[ch] != 0) && ((int32_t)(nowMs - _next[ch]) >= 0)) {
+            due = true;
+            break;
+        }
+    }
+    if (due == false) {
+        return 0;
+    }
+
+    // 出力時刻に達したチャネルと、TLM_SCHED_BATCH_WINDOW 以内に達するチャネルをまとめて出力する
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if ((_periods[ch] == 0) || ((int32_t)(nowMs + TLM_SCHED_BATCH_WINDOW - _next[ch]) < 0)) {
+            continue;
+        }
+        mask |= (uint8_t)TLM_CHANNEL_BIT(ch);
+        // 次の出力時刻は出力時刻から出力周期後（ループの遅れを累積させない）
+        _next[ch] += _periods[ch];
+        if ((int32_t)(nowMs - _next[ch]) >= 0) {
+            // １周期以上遅れた 遅れた分は出力せずに現在時刻から出力周期後とする
+            _next[ch] = nowMs + _periods[ch];
+        }
+    }
+    return mask;
+}
+
+// 回線使用量の見積もり
+uint32_t TelemetryScheduler::estimate(const uint32_t *periods, uint32_t overhead, const uint8_t *channelBytes)
+{
+    uint32_t    load = 0;                   // 回線使用量[byte/s]
+
+    for (int ch = 0; ch < TLM_CHANNEL_NUM; ch++) {
+        if (periods[ch] == 0) {
+            continue;
+        }
+        uint32_t bytes = overhead + ((channelBytes != NULL) ? channelBytes[ch] : 0);
+        // 切り上げ（見積もりは小さくならないようにする）
+        load += ((bytes * 1000) + periods[ch] - 1) / periods[ch];
+    }
+    return load;
+}
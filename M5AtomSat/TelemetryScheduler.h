@@ -0,0 +1,67 @@
+/******************************************************************************
+ * @file       TelemetryScheduler.h
+ * @brief      マルチレートテレメトリスケジューラ ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    テレメトリチャネル毎の出力周期を管理し、出力時刻に達したチャネルの組を返すクラス定義
+ *             同時期に出力時刻に達したチャネルは１つのフレームにまとめる
+ *             出力周期の設定時に回線使用量を見積もり、予算を超える設定を拒否する
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TELEMETRY_SCHEDULER_H_
+#define _TELEMETRY_SCHEDULER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TelemetryChannels.h"
+
+#define TLM_SCHED_PERIOD_MIN    10          // 最短出力周期[ms]（100Hz）
+#define TLM_SCHED_PERIOD_MAX    3600000     // 最長出力周期[ms]（1時間）
+#define TLM_SCHED_BATCH_WINDOW  20          // まとめて出力する出力時刻の幅[ms]
+
+class TelemetryScheduler
+{
+public:
+
+    enum RESULT {                           // テレメトリスケジューラ処理結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_ERR_RANGE,                   // 出力周期が範囲外
+        RESULT_ERR_BUDGET,                  // 回線使用量が予算を超える
+        RESULT_ERR_ARGS,                    // 引数エラー
+        RESULT_NUM                          // テレメトリスケジューラ処理結果数
+    };
+
+    // コンストラクタ（回線容量[byte/s]と、そのうちテレメトリに使う割合[%]を指定する）
+    TelemetryScheduler(uint32_t linkBytesPerSec, uint32_t budgetPercent);
+
+    // 出力形式のサイズ設定（フレーム固定部サイズとチャネル毎のデータサイズ[byte]、回線使用量の見積もりに使う）
+    void SetFrameSize(uint32_t overhead, const uint8_t *channelBytes);
+    // 出力周期設定（0 は出力しない。回線使用量が予算を超える場合は設定しない）
+    RESULT SetPeriod(int channel, uint32_t periodMs);
+    // 出力周期取得[ms]（0 は出力しない）
+    uint32_t GetPeriod(int channel) const;
+    // 出力時刻に達したチャネルの取得（ループ毎に呼び出し、出力するチャネルマスクを返す。なければ 0）
+    uint8_t Poll(uint32_t nowMs);
+    // 現在の出力形式での回線使用量の見積もり[byte/s]
+    uint32_t Load() const { return estimate(_periods, _overhead, _channelBytes); }
+    // 指定した出力形式での回線使用量の見積もり[byte/s]（出力形式を切り替える前の検査に使う）
+    uint32_t LoadFor(uint32_t overhead, const uint8_t *channelBytes) const { return estimate(_periods, overhead, channelBytes); }
+    // 回線使用量の予算[byte/s]
+    uint32_t Budget() const { return _budget; }
+
+private:
+    uint32_t                _budget;                        // 回線使用量の予算[byte/s]
+    uint32_t                _overhead;                      // フレーム固定部サイズ[byte]
+    const uint8_t           *_channelBytes;                 // チャネル毎のデータサイズ[byte]
+    uint32_t                _periods[TLM_CHANNEL_NUM];      // 出力周期[ms]（0 は出力しない）
+    uint32_t                _next[TLM_CHANNEL_NUM];         // 次の出力時刻[ms]
+    uint32_t                _now;                           // 最後に Poll した時刻[ms]
+
+    // 回線使用量の見積もり（まとめずにチャネル毎にフレームを出力した場合の最大値）
+    static uint32_t estimate(const uint32_t *periods, uint32_t overhead, const uint8_t *channelBytes);
+};
+
+#endif /* _TELEMETRY_SCHEDULER_H_ */
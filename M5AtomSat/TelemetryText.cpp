@@ -0,0 +1,471 @@
+/******************************************************************************
+ * @file       TelemetryText.cpp
+ * @brief      テレメトリ文字列生成
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    ２桁ずつの数字表を用いて整数を下位桁から格納し、テレメトリ文字列を出力バッファに直接生成する
+ *             テレメトリ文字列の生成には sprintf を使わない
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 チャネル別テレメトリ文字列追加
+ * @date       2026/10/16 v1.02 出力する項目をテレメトリチャネル定義表(TelemetryChannels.h)から生成
+ * @date       2026/10/16 v1.04 テレメトリ文字列の解析追加（地上局側で使う）
+ * @date       2026/10/16 v1.05 実数の値からのテレメトリ文字列生成追加（符号・範囲を sprintf の %6.2f と一致させる）
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "TelemetryText.h"
+
+// チャネル別テレメトリ文字列のチャネル項目の最大長[byte]（定義表から生成）
+const uint8_t   TelemetryChannelTextBytes[TLM_CHANNEL_NUM] = {
+    TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_TIME), true),
+    TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_ATTITUDE), true),
+    TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_TEMP), true),
+    TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_COUNTERS), true),
+    TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_ATT_STATS), true),
+};
+
+// ２桁の数字表（"00"〜"99"）
+static const char   digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 10進桁数
+static inline int countDigits(uint32_t value)
+{
+    int digits = 1;
+    while (value >= 100) {
+        value /= 100;
+        digits += 2;
+    }
+    return (value >= 10) ? (digits + 1) : digits;
+}
+
+// ２桁格納（value < 100）
+static inline char *putPair(char *dst, uint32_t value)
+{
+    memcpy(dst, &digitPairs[value * 2], 2);
+    return dst + 2;
+}
+
+// 符号なし整数格納（桁数 digits を指定し、下位桁から２桁ずつ格納する）
+static inline char *putUInt(char *dst, uint32_t value, int digits)
+{
+    char    *pos = dst + digits;    // 格納位置（末尾）
+
+    while (value >= 100) {
+        pos -= 2;
+        memcpy(pos, &digitPairs[(value % 100) * 2], 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        pos -= 2;
+        memcpy(pos, &digitPairs[value * 2], 2);
+    }
+    else {
+        *--pos = (char)('0' + value);
+    }
+    return dst + digits;
+}
+
+// 符号付き整数格納（"%d"）
+static inline char *putInt(char *dst, int32_t value)
+{
+    uint32_t    magnitude = (uint32_t)value;    // 絶対値
+
+    if (value < 0) {
+        *dst++ = '-';
+        magnitude = 0U - magnitude;
+    }
+    return putUInt(dst, magnitude, countDigits(magnitude));
+}
+
+// ２桁以上の符号なし整数格納（"%02d"）
+static inline char *putUInt02(char *dst, uint32_t value)
+{
+    return (value < 100) ? putPair(dst, value) : putUInt(dst, value, countDigits(value));
+}
+
+// 区切り文字列 ", " 格納
+static inline char *putSeparator(char *dst)
+{
+    dst[0] = ',';
+    dst[1] = ' ';
+    return dst + 2;
+}
+
+// 項目名 "名前=" 格納
+static inline char *putLabel(char *dst, const char *label)
+{
+    while (*label != '\0') {
+        *dst++ = *label++;
+    }
+    *dst++ = '=';
+    return dst;
+}
+
+// 経過時間格納（"%02d:%02d:%02d"）
+static inline char *putTime(char *dst, uint32_t missionTime)
+{
+    uint32_t    hour = missionTime / 3600;                      // 時
+    uint32_t    min  = (missionTime - (hour * 3600)) / 60;      // 分
+    uint32_t    sec  = missionTime % 60;                        // 秒
+
+    dst = putUInt02(dst, hour);
+    *dst++ = ':';
+    dst = putPair(dst, min);
+    *dst++ = ':';
+    return putPair(dst, sec);
+}
+
+// 項目格納（mask で選択した項目を定義表の順に ", 値" または ", 項目名=値" の形式で格納する）
+struct TextFormatter {
+    char                        *pos;       // 格納位置
+    uint32_t                    mask;       // 格納するチャネル
+    bool                        labels;     // 項目名を付ける
+    const TelemetrySample       &sample;    // テレメトリサンプル
+    const TelemetryCounters     &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        if (!TelemetryFieldSelected(Field, mask)) {
+            return;
+        }
+        uint32_t value = TelemetryFields[Field].get(sample, counters);
+        pos = putSeparator(pos);
+        if (labels && (TelemetryFields[Field].label != NULL)) {
+            pos = putLabel(pos, TelemetryFields[Field].label);
+        }
+        switch (TelemetryFields[Field].type) {
+        case TLM_TYPE_INT32:
+            pos = putInt(pos, (int32_t)value);
+            break;
+        case TLM_TYPE_UINT32:
+            pos = putUInt(pos, value, countDigits(value));
+            break;
+        case TLM_TYPE_TIME:
+            pos = putTime(pos, value);
+            break;
+        default:
+            pos = TelemetryFormatCenti(pos, (int32_t)value);
+            break;
+        }
+    }
+};
+
+// 1/100 単位の固定小数点を "%6.2f" と同じ書式で格納する
+char *TelemetryFormatCenti(char *dst, int32_t centi, bool negative)
+{
+    uint32_t    magnitude = (uint32_t)centi;    // 絶対値
+
+    if (centi < 0) {
+        negative = true;
+        magnitude = 0U - magnitude;
+    }
+    uint32_t    integer = magnitude / 100;      // 整数部
+    uint32_t    fraction = magnitude % 100;     // 小数部
+    int         digits = countDigits(integer);  // 整数部の桁数
+
+    // 幅 6 に満たない分を空白で埋める（符号 + 整数部 + "." + 小数部２桁）
+    for (int width = (negative ? 1 : 0) + digits + 3; width < 6; width++) {
+        *dst++ = ' ';
+    }
+    if (negative) {
+        *dst++ = '-';
+    }
+    dst = putUInt(dst, integer, digits);
+    *dst++ = '.';
+    return putPair(dst, fraction);
+}
+
+// 実数を "%6.2f" と同じ書式で格納する
+char *TelemetryFormatFloat(char *dst, float value)
+{
+    bool    negative = signbit(value);      // 負数（-0.0 と 0 に丸めた負の値を含む）
+
+    if (isnan(value) || isinf(value)) {
+        // NaN・無限大（幅 6 に満たない分を空白で埋める）
+        for (int width = (negative ? 1 : 0) + 3; width < 6; width++) {
+            *dst++ = ' ';
+        }
+        if (negative) {
+            *dst++ = '-';
+        }
+        memcpy(dst, isnan(value) ? "nan" : "inf", 3);
+        return dst + 3;
+    }
+    return TelemetryFormatCenti(dst, TelemetryToCenti32(value), negative);
+}
+
+// テレメトリ文字列生成
+size_t TelemetryFormatText(const TelemetrySample &sample, char *dst, size_t dstSize)
+{
+    TelemetryCounters   counters = {};      // テレメトリカウンタ（出力しない）
+
+    if ((dst == NULL) || (dstSize < TLM_TEXT_SIZE_MAX)) {
+        // 格納先サイズ不足
+        return 0;
+    }
+
+    memcpy(dst, "TLM", 3);
+    TextFormatter formatter = { dst + 3, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | TLM_CHANNEL_MASK_FULL, false, sample, counters };
+    TelemetryFieldLoop<>::Run(formatter);
+    *formatter.pos = '\0';
+
+    return (size_t)(formatter.pos - dst);
+}
+
+// テレメトリ文字列生成（実数の値から）
+size_t TelemetryFormatTextValues(int32_t counter, uint32_t missionTime, float pitch, float roll, float yaw, float temp,
+                                 char *dst, size_t dstSize)
+{
+    char    *pos = dst;                     // 格納位置
+
+    if ((dst == NULL) || (dstSize < TLM_TEXT_VALUES_SIZE_MAX)) {
+        // 格納先サイズ不足
+        return 0;
+    }
+
+    memcpy(pos, "TLM", 3);
+    pos = putSeparator(pos + 3);
+    pos = putInt(pos, counter);
+    pos = putSeparator(pos);
+    pos = putTime(pos, missionTime);
+    pos = TelemetryFormatFloat(putSeparator(pos), pitch);
+    pos = TelemetryFormatFloat(putSeparator(pos), roll);
+    pos = TelemetryFormatFloat(putSeparator(pos), yaw);
+    pos = TelemetryFormatFloat(putSeparator(pos), temp);
+    *pos = '\0';
+
+    return (size_t)(pos - dst);
+}
+
+// チャネル別テレメトリ文字列生成
+size_t TelemetryFormatChannels(const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask,
+                               char *dst, size_t dstSize)
+{
+    if ((dst == NULL) || (dstSize < TLM_CH_TEXT_SIZE_MAX)) {
+        // 格納先サイズ不足
+        return 0;
+    }
+
+    memcpy(dst, "TLMC", 4);
+    TextFormatter formatter = { dst + 4, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | (mask & TLM_CHANNEL_MASK_ALL), true, sample, counters };
+    TelemetryFieldLoop<>::Run(formatter);
+    *formatter.pos = '\0';
+
+    return (size_t)(formatter.pos - dst);
+}
+
+/******************************************************************************
+ * 解析
+ ******************************************************************************/
+
+// 符号なし整数取得（１桁以上、32 ビットを超える場合は false）
+static bool getUInt(const char **pos, const char *end, uint32_t *value)
+{
+    const char  *src = *pos;
+    uint64_t    result = 0;
+
+    if ((src >= end) || (*src < '0') || (*src > '9')) {
+        return false;
+    }
+    while ((src < end) && (*src >= '0') && (*src <= '9')) {
+        result = (result * 10) + (uint32_t)(*src++ - '0');
+        if (result > UINT32_MAX) {
+            return false;
+        }
+    }
+    *pos = src;
+    *value = (uint32_t)result;
+    return true;
+}
+
+// 符号付き整数取得（"%d"）
+static bool getInt(const char **pos, const char *end, uint32_t *value)
+{
+    const char  *src = *pos;
+    bool        negative = false;       // 負数
+    uint32_t    magnitude;              // 絶対値
+
+    if ((src < end) && (*src == '-')) {
+        negative = true;
+        src++;
+    }
+    if (!getUInt(&src, end, &magnitude) || (magnitude > (negative ? 0x80000000U : 0x7FFFFFFFU))) {
+        return false;
+    }
+    *pos = src;
+    *value = negative ? (0U - magnitude) : magnitude;
+    return true;
+}
+
+// 経過時間取得（"時:分:秒"）
+static bool getTime(const char **pos, const char *end, uint32_t *value)
+{
+    const char  *src = *pos;
+    uint32_t    hour, min, sec;         // 時、分、秒
+
+    if (!getUInt(&src, end, &hour) || (src >= end) || (*src++ != ':')
+        || !getUInt(&src, end, &min) || (src >= end) || (*src++ != ':')
+        || !getUInt(&src, end, &sec) || (min >= 60) || (sec >= 60)) {
+        return false;
+    }
+    *pos = src;
+    *value = (hour * 3600) + (min * 60) + sec;
+    return true;
+}
+
+// 1/100 単位の固定小数点取得（"%6.2f"、先頭の空白を読み飛ばす）
+static bool getCenti(const char **pos, const char *end, uint32_t *value)
+{
+    const char  *src = *pos;
+    bool        negative = false;       // 負数
+    uint32_t    integer;                // 整数部
+
+    while ((src < end) && (*src == ' ')) {
+        src++;
+    }
+    if ((src < end) && (*src == '-')) {
+        negative = true;
+        src++;
+    }
+    if (!getUInt(&src, end, &integer) || (integer > 21474836) || (end - src < 3) || (src[0] != '.')
+        || (src[1] < '0') || (src[1] > '9') || (src[2] < '0') || (src[2] > '9')) {
+        return false;
+    }
+    uint32_t magnitude = (integer * 100) + (uint32_t)((src[1] - '0') * 10) + (uint32_t)(src[2] - '0');
+    *pos = src + 3;
+    *value = negative ? (0U - magnitude) : magnitude;
+    return true;
+}
+
+// 文字列の照合（一致すれば読み飛ばす）
+static bool skipText(const char **pos, const char *end, const char *text)
+{
+    const char  *src = *pos;
+
+    while (*text != '\0') {
+        if ((src >= end) || (*src++ != *text++)) {
+            return false;
+        }
+    }
+    *pos = src;
+    return true;
+}
+
+// 項目解析（labels が false なら mask の全項目を ", 値" の形式で、
+//           true なら全フレームに格納する項目を ", 値"、以降は ", 項目名=値" のある項目を取得する）
+struct TextParser {
+    const char                  *pos;       // 解析位置
+    const char                  *end;       // 行末
+    uint32_t                    mask;       // 解析するチャネル
+    bool                        labels;     // 項目名付き
+    bool                        valid;      // 解析成功
+    uint32_t                    found;      // 取得したチャネル
+    uint32_t                    missing;    // 項目が欠けていたチャネル
+    TelemetrySample             &sample;    // テレメトリサンプル
+    TelemetryCounters           &counters;  // テレメトリカウンタ
+
+    template <size_t Field>
+    void Visit()
+    {
+        const char  *src = pos;             // 解析位置
+        uint32_t    value;                  // 取得した値
+        bool        parsed;                 // 値を取得した
+
+        if (!valid || !TelemetryFieldSelected(Field, mask)) {
+            return;
+        }
+        bool labeled = labels && (TelemetryFields[Field].label != NULL);
+        if (!skipText(&src, end, ", ") || (labeled && (!skipText(&src, end, TelemetryFields[Field].label) || !skipText(&src, end, "=")))) {
+            // 項目なし
+            if (labeled) {
+                missing |= TLM_CHANNEL_BIT(TelemetryFields[Field].channel);
+            }
+            else {
+                valid = false;
+            }
+            return;
+        }
+        switch (TelemetryFields[Field].type) {
+        case TLM_TYPE_INT32:
+            parsed = getInt(&src, end, &value);
+            break;
+        case TLM_TYPE_UINT32:
+            parsed = getUInt(&src, end, &value);
+            break;
+        case TLM_TYPE_TIME:
+            parsed = getTime(&src, end, &value);
+            break;
+        default:
+            parsed = getCenti(&src, end, &value);
+            break;
+        }
+        if (!parsed) {
+            valid = false;
+            return;
+        }
+        TelemetryFields[Field].set(sample, counters, value);
+        found |= TLM_CHANNEL_BIT(TelemetryFields[Field].channel);
+        pos = src;
+    }
+};
+
+// テレメトリ文字列解析
+bool TelemetryParseText(const char *line, size_t length,
+                        TelemetrySample *sample, TelemetryCounters *counters, uint8_t *mask)
+{
+    const char          *pos = line;        // 解析位置
+    const char          *end = line + length;   // 行末
+    TelemetrySample     outSample = {};     // 解析したサンプル
+    TelemetryCounters   outCounters = {};   // 解析したカウンタ
+    bool                labels;             // 項目名付き（チャネル別形式）
+
+    if (line == NULL) {
+        return false;
+    }
+    if ((end > pos) && (end[-1] == '\r')) {
+        end--;
+    }
+    if (skipText(&pos, end, "TLMC")) {
+        labels = true;
+    }
+    else if (skipText(&pos, end, "TLM")) {
+        labels = false;
+    }
+    else {
+        return false;
+    }
+
+    TextParser parser = { pos, end, TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | (labels ? TLM_CHANNEL_MASK_ALL : TLM_CHANNEL_MASK_FULL),
+                          labels, true, 0, 0, outSample, outCounters };
+    TelemetryFieldLoop<>::Run(parser);
+    uint32_t channels = parser.found & TLM_CHANNEL_MASK_ALL;
+    if (!parser.valid || (parser.pos != end) || ((parser.found & TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER)) == 0)
+        || ((parser.missing & channels) != 0)) {
+        // 形式エラー、または一部の項目だけのチャネルあり
+        return false;
+    }
+    if (sample != NULL) {
+        *sample = outSample;
+    }
+    if (counters != NULL) {
+        *counters = outCounters;
+    }
+    if (mask != NULL) {
+        *mask = (uint8_t)channels;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * @file       TelemetryText.h
+ * @brief      テレメトリ文字列生成 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    固定小数点のテレメトリサンプルから、sprintf を使わずにテレメトリ文字列を生成する
+ *             出力は sprintf("TLM, %d, %02d:%02d:%02d, %6.2f, %6.2f, %6.2f, %6.2f") と同一
+ *             （実数の値から生成する TelemetryFormatTextValues は、0 に丸めた負の値の "-0.00"・NaN・無限大を含めて同一）
+ *             チャネル別の文字列は "TLMC, 番号" に続けて、指定チャネルの項目を名前付きで出力する
+ *               ", T=時:分:秒"  ", P=%6.2f, R=%6.2f, Y=%6.2f"  ", C=%6.2f"  ", CMD=%u, TXD=%u"
+ *               ", N=%u, PMIN=%6.2f, PMAX=%6.2f, PAVG=%6.2f, PVAR=%6.2f, RMIN=%6.2f, RMAX=%6.2f, RAVG=%6.2f, RVAR=%6.2f"
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 チャネル別テレメトリ文字列追加
+ * @date       2026/10/16 v1.02 出力する項目をテレメトリチャネル定義表(TelemetryChannels.h)から生成
+ * @date       2026/10/16 v1.03 姿勢区間統計チャネル追加
+ * @date       2026/10/16 v1.04 テレメトリ文字列の解析追加（地上局側で使う）
+ * @date       2026/10/16 v1.05 実数の値からのテレメトリ文字列生成追加（符号・範囲を sprintf の %6.2f と一致させる）
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _TELEMETRY_TEXT_H_
+#define _TELEMETRY_TEXT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TelemetryFrame.h"
+
+#define TLM_TEXT_SIZE_MAX       68          // テレメトリ文字列の最大サイズ[byte]（'\0'終端を含む）
+#define TLM_CH_TEXT_SIZE_MAX    248         // チャネル別テレメトリ文字列の最大サイズ[byte]（'\0'終端を含む）
+#define TLM_CH_TEXT_OVERHEAD    19          // チャネル別テレメトリ文字列 固定部の最大長[byte]（"TLMC, 番号" と改行）
+#define TLM_TEXT_VALUES_SIZE_MAX    88      // 実数の値からのテレメトリ文字列の最大サイズ[byte]（'\0'終端を含む、値は "-21474836.48" まで）
+
+// 文字列サイズの検査（定義表から求めた最大長に足りること）
+static_assert(TLM_TEXT_SIZE_MAX == 3 + TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | TLM_CHANNEL_MASK_FULL, false) + 1,
+              "TLM_TEXT_SIZE_MAX does not match TelemetryFields");
+static_assert(TLM_CH_TEXT_OVERHEAD == 4 + TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER), true) + 2,
+              "TLM_CH_TEXT_OVERHEAD does not match TelemetryFields");
+static_assert(TLM_CH_TEXT_SIZE_MAX >= 4 + TelemetryFieldsTextBytes(TLM_CHANNEL_BIT(TLM_CHANNEL_HEADER) | TLM_CHANNEL_MASK_ALL, true) + 1,
+              "TLM_CH_TEXT_SIZE_MAX is smaller than TelemetryFields");
+static_assert(TLM_TEXT_VALUES_SIZE_MAX == TLM_TEXT_SIZE_MAX + 4 * (TelemetryTypeTextWidth(TLM_TYPE_CENTI32) - TelemetryTypeTextWidth(TLM_TYPE_CENTI16)),
+              "TLM_TEXT_VALUES_SIZE_MAX does not match TelemetryFields");
+
+// チャネル別テレメトリ文字列のチャネル項目の最大長[byte]
+extern const uint8_t    TelemetryChannelTextBytes[TLM_CHANNEL_NUM];
+
+// 1/100 単位の固定小数点を "%6.2f" と同じ書式で格納し、次の格納位置を返す（'\0'終端しない）
+// negative は元の値の符号（0 に丸めた負の値を "-0.00" とする場合に true を指定する）
+char *TelemetryFormatCenti(char *dst, int32_t centi, bool negative = false);
+// 実数を "%6.2f" と同じ書式で格納し、次の格納位置を返す（'\0'終端しない）
+// 1/100 単位の固定小数点に変換して格納する。NaN・無限大は "nan"・"inf"、int32 の 0.01 単位の範囲を超える値は飽和する
+char *TelemetryFormatFloat(char *dst, float value);
+// テレメトリ文字列生成（'\0'終端して文字列長を返す。格納先サイズが TLM_TEXT_SIZE_MAX 未満なら 0）
+size_t TelemetryFormatText(const TelemetrySample &sample, char *dst, size_t dstSize);
+// テレメトリ文字列生成（実数の姿勢・内部温度から生成する。'\0'終端して文字列長を返す。
+//                      格納先サイズが TLM_TEXT_VALUES_SIZE_MAX 未満なら 0）
+size_t TelemetryFormatTextValues(int32_t counter, uint32_t missionTime, float pitch, float roll, float yaw, float temp,
+                                 char *dst, size_t dstSize);
+// チャネル別テレメトリ文字列生成（'\0'終端して文字列長を返す。格納先サイズが TLM_CH_TEXT_SIZE_MAX 未満なら 0）
+size_t TelemetryFormatChannels(const TelemetrySample &sample, const TelemetryCounters &counters, uint8_t mask,
+                               char *dst, size_t dstSize);
+// テレメトリ文字列解析（"TLM" または "TLMC" の１行（改行を含まない）を解析する。
+//                      mask には含まれていたチャネルを格納し、含まれていない項目は 0 にする。形式が違えば false）
+bool TelemetryParseText(const char *line, size_t length,
+                        TelemetrySample *sample, TelemetryCounters *counters, uint8_t *mask);
+
+#endif /* _TELEMETRY_TEXT_H_ */
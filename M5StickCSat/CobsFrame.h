@@ -0,0 +1,68 @@
+/******************************************************************************
+ * @file       CobsFrame.h
+ * @brief      COBSフレーム解析 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    COBS（Consistent Overhead Byte Stuffing）＋CRC-16 フレームの逐次デコード／エンコードのクラス定義
+ *             フレーム形式 : 0x00 | COBS(ペイロード + CRC-16(ビッグエンディアン)) | 0x00
+ *             CRC の下位バイトが 0x00 のフレームは、末尾のコードバイト 0x01 だけが欠落すると検出できない
+ *             （剰余 0 の CRC は末尾の 0x00 の有無で剰余が変わらないため。約 1/256 のフレームが該当する）
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 フレーム受信完了の直後の区切りコードを空フレームとして扱う（CRCエラーにしない）
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _COBS_FRAME_H_
+#define _COBS_FRAME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COBS_FRAME_DELIMITER    0x00        // フレーム区切りコード
+#define COBS_FRAME_CRC_SIZE     2           // CRC-16 サイズ
+
+// COBSエンコード後の最大サイズ（区切りコードを除く）
+#define COBS_ENCODED_MAX(n)     ((n) + ((n) / 254) + 1)
+
+class CobsFrameParser
+{
+public:
+
+    enum RESULT {                           // フレーム解析結果
+        RESULT_CONTINUE = 0,                // フレーム受信中
+        RESULT_FRAME_OK,                    // フレーム受信完了（CRC正常）
+        RESULT_EMPTY,                       // 空フレーム（連続した区切りコード）
+        RESULT_ERR_CRC,                     // CRCエラー
+        RESULT_ERR_OVERFLOW,                // バッファサイズ超過
+        RESULT_ERR_FORMAT,                  // COBS形式エラー（ブロック途中で区切りコード）
+        RESULT_NUM                          // フレーム解析結果数
+    };
+
+    // コンストラクタ
+    CobsFrameParser();
+
+    // フレーム解析開始（デコード結果の格納先を設定する）
+    void Reset(uint8_t *buff, size_t size);
+    // １バイト入力（１バイトあたり一定時間で処理する）
+    RESULT Feed(uint8_t data);
+    // デコードしたペイロード長（CRCを除く）取得
+    size_t GetLength() const;
+
+    // フレームエンコード（前後の区切りコードを含めて dst に格納し、そのサイズを返す）
+    static size_t Encode(const uint8_t *payload, size_t length, uint8_t *dst, size_t dstSize);
+
+private:
+    uint8_t                 *_buff;         // デコード結果格納バッファへのポインタ
+    size_t                  _size;          // デコード結果格納バッファサイズ
+    size_t                  length;         // デコード済バイト数（CRCを含む）
+    size_t                  frameLength;    // 受信完了したフレームのデコード済バイト数（CRCを含む）
+    uint8_t                 remain;         // 現在のブロックの残りデータバイト数
+    bool                    pendingZero;    // 次のブロック開始時に 0x00 を補う
+    bool                    overflow;       // バッファサイズ超過
+    uint16_t                crc;            // デコード済データの CRC-16
+
+    // デコード結果１バイト格納
+    void put(uint8_t data);
+};
+#endif /* _COBS_FRAME_H_ */
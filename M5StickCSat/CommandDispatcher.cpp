@@ -0,0 +1,197 @@
+/******************************************************************************
+ * @file       CommandDispatcher.cpp
+ * @brief      コマンドディスパッチャ
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    受信したコマンド行を解析し、コマンド定義表を二分探索して処理関数を呼び出す
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 コマンド受信ポート番号を処理関数に渡す
+ * @date       2026/10/16 v1.02 整数引数を 10進数（0x で16進数）で解析し、先頭の 0 で8進数としない
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "CommandDispatcher.h"
+
+// 空白文字判定
+static inline bool isSpaceChar(char c)
+{
+    return (c == ' ') || (c == '\t');
+}
+
+// 次のトークンを切り出す（トークン末尾を '\0' に書き換え、次の解析位置を返す）
+static char *nextToken(char *pos, char **token)
+{
+    // 先頭の空白を読み飛ばす
+    while (isSpaceChar(*pos)) {
+        pos++;
+    }
+    if (*pos == '\0') {
+        // トークンなし
+        *token = NULL;
+        return pos;
+    }
+    *token = pos;
+    // トークン末尾を探す
+    while ((*pos != '\0') && !isSpaceChar(*pos)) {
+        pos++;
+    }
+    if (*pos != '\0') {
+        // トークンを終端する
+        *pos++ = '\0';
+    }
+    return pos;
+}
+
+// コマンド検索
+const CommandDispatcher::CommandDef *CommandDispatcher::Find(const char *name) const
+{
+    size_t  low = 0;            // 探索範囲下端
+    size_t  high = _num;        // 探索範囲上端（範囲外）
+
+    // コマンド定義表を二分探索する
+    while (low < high) {
+        size_t  mid = low + ((high - low) / 2);
+        int     cmp = strcmp(name, _table[mid].name);
+        if (cmp == 0) {
+            // コマンド名一致
+            return &_table[mid];
+        }
+        if (cmp < 0) {
+            high = mid;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+
+    // 該当コマンドなし
+    return NULL;
+}
+
+// コマンド振り分け
+CommandDispatcher::RESULT CommandDispatcher::Dispatch(char *line, uint8_t port) const
+{
+    char                *pos;           // 解析位置
+    char                *token;         // 切り出したトークン
+    const CommandDef    *def;           // コマンド定義
+    CommandArgs         args;           // コマンド引数
+    const char          *spec;          // 引数仕様
+    RESULT              result;         // 処理結果
+
+    if (line == NULL) {
+        // パラメータエラー
+        return RESULT_ERR_PARAM;
+    }
+
+    // コマンド名を切り出す
+    pos = nextToken(line, &token);
+    if (token == NULL) {
+        // 空行
+        return RESULT_NO_COMMAND;
+    }
+
+    // コマンド定義を検索する
+    def = Find(token);
+    if (def == NULL) {
+        // 認識できないコマンド
+        return RESULT_ERR_UNKNOWN_CMD;
+    }
+
+    // 引数仕様に従って引数を解析する
+    args.count = 0;
+    args.port = port;
+    for (spec = (def->argSpec != NULL) ? def->argSpec : ""; *spec != '\0'; spec++) {
+        if (args.count >= COMMAND_ARG_MAX) {
+            // 引数仕様が引数最大数を超えている
+            return RESULT_ERR_PARAM;
+        }
+        bool optional = isupper((unsigned char)*spec);
+        char type = (char)tolower((unsigned char)*spec);
+        if (type == 's') {
+            // 残り文字列 先頭の空白を読み飛ばす
+            while (isSpaceChar(*pos)) {
+                pos++;
+            }
+            token = (*pos != '\0') ? pos : NULL;
+            pos += strlen(pos);
+        }
+        else {
+            pos = nextToken(pos, &token);
+        }
+        if (token == NULL) {
+            if (optional) {
+                // 省略可能な引数以降は省略
+                break;
+            }
+            // 必須引数なし
+            return RESULT_ERR_ARGS;
+        }
+        result = parseArg(type, token, def->enumNames, &args.arg[args.count]);
+        if (result != RESULT_SUCCESS) {
+            return result;
+        }
+        args.count++;
+    }
+
+    // 余分な引数のチェック
+    pos = nextToken(pos, &token);
+    if (token != NULL) {
+        return RESULT_ERR_ARGS;
+    }
+
+    // コマンド処理関数呼び出し
+    def->handler(args);
+
+    return RESULT_SUCCESS;
+}
+
+// 引数１個の解析
+CommandDispatcher::RESULT CommandDispatcher::parseArg(char spec, const char *token, const char * const *enumNames, CommandArg *arg)
+{
+    char    *end;       // 変換終了位置
+
+    switch (spec) {
+    case 'i':
+        {
+            // 整数（10進数、0x で16進数。先頭の 0 で8進数としない）
+            const char *digits = ((*token == '-') || (*token == '+')) ? (token + 1) : token;
+            int base = ((digits[0] == '0') && ((digits[1] == 'x') || (digits[1] == 'X'))) ? 16 : 10;
+            arg->i = strtol(token, &end, base);
+        }
+        break;
+    case 'f':
+        // 実数
+        arg->f = strtof(token, &end);
+        break;
+    case 'e':
+        // 列挙 列挙名表から一致する名前を探す
+        if (enumNames == NULL) {
+            return RESULT_ERR_PARAM;
+        }
+        for (int index = 0; enumNames[index] != NULL; index++) {
+            if (strcmp(token, enumNames[index]) == 0) {
+                arg->e = index;
+                return RESULT_SUCCESS;
+            }
+        }
+        return RESULT_ERR_ARG_TYPE;
+    case 's':
+        // 文字列
+        arg->s = token;
+        return RESULT_SUCCESS;
+    default:
+        // 引数仕様不正
+        return RESULT_ERR_PARAM;
+    }
+
+    if ((end == token) || (*end != '\0')) {
+        // 数値として解釈できない
+        return RESULT_ERR_ARG_TYPE;
+    }
+
+    return RESULT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * @file       CommandDispatcher.h
+ * @brief      コマンドディスパッチャ ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    コマンド名と処理関数の対応表（コンパイル時に整列を検査）によるコマンド振り分けのクラス定義
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 コマンド受信ポート番号を処理関数に渡す
+ * @date       2026/10/16 v1.02 整数引数を 10進数（0x で16進数）で解析し、先頭の 0 で8進数としない
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _COMMAND_DISPATCHER_H_
+#define _COMMAND_DISPATCHER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMMAND_ARG_MAX                     4           // コマンド引数最大数
+
+class CommandDispatcher
+{
+public:
+
+    enum RESULT {                           // コマンド振り分け結果
+        RESULT_SUCCESS = 0,                 // 正常終了
+        RESULT_NO_COMMAND,                  // コマンドなし（空行）
+        RESULT_ERR_UNKNOWN_CMD,             // 認識できないコマンド
+        RESULT_ERR_ARGS,                    // 引数の数が不正
+        RESULT_ERR_ARG_TYPE,                // 引数の型が不正
+        RESULT_ERR_PARAM,                   // パラメータエラー
+        RESULT_NUM                          // コマンド振り分け結果数
+    };
+
+    union CommandArg {                      // コマンド引数値
+        long                i;              // 整数（引数仕様 'i'、10進数・0x で16進数）
+        float               f;              // 実数（引数仕様 'f'）
+        int                 e;              // 列挙値（引数仕様 'e'、列挙名表のインデックス）
+        const char          *s;             // 文字列（引数仕様 's'、行末までの残り文字列）
+    };
+
+    struct CommandArgs {                    // コマンド引数
+        int                 count;          // 指定された引数の数
+        uint8_t             port;           // コマンド受信ポート番号
+        CommandArg          arg[COMMAND_ARG_MAX];   // 引数値
+    };
+
+    typedef void (*CommandHandler)(const CommandArgs &args);
+
+    struct CommandDef {                     // コマンド定義
+        const char          *name;          // コマンド名
+        CommandHandler      handler;        // コマンド処理関数
+        const char          *argSpec;       // 引数仕様 'i'=整数 'f'=実数 'e'=列挙 's'=残り文字列（大文字は省略可能）
+        const char * const  *enumNames;     // 列挙名表（NULL終端、'e' 引数用）
+    };
+
+    // コマンド定義表の整列検査（static_assert で使用する）
+    template <size_t N>
+    static constexpr bool IsSorted(const CommandDef (&table)[N], size_t index = 1)
+    {
+        return (index >= N) ? true : (nameLess(table[index - 1].name, table[index].name) && IsSorted(table, index + 1));
+    }
+
+    // コンストラクタ（コマンド定義表はコマンド名の昇順に並べること）
+    template <size_t N>
+    CommandDispatcher(const CommandDef (&table)[N]) : _table(table), _num(N) {}
+
+    // コマンド検索
+    const CommandDef *Find(const char *name) const;
+    // コマンド振り分け（line は引数の区切りに書き換えられる、port はコマンド受信ポート番号）
+    RESULT Dispatch(char *line, uint8_t port = 0) const;
+
+private:
+    const CommandDef        *_table;        // コマンド定義表へのポインタ
+    size_t                  _num;           // コマンド定義数
+
+    // コマンド名比較（strcmp と同じ順序）
+    static constexpr bool nameLess(const char *a, const char *b)
+    {
+        return (*a != *b) ? ((unsigned char)*a < (unsigned char)*b) : ((*a != '\0') && nameLess(a + 1, b + 1));
+    }
+    // 引数１個の解析
+    static RESULT parseArg(char spec, const char *token, const char * const *enumNames, CommandArg *arg);
+};
+#endif /* _COMMAND_DISPATCHER_H_ */
@@ -0,0 +1,32 @@
+/******************************************************************************
+ * @file       Crc16.h
+ * @brief      CRC-16 計算 ヘッダファイル
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    CRC-16/CCITT-FALSE（多項式 0x1021、初期値 0xFFFF、反転なし）のテーブル参照計算
+ * @date       2026/10/16 v1.00 新規作成
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#ifndef _CRC16_H_
+#define _CRC16_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC16_INIT          0xFFFF      // CRC-16 初期値
+#define CRC16_RESIDUE       0x0000      // データ＋CRC（ビッグエンディアン）を通して計算したときの剰余
+
+extern const uint16_t   Crc16Table[256];
+
+// CRC-16 １バイト更新
+static inline uint16_t Crc16Update(uint16_t crc, uint8_t data)
+{
+    return (uint16_t)((crc << 8) ^ Crc16Table[(uint8_t)(crc >> 8) ^ data]);
+}
+
+// CRC-16 計算
+uint16_t Crc16Calc(const uint8_t *data, size_t length, uint16_t crc = CRC16_INIT);
+
+#endif /* _CRC16_H_ */
@@ -2,6 +2,7 @@
 #include "M5StickC.h"
 #include "M5Timer.h"
 #include "SerialReceive.h"
+#include "CommandDispatcher.h"
 
 // タイマー
 M5Timer     timer;                      // M5Timer オブジェクト生成
@@ -14,8 +15,13 @@ uint32_t    run_time = 0;               // 起動後の経過時間(秒)
 bool        cmd_recv_enable = false;    // コマンド受信許可フラグ
 
 // シリアル受信
-SerialReceive   serialReceiver(SerialReceive::LOG_INFO);        // シリアル受信クラスインスタンス生成
-char            seralReceiveBuff[SERIAL_RECEIVE_BUFF_SIZE];     // シリアル受信バッファ
+#define     SERIAL_RECV_LINE_MAX    127         // シリアル受信 最大メッセージ長[byte]
+#define     SERIAL_RECV_QUEUE_NUM   4           // シリアル受信 メッセージキュー数
+#define     SERIAL_RECV_RAM_MAX     1280        // シリアル受信 バッファ・キュー領域の上限[byte]
+typedef SerialReceive<SERIAL_RECV_LINE_MAX, SERIAL_RECV_QUEUE_NUM> SatSerialReceive;
+static_assert(SatSerialReceive::StorageSize() <= SERIAL_RECV_RAM_MAX, "SerialReceive storage exceeds SERIAL_RECV_RAM_MAX");
+SatSerialReceive    serialReceiver(SerialReceiveBase::LOG_INFO);    // シリアル受信クラスインスタンス生成
+char                seralReceiveBuff[SatSerialReceive::SLOT_SIZE];  // シリアル受信バッファ
 
 // 1秒周期タイマ割り込みハンドラ関数
 void timer_func_1sec(void)
@@ -25,6 +31,62 @@ void timer_func_1sec(void)
     timer_1sec_flag = true;             // 1秒タイマーフラグセット
 }
 
+// "rxstat"コマンド処理
+void cmd_rxstat(const CommandDispatcher::CommandArgs &args)
+{
+    serialReceiver.DispRecvStats();
+}
+
+// "taskstat"コマンド処理
+void cmd_taskstat(const CommandDispatcher::CommandArgs &args)
+{
+    TaskPeriod::Stats   stats;              // 周期実行統計情報
+
+    serialReceiver.GetPeriodStats(&stats);
+    TaskPeriod::DispStats(&Serial, "rx", stats);
+}
+
+// "start"コマンド処理
+void cmd_start(const CommandDispatcher::CommandArgs &args)
+{
+    Serial.printf("*** start ***\n");
+}
+
+// "stop"コマンド処理
+void cmd_stop(const CommandDispatcher::CommandArgs &args)
+{
+    Serial.printf("*** stop ***\n");
+}
+
+// コマンド定義表（コマンド名の昇順に並べること）
+constexpr CommandDispatcher::CommandDef cmd_table[] = {
+    //  コマンド名  処理関数        引数仕様    列挙名表
+    {   "rxstat",   cmd_rxstat,     "",         NULL    },
+    {   "start",    cmd_start,      "",         NULL    },
+    {   "stop",     cmd_stop,       "",         NULL    },
+    {   "taskstat", cmd_taskstat,   "",         NULL    },
+};
+static_assert(CommandDispatcher::IsSorted(cmd_table), "cmd_table must be sorted by command name");
+CommandDispatcher   cmdDispatcher(cmd_table);   // コマンドディスパッチャ
+
+// コマンド実行（Dispatch は引数の区切りを書き換えるため写しを解析し、エラー表示には元のコマンド行を使う）
+void execCommand(const char *line)
+{
+    char    command[SatSerialReceive::SLOT_SIZE];   // 解析用のコマンド行の写し
+
+    strncpy(command, line, sizeof (command) - 1);
+    command[sizeof (command) - 1] = '\0';
+    CommandDispatcher::RESULT   result = cmdDispatcher.Dispatch(command);
+    if (result == CommandDispatcher::RESULT_ERR_UNKNOWN_CMD) {
+        // 認識できないコマンド
+        Serial.printf("Invalid command : \"%s\"\n", line);
+    }
+    else if ((result == CommandDispatcher::RESULT_ERR_ARGS) || (result == CommandDispatcher::RESULT_ERR_ARG_TYPE)) {
+        // 引数が不正
+        Serial.printf("Invalid argument : \"%s\"\n", line);
+    }
+}
+
 void setup()
 {
     // M5 スタート
@@ -49,6 +111,8 @@ void loop()
                 // コマンド受信許可タイマー時間に達した
                 // シリアル受信初期化
                 serialReceiver.Init(false);
+                // 受信メッセージ通知先をこのタスク（loop）に設定
+                serialReceiver.SetNotifyTask(xTaskGetCurrentTaskHandle());
                 // シリアル受信開始
                 serialReceiver.Start();
                 // コマンド受信許可フラグセット
@@ -57,25 +121,14 @@ void loop()
         }
     }
 
-    if (cmd_recv_enable == true) {
-        // コマンド受信許可
-        // シリアル受信メッセージチェック
-        SerialReceive::RESULT   serialRecvResult = serialReceiver.GetReceiveData(seralReceiveBuff);
-        if (serialRecvResult == serialReceiver.RESULT_SUCCESS) {
+    if ((cmd_recv_enable == true) && (ulTaskNotifyTake(pdTRUE, 0) > 0)) {
+        // コマンド受信許可 かつ 受信メッセージ通知あり
+        // シリアル受信メッセージを待ちなしですべて取り出す
+        while (serialReceiver.TryGetReceiveData(seralReceiveBuff) == serialReceiver.RESULT_SUCCESS) {
             // 受信メッセージ取得成功
             //Serial.printf("Received : %s\n", seralReceiveBuff);
-            if (strcmp(seralReceiveBuff, "start") == 0) {
-                // "start"コマンド
-                Serial.printf("*** start ***\n");
-            }
-            else if (strcmp(seralReceiveBuff, "stop") == 0) {
-                // "stop"コマンド
-                Serial.printf("*** stop ***\n");
-            }
-            else {
-                // 認識できないコマンド
-                Serial.printf("Invalid command : \"%s\"\n", seralReceiveBuff);
-            }
+            // コマンド実行
+            execCommand(seralReceiveBuff);
         }
     }
 
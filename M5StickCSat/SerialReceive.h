@@ -4,12 +4,21 @@
 #include <functional>
 #include <M5StickC.h>
 #include "task.h"
+#include "CobsFrame.h"
 
-#define SERIAL_RECEIVE_BUFF_SIZE            128         // シリアル受信バッファサイズ
+#define SERIAL_RECEIVE_BUFF_SIZE            128         // シリアル受信バッファサイズ（既定値、最大メッセージ長＋終端）
+#define SERIAL_RECEIVE_QUEUE_NUM            4           // シリアル受信メッセージキュー数（既定値）
+#define SERIAL_RECEIVE_WAIT_DEFAULT         10          // シリアル受信データ取得 既定待ち時間[ms]
+#define SERIAL_RECEIVE_WAIT_FOREVER         0xFFFFFFFF  // シリアル受信データ取得 無期限待ち
+#define SERIAL_RECEIVE_HIST_NUM             20          // キュー滞留時間分布の区間数（区間k : 2^k〜2^(k+1)-1[us]）
+#define SERIAL_RECEIVE_FLOW_HIGH_DEFAULT    3           // フロー制御 送信停止要求キュー使用数（既定値）
+#define SERIAL_RECEIVE_FLOW_LOW_DEFAULT     1           // フロー制御 送信再開要求キュー使用数（既定値）
+#define SERIAL_RECEIVE_PORT_MAX             4           // SerialReceiveMux 受信ポート最大数
 
 typedef std::function<void(int)> SerialReceiveCallback;
 
-class SerialReceive : public Task
+// シリアル受信 共通部（バッファ・キューの領域は派生クラス SerialReceive<MaxLine, Depth> が持つ）
+class SerialReceiveBase : public Task
 {
 public:
 
@@ -44,10 +53,64 @@ public:
         EVENT_RECV_COMP,                    // シリアル受信受信完了
         EVENT_END,                          // シリアル受信終了
         EVENT_QUEUE_FULL,                   // シリアル受信メッセージキューフル
+        EVENT_FRAME_ERROR,                  // シリアル受信フレームエラー（CRC・形式・長さ）
         EVENT_TEST,                         // シリアル受信テストイベント
         EVENT_NUM                           // シリアル受信イベント数
     };
 
+    enum MSG_TYPE {                         // 受信メッセージ種別
+        MSG_TYPE_TEXT = 0,                  // テキスト（CR/LF 終端の ASCII 行）
+        MSG_TYPE_FRAME,                     // バイナリフレーム（0x00 区切り COBS＋CRC-16、CRC 検査済）
+        MSG_TYPE_NUM                        // 受信メッセージ種別数
+    };
+
+    enum RECV_MODE {                        // シリアル受信モード
+        RECV_MODE_POLLING = 0,              // ポーリング（タスク駆動周期毎に受信チェック）
+        RECV_MODE_EVENT,                    // イベント駆動（UART受信通知で起床）
+        RECV_MODE_NUM                       // シリアル受信モード数
+    };
+
+    enum FLOW_CONTROL {                     // フロー制御方式
+        FLOW_CONTROL_NONE = 0,              // フロー制御なし（キューフル時は受信メッセージを破棄）
+        FLOW_CONTROL_XONXOFF,               // ソフトウェアフロー制御（XOFF 送信で停止要求、XON 送信で再開要求）
+        FLOW_CONTROL_RTS,                   // ハードウェアフロー制御（RTS 端子 HIGH で停止要求、LOW で再開要求）
+        FLOW_CONTROL_NUM                    // フロー制御方式数
+    };
+
+    struct RecvStats {                      // シリアル受信統計情報
+        RECV_MODE   mode;                   // シリアル受信モード
+        uint32_t    wakeups;                // タスク起床回数（累計）
+        uint32_t    wakeupsPerSec;          // タスク起床回数[回/s]（直近1秒間）
+        uint32_t    latencyCount;           // 受信→キュー送信遅延 計測数（先頭バイトの受信からキュー送信まで）
+        uint32_t    latencyAvg;             // 受信→キュー送信遅延 平均[us]（ポーリングは到着時刻が分からないため最大１周期分大きい上限値）
+        uint32_t    latencyMax;             // 受信→キュー送信遅延 最大[us]
+        uint32_t    framesOk;               // フレーム受信数（CRC正常）
+        uint32_t    frameCrcErrors;         // フレームCRCエラー数
+        uint32_t    frameFormatErrors;      // フレーム形式・長さエラー数
+        uint32_t    bytesReceived;          // 受信バイト数
+        uint32_t    linesPosted;            // テキスト行キュー送信数
+        uint32_t    linesTruncated;         // 最大サイズで分割したテキスト行数
+        uint32_t    emptyLines;             // 空行数（CR/LF の連続、キューに送信しない）
+        uint32_t    queueFullDrops;         // キューフルによる破棄数
+        uint32_t    queueHighWater;         // キュー最大使用数
+        uint32_t    queueDepth;             // キュー段数
+        uint32_t    residenceHist[SERIAL_RECEIVE_HIST_NUM];     // キュー滞留時間分布（log2 区間）
+        uint8_t     port;                   // 受信ポート番号
+        FLOW_CONTROL flowControl;           // フロー制御方式
+        bool        flowPaused;             // 送信停止要求中
+        uint32_t    flowPauses;             // 送信停止要求回数
+        uint32_t    flowStalls;             // キューフルによる受信処理保留回数
+    };
+
+    struct RecvMsg {                        // 受信メッセージ（スロット参照）
+        char        *data;                  // 受信メッセージへのポインタ（'\0'終端）
+        uint16_t    length;                 // 受信メッセージ長（フレームはCRCを除くペイロード長）
+        uint8_t     slot;                   // 受信メッセージスロット番号
+        uint8_t     type;                   // 受信メッセージ種別（MSG_TYPE）
+        uint8_t     port;                   // 受信ポート番号（SetPort で指定）
+        uint32_t    time;                   // 受信時刻[us]（micros()、先頭バイトを読み出した起床の受信通知時刻）
+    };
+
     enum LOG_LEVEL {                        // ログ出力レベル
         LOG_DISABLED = 0,                   // ログ出力レベル 出力なし
         LOG_ERROR,                          // ログ出力レベル エラー以下
@@ -57,41 +120,210 @@ public:
         LOG_NUM                             // ログ出力レベル数
     };
 
-    // コンストラクタ
-    SerialReceive(LOG_LEVEL logLevel = LOG_WARNING);
     // デストラクタ
-    ~SerialReceive();
+    ~SerialReceiveBase();
 
     // [DEBUG] プロパティ表示
     void DispProperties();
     // シリアル受信初期化
-    RESULT Init(bool echoback = false, SerialReceiveCallback callback = 0);
+    RESULT Init(bool echoback = false, SerialReceiveCallback callback = 0, RECV_MODE mode = RECV_MODE_EVENT);
     // シリアル受信開始
     RESULT Start();
-    // シリアル受信データ取得
-    RESULT GetReceiveData(char *data);
+    // シリアル受信データ取得（待ち時間[ms]指定）
+    RESULT GetReceiveData(char *data, uint32_t timeout = SERIAL_RECEIVE_WAIT_DEFAULT);
+    // シリアル受信データ取得（待ちなし）
+    RESULT TryGetReceiveData(char *data);
+    // 受信メッセージ取得（スロット参照、使用後はReleaseMsgで解放する、待ち時間[ms]指定）
+    RESULT ReceiveMsg(RecvMsg *msg, uint32_t timeout = SERIAL_RECEIVE_WAIT_DEFAULT);
+    // 受信メッセージ取得（スロット参照、待ちなし）
+    RESULT TryReceiveMsg(RecvMsg *msg);
+    // 受信メッセージ解放
+    RESULT ReleaseMsg(RecvMsg *msg);
     // シリアル受信状態取得
     STATUS GetStatus();
     // シリアル受信最大サイズ取得
     int GetRecvMaxSize();
+    // シリアル受信統計情報取得
+    RESULT GetRecvStats(RecvStats *stats);
+    // シリアル受信統計情報表示
+    void DispRecvStats();
+    // 周期実行統計情報取得（ポーリングの受信タスクの駆動周期・実測周波数・周期超過・周期ジッタ分布。イベント駆動では周期 0）
+    void GetPeriodStats(TaskPeriod::Stats *stats) const { getPeriodStats(stats); }
+    // 受信通知先タスク登録（NULLで登録解除）
+    RESULT SetNotifyTask(TaskHandle_t task);
+    // 受信ポート設定（既定は Serial、ポート番号0、Start・SerialReceiveMux::Start 前に呼ぶこと）
+    RESULT SetPort(HardwareSerial *port, uint8_t portId);
+    // 受信ポート設定（HardwareSerial 以外の Stream、UART受信通知がないためポーリングで受信する）
+    RESULT SetPort(Stream *port, uint8_t portId);
+    // 受信ポート番号取得
+    uint8_t GetPortId();
+    // フロー制御設定（キュー使用数が highWater 以上で停止要求、lowWater 以下で再開要求、Start 前に呼ぶこと）
+    RESULT SetFlowControl(FLOW_CONTROL flow, int highWater = SERIAL_RECEIVE_FLOW_HIGH_DEFAULT,
+                          int lowWater = SERIAL_RECEIVE_FLOW_LOW_DEFAULT, int rtsPin = -1);
+
+protected:
+    struct RecvQueueItem {                      // 受信メッセージキュー要素
+        uint8_t                 slot;           // 受信メッセージスロット番号
+        uint8_t                 type;           // 受信メッセージ種別
+        uint16_t                length;         // 受信メッセージ長
+        uint32_t                time;           // 受信時刻[us]（先頭バイト）
+        uint32_t                queued;         // キュー送信時刻[us]
+    };
+
+    friend class SerialReceiveMux;
+
+    // コンストラクタ（派生クラスから呼ぶ）
+    SerialReceiveBase(LOG_LEVEL logLevel);
+    // 受信バッファ・キュー領域設定（派生クラスのコンストラクタから呼ぶ）
+    void attachStorage(char *slots, uint16_t slotSize, uint8_t depth, uint8_t *restBuff,
+                       uint8_t *queueStorage, StaticQueue_t *queueStatic, uint8_t *freeStorage, StaticQueue_t *freeStatic);
 
 private:
+
     bool                        init;           // 初期化済フラグ
     bool                        _echoback;      // エコーバック
+    RECV_MODE                   _mode;          // シリアル受信モード
     int                         _task_period;   // タスク駆動周期[ms]
     SerialReceiveCallback       _callback;      // コールバック関数へのポインタ
-    char                        *recvBuff;      // シリアル受信バッファへのポインタ
+    Stream                      *_port;         // 受信ポート
+    HardwareSerial              *_hwPort;       // 受信ポート（HardwareSerial の場合、UART受信通知に使用）
+    uint8_t                     _portId;        // 受信ポート番号
+    char                        *slotBuff;      // 受信メッセージスロットメモリへのポインタ
+    uint16_t                    _slotSize;      // 受信メッセージスロットサイズ（最大メッセージ長＋終端）
+    uint8_t                     _depth;         // 受信メッセージキュー数
+    uint8_t                     _slotNum;       // 受信メッセージスロット数
+    uint8_t                     *_restBuff;     // 未処理データ退避バッファへのポインタ（フレーム開始後・キュー送信保留中）
+    int                         restBytes;      // 退避中の未処理バイト数（キュー送信保留で処理を中断したデータ）
+    bool                        msgPending;     // 受信メッセージのキュー送信保留中（フロー制御ありのキューフル）
+    uint8_t                     pendingType;    // キュー送信保留中の受信メッセージ種別
+    char                        *recvBuff;      // シリアル受信バッファ（受信中スロット）へのポインタ
+    uint8_t                     recvSlot;       // 受信中メッセージスロット番号
     QueueHandle_t               queRecvMsg;     // 受信メッセージキューハンドル
+    QueueHandle_t               queFreeSlot;    // 空き受信メッセージスロットキューハンドル
     int                         recvBytes;      // 受信メッセージバイト数
     bool                        running;        // タスク駆動中
     STATUS                      status;         // シリアル受信状態
     LOG_LEVEL                   _logLevel;      // ログ出力レベル
+    TaskHandle_t                taskHandle;     // シリアル受信タスクハンドル（受信通知先）
+    TaskHandle_t                notifyTask;     // 受信メッセージ通知先タスクハンドル
+    volatile uint32_t           rxEventTime;    // UART受信通知時刻[us]
+    uint32_t                    rxStartTime;    // 受信中メッセージ先頭バイト受信時刻[us]（先頭バイトを読み出した起床の受信通知時刻）
+    uint32_t                    wakeups;        // タスク起床回数（累計）
+    uint32_t                    wakeupsPerSec;  // タスク起床回数[回/s]（直近1秒間）
+    uint32_t                    rateWakeups;    // 起床回数計測開始時のタスク起床回数
+    uint32_t                    rateStartTime;  // 起床回数計測開始時刻[us]
+    uint32_t                    latencyCount;   // 受信→キュー送信遅延 計測数
+    uint32_t                    latencySum;     // 受信→キュー送信遅延 積算[us]
+    uint32_t                    latencyMax;     // 受信→キュー送信遅延 最大[us]
+    CobsFrameParser             frameParser;    // COBSフレーム解析
+    bool                        frameMode;      // フレーム受信中
+    uint32_t                    framesOk;       // フレーム受信数（CRC正常）
+    uint32_t                    frameCrcErrors; // フレームCRCエラー数
+    uint32_t                    frameFormatErrors;  // フレーム形式・長さエラー数
+    uint32_t                    bytesReceived;  // 受信バイト数
+    uint32_t                    linesPosted;    // テキスト行キュー送信数
+    uint32_t                    linesTruncated; // 最大サイズで分割したテキスト行数
+    uint32_t                    emptyLines;     // 空行数
+    uint32_t                    queueFullDrops; // キューフルによる破棄数
+    uint32_t                    queueHighWater; // キュー最大使用数
+    uint32_t                    residenceHist[SERIAL_RECEIVE_HIST_NUM];     // キュー滞留時間分布
+    FLOW_CONTROL                _flow;          // フロー制御方式
+    int                         _flowHigh;      // 送信停止要求キュー使用数
+    int                         _flowLow;       // 送信再開要求キュー使用数
+    int                         _rtsPin;        // RTS 端子番号
+    volatile bool               flowPaused;     // 送信停止要求中
+    uint32_t                    flowPauses;     // 送信停止要求回数
+    uint32_t                    flowStalls;     // キューフルによる受信処理保留回数
 
     // シリアル受信タスク関数
     void run(void *data);
+    // 受信開始処理（受信タスク起動時に呼ぶ、task は UART受信通知先）
+    void beginReceive(TaskHandle_t task);
+    // 受信タスク起床回数計測
+    void countWakeup();
+    // UART受信通知ハンドラ
+    void onReceiveEvent();
     // ログ出力
     void logOutput(LOG_LEVEL logLevel, char *logMsg);
-    // 受信メッセージキュー送信
-    void postRecvMsgQueue();
+    // 受信済データ一括処理（キュー送信保留中は保留分を再送信し、送信できなければ受信データを読み出さない）
+    void recvAvailable();
+    // キュー送信保留の再開（保留中の受信メッセージ・退避データを処理し、保留が解けたら true）
+    bool resumePending();
+    // 退避データ処理（キュー送信保留になったら残りを退避したまま中断する）
+    void recvRest();
+    // 受信１バイト処理（キュー送信保留でバイトを処理できなかったら false）
+    bool recvByte(uint8_t data);
+    // テキスト行終了処理（空行は送信しない）
+    void endTextLine();
+    // 受信テキスト一括処理（受信用スロットに読み出したバイト列）
+    void recvText(int count);
+    // 受信メッセージキュー送信（フロー制御ありのキューフル時は待たずに保留して false）
+    bool postRecvMsgQueue(MSG_TYPE type = MSG_TYPE_TEXT);
+    // フロー制御更新（キュー使用数により停止／再開を要求する）
+    void updateFlowControl();
+    // 送信停止／再開要求
+    void setFlowPaused(bool paused);
+};
+
+// シリアル受信（MaxLine : 最大メッセージ長[byte]、Depth : 受信メッセージキュー数）
+// 受信メッセージスロット・キュー領域をインスタンス内に静的に確保する
+template <size_t MaxLine = SERIAL_RECEIVE_BUFF_SIZE - 1, size_t Depth = SERIAL_RECEIVE_QUEUE_NUM>
+class SerialReceive : public SerialReceiveBase
+{
+public:
+    static_assert(MaxLine >= 1, "SerialReceive MaxLine must be at least 1");
+    static_assert(MaxLine < 0xFFFF, "SerialReceive MaxLine must fit in 16 bits");
+    static_assert(Depth >= 1, "SerialReceive Depth must be at least 1");
+    static_assert(Depth + 2 <= 0xFF, "SerialReceive Depth must leave room for 8-bit slot numbers");
+
+    static constexpr size_t SLOT_SIZE = MaxLine + 1;    // 受信メッセージスロットサイズ（'\0'終端を含む）
+    static constexpr size_t SLOT_NUM = Depth + 2;       // 受信メッセージスロット数（キュー数＋受信中＋取得中）
+
+    // バッファ・キュー領域のバイト数（コンパイル時に確定、static_assert で RAM 予算を検査できる）
+    static constexpr size_t StorageSize()
+    {
+        return (SLOT_SIZE * SLOT_NUM) + MaxLine + (Depth * sizeof (RecvQueueItem)) + SLOT_NUM + (2 * sizeof (StaticQueue_t));
+    }
+
+    // コンストラクタ
+    SerialReceive(LOG_LEVEL logLevel = LOG_WARNING) : SerialReceiveBase(logLevel)
+    {
+        attachStorage(slotStorage, SLOT_SIZE, Depth, restStorage, queueStorage, &queueStatic, freeStorage, &freeStatic);
+    }
+
+private:
+    char                        slotStorage[SLOT_SIZE * SLOT_NUM];      // 受信メッセージスロット領域
+    uint8_t                     restStorage[MaxLine];                   // フレーム開始後の未処理データ退避領域
+    uint8_t                     queueStorage[Depth * sizeof (RecvQueueItem)];   // 受信メッセージキュー領域
+    uint8_t                     freeStorage[SLOT_NUM];                  // 空き受信メッセージスロットキュー領域
+    StaticQueue_t               queueStatic;                            // 受信メッセージキュー管理領域
+    StaticQueue_t               freeStatic;                             // 空き受信メッセージスロットキュー管理領域
+};
+
+// シリアル受信マルチプレクサ（複数の受信ポートを１つのタスクで受信する）
+// 各ポートの受信処理・キューは SerialReceive<MaxLine, Depth> が持ち、ポート側のタスクは起動しない
+class SerialReceiveMux : public Task
+{
+public:
+    // コンストラクタ
+    SerialReceiveMux(SerialReceiveBase::LOG_LEVEL logLevel = SerialReceiveBase::LOG_WARNING);
+
+    // 受信ポート追加（Init 済の SerialReceive を登録する、Start 前に呼ぶこと）
+    SerialReceiveBase::RESULT AddPort(SerialReceiveBase *receiver);
+    // 受信開始
+    SerialReceiveBase::RESULT Start();
+    // 受信ポート数取得
+    int GetPortCount();
+    // 周期実行統計情報取得（ポーリングのポートがある場合の受信タスクの駆動周期・実測周波数・周期超過・周期ジッタ分布）
+    void GetPeriodStats(TaskPeriod::Stats *stats) const { getPeriodStats(stats); }
+
+private:
+    SerialReceiveBase           *_ports[SERIAL_RECEIVE_PORT_MAX];   // 受信ポート
+    int                         _portNum;       // 受信ポート数
+    bool                        running;        // タスク駆動中
+    SerialReceiveBase::LOG_LEVEL    _logLevel;  // ログ出力レベル
+
+    // 受信タスク関数
+    void run(void *data);
 };
 #endif /* _SERIAL_RECEIVE_H_ */
@@ -56,6 +56,21 @@ void Task::delay(int ms)
 	::vTaskDelay(ms/portTICK_PERIOD_MS);
 }
 
+void Task::startPeriod(uint32_t ms)
+{
+	m_period.Start(ms);
+}
+
+uint32_t Task::delayPeriod()
+{
+	return m_period.Wait();
+}
+
+void Task::getPeriodStats(TaskPeriod::Stats *stats) const
+{
+	m_period.GetStats(stats);
+}
+
 void Task::setTaskSize( uint16_t size )
 {
 	m_tasksize = size;
@@ -4,6 +4,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <string>
+#include "TaskPeriod.h"
 
 class Task
 {
@@ -14,6 +15,10 @@ public:
 	void stop();
 
 	void delay(int ms);
+	// 固定位相の周期実行（タスク関数から呼ぶ。delay と異なり処理時間で周期が伸びない）
+	void startPeriod(uint32_t ms);
+	uint32_t delayPeriod();
+	void getPeriodStats(TaskPeriod::Stats *stats) const;
 
 	virtual void run(void* data) = 0;
 
@@ -30,6 +35,7 @@ private:
 	uint16_t 	m_tasksize;
 	uint8_t		m_priority;
 	BaseType_t	m_coreid;
+	TaskPeriod	m_period;
 	/* data */
 };
 
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * @file       TaskPeriod.cpp
+ * @brief      タスク周期実行
+ * @version    1.00
+ * @author     SONODA Takehiko (OzoraKobo)
+ * @details    vTaskDelayUntil による固定位相の周期実行と、周期超過・周期ジッタ・実測周波数の計測
+ *             周期ジッタは tick 単位の起床予定時刻の間隔（周期 × 進んだ周期数）と、micros() で計った実際の起床間隔との差の絶対値
+ *             （Start の直後の起床は tick の途中からの間隔となるため、周期ジッタに含めない）
+ * @date       2026/10/16 v1.00 新規作成
+ * @date       2026/10/16 v1.01 処理がちょうど次の起床予定時刻に終わった場合を周期超過としない
+ * @par
+ * @copyright  Copyright ©︎ 2021 SONODA Takehiko All rights reserved.
+ ******************************************************************************/
+
+#include <string.h>
+#include "TaskPeriod.h"
+
+// コンストラクタ
+TaskPeriod::TaskPeriod()
+{
+    _period = 0;                            // 周期[ms]
+    _periodTicks = 1;                       // 周期[tick]
+    _lastWake = 0;                          // 前回の起床予定時刻[tick]
+    _lastWakeTime = 0;                      // 前回の起床時刻[us]
+    _rateStartTime = 0;                     // 実測周波数の計測開始時刻[us]
+    ClearStats();
+}
+
+// 周期実行開始
+void TaskPeriod::Start(uint32_t periodMs)
+{
+    SetPeriod(periodMs);
+    ClearStats();
+    // 現在時刻を起床予定時刻の起点とする
+    _lastWake = xTaskGetTickCount();
+    _lastWakeTime = micros();
+    _rateStartTime = _lastWakeTime;
+}
+
+// 周期変更
+void TaskPeriod::SetPeriod(uint32_t periodMs)
+{
+    _period = periodMs;
+    _periodTicks = pdMS_TO_TICKS(periodMs);
+    if (_periodTicks == 0) {
+        // tick より短い周期は 1tick とする
+        _periodTicks = 1;
+    }
+    _stats.period = periodMs;               // 周期[ms]
+}
+
+// 周期待ち
+uint32_t TaskPeriod::Wait()
+{
+    uint32_t    periods = 1;                // 前回の起床予定時刻から進んだ周期数
+
+    TickType_t elapsed = xTaskGetTickCount() - _lastWake;
+    if (elapsed > _periodTicks) {
+        // 周期超過 次の起床予定時刻を過ぎているので、過ぎた起床予定時刻を飛ばして位相を保つ
+        // （ちょうど起床予定時刻の tick は過ぎていない。vTaskDelayUntil は待たずに戻り、その起床予定時刻の起床となる）
+        uint32_t missed = (elapsed - 1) / _periodTicks;
+        _lastWake += missed * _periodTicks;
+        periods += missed;
+        _stats.overruns++;
+        _stats.skipped += missed;
+    }
+    // 前回の起床予定時刻から周期後まで待つ（_lastWake は次の起床予定時刻に更新される）
+    vTaskDelayUntil(&_lastWake, _periodTicks);
+    measure(periods);
+
+    return periods;
+}
+
+// 統計情報取得
+void TaskPeriod::GetStats(TaskPeriod::Stats *stats) const
+{
+    *stats = _stats;
+}
+
+// 統計情報クリア
+void TaskPeriod::ClearStats()
+{
+    memset(&_stats, 0, sizeof (_stats));
+    _stats.period = _period;                // 周期[ms]
+    _jitterSum = 0;                         // 周期ジッタ 合計[us]
+    _rateCycles = 0;                        // 実測周波数の計測開始時の起床回数
+}
+
+// 統計情報表示
+void TaskPeriod::DispStats(Print *out, const char *name, const TaskPeriod::Stats &stats)
+{
+    out->printf("TASKSTAT, task=%s, period=%ums, rate=%u.%03uHz, cycles=%u, overruns=%u, skipped=%u, jitter avg=%uus max=%uus\n",
+        name, stats.period, stats.rate / 1000, stats.rate % 1000, stats.cycles, stats.overruns, stats.skipped,
+        stats.jitterAvg, stats.jitterMax);
+    // 周期ジッタ分布（区間下限[us]:件数） 出力先が非同期送信でも行が分断されないよう１回で出力する
+    char    hist[32 + (TASK_PERIOD_HIST_NUM * 24)];     // TASKHIST 行
+    int     length = snprintf(hist, sizeof (hist), "TASKHIST, task=%s", name);
+    for (int i = 0; (i < TASK_PERIOD_HIST_NUM) && (length < (int)sizeof (hist)); i++) {
+        length += snprintf(hist + length, sizeof (hist) - length, ", %u:%u", (i == 0) ? 0 : (1U << i), stats.jitterHist[i]);
+    }
+    if (length < (int)sizeof (hist)) {
+        snprintf(hist + length, sizeof (hist) - length, "\n");
+    }
+    out->print(hist);
+}
+
+// 起床毎の計測
+void TaskPeriod::measure(uint32_t periods)
+{
+    uint32_t now = micros();
+
+    if (_stats.cycles > 0) {
+        // 周期ジッタを log2 区間で集計する
+        uint32_t actual = now - _lastWakeTime;
+        uint32_t expected = periods * _periodTicks * portTICK_PERIOD_MS * 1000;
+        uint32_t jitter = (actual > expected) ? (actual - expected) : (expected - actual);
+        int bin = (jitter == 0) ? 0 : (31 - __builtin_clz(jitter));
+        _stats.jitterHist[(bin < TASK_PERIOD_HIST_NUM) ? bin : (TASK_PERIOD_HIST_NUM - 1)]++;
+        _jitterSum += jitter;
+        _stats.jitterAvg = (uint32_t)(_jitterSum / _stats.cycles);
+        if (jitter > _stats.jitterMax) {
+            _stats.jitterMax = jitter;
+        }
+    }
+    _lastWakeTime = now;
+    _stats.cycles++;
+
+    uint32_t elapsed = now - _rateStartTime;
+    if (elapsed >= TASK_PERIOD_RATE_WINDOW) {
+        // 実測周波数計測周期経過
+        _stats.rate = (uint32_t)((uint64_t)(_stats.cycles - _rateCycles) * 1000000000ULL / elapsed);
+        _rateCycles = _stats.cycles;
+        _rateStartTime = now;
+    }
+}